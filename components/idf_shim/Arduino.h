@@ -0,0 +1,145 @@
+// *****************************************************************************
+// Arduino core stand-in for the ESP-IDF build of the firmware
+// (env:esp32doit-devkit-v1-idf, WATCH_IDF): the Arduino calls of main.cpp and
+// of the display code, straight on the IDF drivers (gpio, esp_timer, ADC,
+// console UART), with no Arduino core initialization before setup().
+// Only what the firmware uses: pins, time, Serial, String, ESP, the supply ADC.
+// The display layer (GxEPD2_BW, GxEPD2_EPD, Adafruit GFX, the fonts) on top of
+// this core and SPI.h is components/watch_display.
+// Same values and behavior as the Arduino ESP32 core 2.0 where it matters to
+// the timings: micros() is esp_timer, delay() is a FreeRTOS delay.
+// *****************************************************************************
+
+#ifndef IDF_SHIM_ARDUINO_H
+#define IDF_SHIM_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+
+#include "esp_attr.h"
+#include "esp_timer.h"
+#include "esp32/clk.h"
+#include "esp32/rom/ets_sys.h"
+#include "driver/gpio.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "WString.h"
+
+#define HIGH 1
+#define LOW 0
+// Pin modes, as the Arduino ESP32 core (OUTPUT can be read back)
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define PULLUP 0x04
+#define INPUT_PULLUP 0x05
+
+// ESP32 VSPI defaults, as on the watch
+#define SS 5
+#define SCK 18
+#define MISO 19
+#define MOSI 23
+
+#define PROGMEM
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+
+// Sketch entry points, called by app_main()
+void setup();
+void loop();
+
+inline uint32_t micros()
+{
+  return (uint32_t)esp_timer_get_time();
+}
+
+inline uint32_t millis()
+{
+  return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+inline void delay(uint32_t ms)
+{
+  vTaskDelay(ms / portTICK_PERIOD_MS);
+}
+
+inline void delayMicroseconds(uint32_t us)
+{
+  ets_delay_us(us);
+}
+
+inline void yield()
+{
+  vPortYield();
+}
+
+/// @brief Pin direction and pull up; the output level set before stays (digitalWrite() then pinMode())
+/// @param pin
+/// @param mode INPUT, OUTPUT or INPUT_PULLUP
+inline void pinMode(uint8_t pin, uint8_t mode)
+{
+  gpio_config_t config = {};
+  config.pin_bit_mask = 1ULL << pin;
+  config.mode = (mode & OUTPUT) == OUTPUT ? GPIO_MODE_INPUT_OUTPUT : GPIO_MODE_INPUT;
+  config.pull_up_en = (mode & PULLUP) ? GPIO_PULLUP_ENABLE : GPIO_PULLUP_DISABLE;
+  config.pull_down_en = GPIO_PULLDOWN_DISABLE;
+  config.intr_type = GPIO_INTR_DISABLE;
+  gpio_config(&config);
+}
+
+inline void digitalWrite(uint8_t pin, uint8_t level)
+{
+  gpio_set_level((gpio_num_t)pin, level ? 1 : 0);
+}
+
+inline int digitalRead(uint8_t pin)
+{
+  return gpio_get_level((gpio_num_t)pin) ? HIGH : LOW;
+}
+
+/// @brief ADC1 pin in millivolts, calibrated, 11 dB attenuation and 12 bits as the Arduino core default
+/// @param pin ADC1 pin (GPIO32 to GPIO39), 0 for other pins
+uint32_t analogReadMilliVolts(uint8_t pin);
+
+/// @brief Serial stand-in, prints to the console UART set up by the IDF startup (CONFIG_ESP_CONSOLE_UART_BAUDRATE)
+class IdfSerial
+{
+public:
+  void begin(uint32_t) {}
+  void print(const char *text) { fputs(text, stdout); }
+  void print(const String &text) { print(text.c_str()); }
+  void println(const char *text = "") { puts(text); }
+  void println(const String &text) { println(text.c_str()); }
+  void println(int value) { printf("%d\n", value); }
+  int printf(const char *format, ...)
+  {
+    va_list args;
+    va_start(args, format);
+    int n = vprintf(format, args);
+    va_end(args);
+    return n;
+  }
+};
+
+extern IdfSerial Serial;
+
+/// @brief ESP stand-in, the counters the firmware reads
+class IdfEsp
+{
+public:
+  uint32_t getCycleCount()
+  {
+    uint32_t cycles;
+    asm volatile("rsr %0, ccount" : "=a"(cycles));
+    return cycles;
+  }
+  uint32_t getCpuFreqMHz() { return esp_clk_cpu_freq() / 1000000; }
+};
+
+extern IdfEsp ESP;
+
+#endif
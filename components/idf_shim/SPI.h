@@ -0,0 +1,59 @@
+// *****************************************************************************
+// Arduino SPI library stand-in for the ESP-IDF build (see Arduino.h): the
+// VSPI bus (SPI3_HOST), set up by the IDF spi_master driver (bus, device,
+// clock and mode, acquired for the whole Arduino transaction), the bytes sent
+// through its registers like the Arduino core does; the panel's chip select
+// stays a GPIO driven by GxEPD2. No DMA, so writeBytes() can send straight
+// from flash (as the Arduino core, the CPU fills the data buffer).
+// *****************************************************************************
+
+#ifndef IDF_SHIM_SPI_H
+#define IDF_SHIM_SPI_H
+
+#include "Arduino.h"
+#include "driver/spi_master.h"
+
+#define LSBFIRST 0
+#define MSBFIRST 1
+#define SPI_MODE0 0
+#define SPI_MODE1 1
+#define SPI_MODE2 2
+#define SPI_MODE3 3
+
+class SPISettings
+{
+public:
+  SPISettings() : clock(1000000), bitOrder(MSBFIRST), dataMode(SPI_MODE0) {}
+  SPISettings(uint32_t clockHz, uint8_t order, uint8_t mode) : clock(clockHz), bitOrder(order), dataMode(mode) {}
+  uint32_t clock;
+  uint8_t bitOrder;
+  uint8_t dataMode;
+};
+
+class SPIClass
+{
+public:
+  SPIClass() : _busReady(false), _device(NULL), _clock(0), _dataMode(0), _bitOrder(MSBFIRST) {}
+  /// @brief Bus on the VSPI pins (SCK, MISO, MOSI), again after end()
+  void begin();
+  /// @brief Bus released, its pins free for GPIO use (SSD1681 temperature read)
+  void end();
+  /// @brief Device for the settings (added again when they change), bus acquired until endTransaction(), data phase set
+  void beginTransaction(SPISettings settings);
+  void endTransaction();
+  /// @brief One byte out and in, through the registers (no driver transaction)
+  uint8_t transfer(uint8_t value);
+  /// @brief Bytes in 64 byte register transfers, nothing received
+  void writeBytes(const uint8_t *data, uint32_t size);
+
+private:
+  bool _busReady;
+  spi_device_handle_t _device;
+  uint32_t _clock;
+  uint8_t _dataMode;
+  uint8_t _bitOrder;
+};
+
+extern SPIClass SPI;
+
+#endif
@@ -0,0 +1,121 @@
+// *****************************************************************************
+// Arduino String stand-in for the ESP-IDF build (see Arduino.h): the
+// constructors, concatenation and substring() the firmware's Serial messages
+// use, with the Arduino formatting (numbers in a base, floats with 2 decimals).
+// *****************************************************************************
+
+#ifndef IDF_SHIM_WSTRING_H
+#define IDF_SHIM_WSTRING_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+
+class String
+{
+public:
+  String(const char *text = "") : _text(text ? text : "") {}
+  explicit String(char c) : _text(1, c) {}
+  explicit String(unsigned char value, unsigned char base = 10) : _text(_format(value, false, base)) {}
+  explicit String(int value, unsigned char base = 10) : _text(_format(_magnitude(value, base), value < 0 && base == 10, base)) {}
+  explicit String(unsigned int value, unsigned char base = 10) : _text(_format(value, false, base)) {}
+  explicit String(long value, unsigned char base = 10) : _text(_format(_magnitude(value, base), value < 0 && base == 10, base)) {}
+  explicit String(unsigned long value, unsigned char base = 10) : _text(_format(value, false, base)) {}
+  explicit String(long long value, unsigned char base = 10) : _text(_format(_magnitude(value, base), value < 0 && base == 10, base)) {}
+  explicit String(unsigned long long value, unsigned char base = 10) : _text(_format(value, false, base)) {}
+  explicit String(float value, unsigned int decimals = 2) : _text(_format(value, decimals)) {}
+  explicit String(double value, unsigned int decimals = 2) : _text(_format(value, decimals)) {}
+
+  const char *c_str() const { return _text.c_str(); }
+  unsigned int length() const { return _text.size(); }
+
+  /// @brief Characters from..to-1, swapped if to < from, clipped to the length (as Arduino)
+  String substring(unsigned int from, unsigned int to) const
+  {
+    if (from > to)
+    {
+      unsigned int t = from;
+      from = to;
+      to = t;
+    }
+    if (from >= _text.size())
+      return String();
+    String result;
+    result._text = _text.substr(from, to - from);
+    return result;
+  }
+  String substring(unsigned int from) const { return substring(from, _text.size()); }
+
+  String &operator+=(const String &text)
+  {
+    _text += text._text;
+    return *this;
+  }
+  String &operator+=(const char *text)
+  {
+    if (text)
+      _text += text;
+    return *this;
+  }
+  bool operator==(const String &text) const { return _text == text._text; }
+  bool operator==(const char *text) const { return text && _text == text; }
+  bool operator!=(const String &text) const { return !(*this == text); }
+
+private:
+  std::string _text;
+
+  /// @brief Magnitude of a signed value in base 10, two's complement bits in other bases (as Arduino)
+  template <typename T>
+  static unsigned long long _magnitude(T value, unsigned char base)
+  {
+    if (base != 10)
+      return (unsigned long long)value & (~0ULL >> (64 - 8 * sizeof(T)));
+    return value < 0 ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+  }
+  static std::string _format(unsigned long long value, bool negative, unsigned char base)
+  {
+    if (base < 2 || base > 36)
+      base = 10;
+    char digits[66];
+    char *p = digits + sizeof(digits);
+    *--p = 0;
+    do
+    {
+      uint8_t digit = value % base;
+      *--p = digit < 10 ? '0' + digit : 'a' + digit - 10;
+      value /= base;
+    } while (value);
+    if (negative)
+      *--p = '-';
+    return p;
+  }
+  static std::string _format(double value, unsigned int decimals)
+  {
+    char text[48];
+    snprintf(text, sizeof(text), "%.*f", (int)decimals, value);
+    return text;
+  }
+};
+
+inline String operator+(const String &lhs, const String &rhs)
+{
+  String result(lhs);
+  result += rhs;
+  return result;
+}
+
+inline String operator+(const String &lhs, const char *rhs)
+{
+  String result(lhs);
+  result += rhs;
+  return result;
+}
+
+inline String operator+(const char *lhs, const String &rhs)
+{
+  String result(lhs);
+  result += rhs;
+  return result;
+}
+
+#endif
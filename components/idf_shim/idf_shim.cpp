@@ -0,0 +1,150 @@
+// *****************************************************************************
+// Arduino core stand-in for the ESP-IDF build (see Arduino.h): the Serial,
+// ESP and SPI objects, SPI bus, supply ADC and the entry point. app_main()
+// calls setup() right away: no initArduino(), no loop task, nothing between
+// the IDF startup and setup() but the static constructors (BOOT lines,
+// boot_profile.h).
+// *****************************************************************************
+
+#include "Arduino.h"
+#include "SPI.h"
+#include "driver/adc.h"
+#include "esp_adc_cal.h"
+#include "soc/spi_struct.h"
+
+IdfSerial Serial;
+IdfEsp ESP;
+SPIClass SPI;
+
+void SPIClass::begin()
+{
+  if (_busReady)
+    return;
+  spi_bus_config_t bus = {};
+  bus.mosi_io_num = MOSI;
+  bus.miso_io_num = MISO;
+  bus.sclk_io_num = SCK;
+  bus.quadwp_io_num = -1;
+  bus.quadhd_io_num = -1;
+  bus.max_transfer_sz = SOC_SPI_MAXIMUM_BUFFER_SIZE;
+  _busReady = spi_bus_initialize(SPI3_HOST, &bus, SPI_DMA_DISABLED) == ESP_OK;
+}
+
+void SPIClass::end()
+{
+  if (_device)
+    spi_bus_remove_device(_device);
+  _device = NULL;
+  if (_busReady)
+    spi_bus_free(SPI3_HOST);
+  _busReady = false;
+}
+
+void SPIClass::beginTransaction(SPISettings settings)
+{
+  begin();
+  if (!_device || settings.clock != _clock || settings.dataMode != _dataMode || settings.bitOrder != _bitOrder)
+  {
+    if (_device)
+      spi_bus_remove_device(_device);
+    _device = NULL;
+    spi_device_interface_config_t config = {};
+    config.mode = settings.dataMode;
+    config.clock_speed_hz = settings.clock;
+    config.spics_io_num = -1; // GxEPD2 drives CS
+    config.queue_size = 1;
+    config.flags = settings.bitOrder == LSBFIRST ? (SPI_DEVICE_TXBIT_LSBFIRST | SPI_DEVICE_RXBIT_LSBFIRST) : 0;
+    if (spi_bus_add_device(SPI3_HOST, &config, &_device) != ESP_OK)
+      _device = NULL;
+    _clock = settings.clock;
+    _dataMode = settings.dataMode;
+    _bitOrder = settings.bitOrder;
+  }
+  if (!_device)
+    return;
+  // Acquiring the bus sets the device up (clock, mode, bit order); the transfers below then go straight through
+  // the registers of SPI3_HOST, as the Arduino core does: full duplex data phase, no command, address or dummy
+  spi_device_acquire_bus(_device, portMAX_DELAY);
+  SPI3.user.usr_command = 0;
+  SPI3.user.usr_addr = 0;
+  SPI3.user.usr_dummy = 0;
+  SPI3.user.usr_mosi = 1;
+  SPI3.user.usr_miso = 1;
+  SPI3.user.usr_mosi_highpart = 0;
+  SPI3.user.usr_miso_highpart = 0;
+  SPI3.user.doutdin = 1;
+}
+
+void SPIClass::endTransaction()
+{
+  if (_device)
+    spi_device_release_bus(_device);
+}
+
+// As spiTransferByteNL() of the Arduino core: 8 clocks and a register poll, no driver transaction setup per byte
+uint8_t SPIClass::transfer(uint8_t value)
+{
+  if (!_device)
+    return 0;
+  SPI3.mosi_dlen.usr_mosi_dbitlen = 7;
+  SPI3.miso_dlen.usr_miso_dbitlen = 7;
+  SPI3.data_buf[0] = value;
+  SPI3.cmd.usr = 1;
+  while (SPI3.cmd.usr)
+    ;
+  return SPI3.data_buf[0] & 0xFF;
+}
+
+// As spiWriteNL() of the Arduino core: the 64 byte data buffer filled by the CPU, then sent in one go
+void SPIClass::writeBytes(const uint8_t *data, uint32_t size)
+{
+  if (!_device)
+    return;
+  uint32_t words[16];
+  while (size)
+  {
+    uint32_t bytes = size < sizeof(words) ? size : sizeof(words);
+    memcpy(words, data, bytes); // any alignment, RAM or flash
+    SPI3.mosi_dlen.usr_mosi_dbitlen = bytes * 8 - 1;
+    SPI3.miso_dlen.usr_miso_dbitlen = 0;
+    for (uint32_t i = 0; i < (bytes + 3) / 4; ++i)
+      SPI3.data_buf[i] = words[i];
+    SPI3.cmd.usr = 1;
+    while (SPI3.cmd.usr)
+      ;
+    data += bytes;
+    size -= bytes;
+  }
+}
+
+uint32_t analogReadMilliVolts(uint8_t pin)
+{
+  static esp_adc_cal_characteristics_t characteristics;
+  static bool characterized = false;
+  for (int channel = 0; channel < ADC1_CHANNEL_MAX; ++channel)
+  {
+    gpio_num_t gpio;
+    if (adc1_pad_get_io_num((adc1_channel_t)channel, &gpio) != ESP_OK || gpio != pin)
+      continue;
+    if (!characterized)
+    {
+      adc1_config_width(ADC_WIDTH_BIT_12);
+      esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_DB_11, ADC_WIDTH_BIT_12, 1100, &characteristics);
+      characterized = true;
+    }
+    adc1_config_channel_atten((adc1_channel_t)channel, ADC_ATTEN_DB_11);
+    return esp_adc_cal_raw_to_voltage(adc1_get_raw((adc1_channel_t)channel), &characteristics);
+  }
+  return 0;
+}
+
+extern "C" void app_main()
+{
+  setup();
+  for (;;)
+  {
+    // Not reached by the watch (setup() ends in deep sleep); the delay lets the idle task run
+    loop();
+    vTaskDelay(1);
+  }
+}
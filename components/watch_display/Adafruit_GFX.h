@@ -0,0 +1,278 @@
+// *****************************************************************************
+// Display layer of the ESP-IDF build (env:esp32doit-devkit-v1-idf) and of the
+// host tools: Adafruit GFX's Adafruit_GFX and GFXcanvas1, the parts the watch
+// draws with (rotation, rectangles, custom font text and text bounds), with the
+// same pixel placement as the library (version 1.11), so the frames are those
+// of the Arduino build. gfxfont.h and the fonts come from the library itself
+// (CMakeLists.txt, tools/README); its classes need the Arduino core.
+// *****************************************************************************
+
+#ifndef WATCH_DISPLAY_ADAFRUIT_GFX_H
+#define WATCH_DISPLAY_ADAFRUIT_GFX_H
+
+#include <Arduino.h>
+#include <gfxfont.h>
+
+class Adafruit_GFX
+{
+public:
+  Adafruit_GFX(int16_t w, int16_t h)
+      : WIDTH(w), HEIGHT(h), _width(w), _height(h), cursor_x(0), cursor_y(0), textcolor(0xFFFF), textbgcolor(0xFFFF),
+        textsize_x(1), textsize_y(1), rotation(0), wrap(true), gfxFont(NULL)
+  {
+  }
+  virtual ~Adafruit_GFX() {}
+  virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+
+  void setRotation(uint8_t r)
+  {
+    rotation = r & 3;
+    _width = (rotation & 1) ? HEIGHT : WIDTH;
+    _height = (rotation & 1) ? WIDTH : HEIGHT;
+  }
+  uint8_t getRotation() const
+  {
+    return rotation;
+  }
+  int16_t width() const
+  {
+    return _width;
+  }
+  int16_t height() const
+  {
+    return _height;
+  }
+
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+  {
+    for (int16_t i = 0; i < w; ++i)
+      drawPixel(x + i, y, color);
+  }
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+  {
+    for (int16_t i = 0; i < h; ++i)
+      drawPixel(x, y + i, color);
+  }
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+  {
+    for (int16_t i = x; i < x + w; ++i)
+      drawFastVLine(i, y, h, color);
+  }
+  virtual void fillScreen(uint16_t color)
+  {
+    fillRect(0, 0, _width, _height, color);
+  }
+  void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+  {
+    drawFastHLine(x, y, w, color);
+    drawFastHLine(x, y + h - 1, w, color);
+    drawFastVLine(x, y, h, color);
+    drawFastVLine(x + w - 1, y, h, color);
+  }
+
+  void setFont(const GFXfont *f)
+  {
+    gfxFont = (GFXfont *)f;
+  }
+  void setCursor(int16_t x, int16_t y)
+  {
+    cursor_x = x;
+    cursor_y = y;
+  }
+  void setTextColor(uint16_t c)
+  {
+    textcolor = textbgcolor = c;
+  }
+  void setTextWrap(bool w)
+  {
+    wrap = w;
+  }
+  int16_t getCursorX() const
+  {
+    return cursor_x;
+  }
+
+  /// @brief Custom font glyph at the cursor (baseline), transparent background
+  void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color)
+  {
+    c -= (uint8_t)pgm_read_byte(&gfxFont->first);
+    const GFXglyph *glyph = &gfxFont->glyph[c];
+    const uint8_t *bitmap = gfxFont->bitmap;
+    uint16_t bo = glyph->bitmapOffset;
+    uint8_t w = glyph->width, h = glyph->height;
+    int8_t xo = glyph->xOffset, yo = glyph->yOffset;
+    uint8_t bits = 0, bit = 0;
+    for (uint8_t yy = 0; yy < h; yy++)
+    {
+      for (uint8_t xx = 0; xx < w; xx++)
+      {
+        if (!(bit++ & 7))
+          bits = pgm_read_byte(&bitmap[bo++]);
+        if (bits & 0x80)
+          drawPixel(x + xo + xx, y + yo + yy, color);
+        bits <<= 1;
+      }
+    }
+  }
+  size_t write(uint8_t c)
+  {
+    if (!gfxFont)
+      return 1; // only custom fonts here
+    if (c == '\n')
+    {
+      cursor_x = 0;
+      cursor_y += (int16_t)textsize_y * gfxFont->yAdvance;
+    }
+    else if (c != '\r')
+    {
+      uint8_t first = gfxFont->first;
+      if ((c >= first) && (c <= gfxFont->last))
+      {
+        const GFXglyph *glyph = &gfxFont->glyph[c - first];
+        uint8_t w = glyph->width, h = glyph->height;
+        if ((w > 0) && (h > 0))
+        {
+          int16_t xo = glyph->xOffset;
+          if (wrap && ((cursor_x + textsize_x * (xo + w)) > _width))
+          {
+            cursor_x = 0;
+            cursor_y += (int16_t)textsize_y * gfxFont->yAdvance;
+          }
+          drawChar(cursor_x, cursor_y, c, textcolor);
+        }
+        cursor_x += glyph->xAdvance * (int16_t)textsize_x;
+      }
+    }
+    return 1;
+  }
+  size_t print(const char *text)
+  {
+    size_t n = 0;
+    while (*text)
+      n += write((uint8_t)*text++);
+    return n;
+  }
+
+  void getTextBounds(const char *str, int16_t x, int16_t y, int16_t *x1, int16_t *y1, uint16_t *w, uint16_t *h)
+  {
+    uint8_t c;
+    int16_t minx = 0x7FFF, miny = 0x7FFF, maxx = -1, maxy = -1;
+    *x1 = x;
+    *y1 = y;
+    *w = *h = 0;
+    while ((c = *str++))
+      charBounds(c, &x, &y, &minx, &miny, &maxx, &maxy);
+    if (maxx >= minx)
+    {
+      *x1 = minx;
+      *w = maxx - minx + 1;
+    }
+    if (maxy >= miny)
+    {
+      *y1 = miny;
+      *h = maxy - miny + 1;
+    }
+  }
+
+protected:
+  void charBounds(unsigned char c, int16_t *x, int16_t *y, int16_t *minx, int16_t *miny, int16_t *maxx, int16_t *maxy)
+  {
+    if (!gfxFont)
+      return;
+    if (c == '\n')
+    {
+      *x = 0;
+      *y += textsize_y * gfxFont->yAdvance;
+    }
+    else if (c != '\r')
+    {
+      uint8_t first = gfxFont->first, last = gfxFont->last;
+      if ((c >= first) && (c <= last))
+      {
+        const GFXglyph *glyph = &gfxFont->glyph[c - first];
+        uint8_t gw = glyph->width, gh = glyph->height, xa = glyph->xAdvance;
+        int8_t xo = glyph->xOffset, yo = glyph->yOffset;
+        if (wrap && ((*x + (((int16_t)xo + gw) * textsize_x)) > _width))
+        {
+          *x = 0;
+          *y += textsize_y * gfxFont->yAdvance;
+        }
+        int16_t tsx = textsize_x, tsy = textsize_y, x1 = *x + xo * tsx, y1 = *y + yo * tsy, x2 = x1 + gw * tsx - 1,
+                y2 = y1 + gh * tsy - 1;
+        if (x1 < *minx)
+          *minx = x1;
+        if (y1 < *miny)
+          *miny = y1;
+        if (x2 > *maxx)
+          *maxx = x2;
+        if (y2 > *maxy)
+          *maxy = y2;
+        *x += xa * tsx;
+      }
+    }
+  }
+
+  const int16_t WIDTH, HEIGHT;
+  int16_t _width, _height;
+  int16_t cursor_x, cursor_y;
+  uint16_t textcolor, textbgcolor;
+  uint8_t textsize_x, textsize_y;
+  uint8_t rotation;
+  bool wrap;
+  GFXfont *gfxFont;
+};
+
+/// @brief 1 bit canvas: MSB first rows of (WIDTH + 7) / 8 bytes, 1 = white (GxEPD2 and SSD1681 RAM layout)
+class GFXcanvas1 : public Adafruit_GFX
+{
+public:
+  GFXcanvas1(uint16_t w, uint16_t h) : Adafruit_GFX(w, h)
+  {
+    buffer = new uint8_t[((w + 7) / 8) * h]();
+  }
+  ~GFXcanvas1()
+  {
+    delete[] buffer;
+  }
+  void drawPixel(int16_t x, int16_t y, uint16_t color)
+  {
+    if ((x < 0) || (y < 0) || (x >= _width) || (y >= _height))
+      return;
+    int16_t t;
+    switch (rotation)
+    {
+    case 1:
+      t = x;
+      x = WIDTH - 1 - y;
+      y = t;
+      break;
+    case 2:
+      x = WIDTH - 1 - x;
+      y = HEIGHT - 1 - y;
+      break;
+    case 3:
+      t = x;
+      x = y;
+      y = HEIGHT - 1 - t;
+      break;
+    }
+    uint8_t *ptr = &buffer[(x / 8) + y * ((WIDTH + 7) / 8)];
+    if (color)
+      *ptr |= 0x80 >> (x & 7);
+    else
+      *ptr &= ~(0x80 >> (x & 7));
+  }
+  void fillScreen(uint16_t color)
+  {
+    memset(buffer, color ? 0xFF : 0x00, ((WIDTH + 7) / 8) * HEIGHT);
+  }
+  uint8_t *getBuffer() const
+  {
+    return buffer;
+  }
+
+private:
+  uint8_t *buffer;
+};
+
+#endif
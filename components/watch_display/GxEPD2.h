@@ -0,0 +1,23 @@
+// *****************************************************************************
+// Display layer of the ESP-IDF build and of the host tools: GxEPD2's
+// GxEPD2.h, colors and the panel enum, only the panel the watch uses.
+// *****************************************************************************
+
+#ifndef WATCH_DISPLAY_GxEPD2_H
+#define WATCH_DISPLAY_GxEPD2_H
+
+#include <Arduino.h>
+#include <SPI.h>
+
+#define GxEPD_BLACK 0x0000
+#define GxEPD_WHITE 0xFFFF
+
+namespace GxEPD2
+{
+  enum Panel
+  {
+    GDEH0154D67,
+  };
+}
+
+#endif
@@ -0,0 +1,174 @@
+// *****************************************************************************
+// Display layer of the ESP-IDF build and of the host tools: GxEPD2's
+// GxEPD2_BW display template (version 1.5.2) for a full frame buffer
+// (page_height = HEIGHT, one page, as GxEPD2_display_selection_new_style.h
+// selects on the ESP32): same rotation and partial window handling (windows
+// widened to whole bytes), same buffer layout and the same driver calls per
+// page (writeImage, refresh, writeImageAgain), so the host tools draw through
+// the watch's code paths.
+// *****************************************************************************
+
+#ifndef WATCH_DISPLAY_GxEPD2_BW_H
+#define WATCH_DISPLAY_GxEPD2_BW_H
+
+#include <Adafruit_GFX.h>
+
+#include "GxEPD2_EPD.h"
+
+template <typename GxEPD2_Type, const uint16_t page_height>
+class GxEPD2_BW : public Adafruit_GFX
+{
+public:
+  GxEPD2_Type epd2;
+  GxEPD2_BW(GxEPD2_Type epd2_instance) : Adafruit_GFX(GxEPD2_Type::WIDTH_VISIBLE, GxEPD2_Type::HEIGHT), epd2(epd2_instance)
+  {
+    static_assert(page_height == GxEPD2_Type::HEIGHT, "full frame buffer only");
+    _using_partial_mode = false;
+    _current_page = 0;
+    setFullWindow();
+  }
+  void drawPixel(int16_t x, int16_t y, uint16_t color)
+  {
+    if ((x < 0) || (x >= width()) || (y < 0) || (y >= height()))
+      return;
+    // check rotation, move pixel around if necessary
+    int16_t t;
+    switch (getRotation())
+    {
+    case 1:
+      t = x;
+      x = y;
+      y = t;
+      x = GxEPD2_Type::WIDTH - x - 1;
+      break;
+    case 2:
+      x = GxEPD2_Type::WIDTH - x - 1;
+      y = GxEPD2_Type::HEIGHT - y - 1;
+      break;
+    case 3:
+      t = x;
+      x = y;
+      y = t;
+      y = GxEPD2_Type::HEIGHT - y - 1;
+      break;
+    }
+    // transpose partial window to 0,0
+    x -= _pw_x;
+    y -= _pw_y;
+    // clip to (partial) window
+    if ((x < 0) || (x >= int16_t(_pw_w)) || (y < 0) || (y >= int16_t(_pw_h)))
+      return;
+    uint16_t i = x / 8 + y * (_pw_w / 8);
+    if (color)
+      _buffer[i] = (_buffer[i] | (1 << (7 - x % 8)));
+    else
+      _buffer[i] = (_buffer[i] & (0xFF ^ (1 << (7 - x % 8))));
+  }
+  void init(uint32_t serial_diag_bitrate, bool initial, uint16_t reset_duration = 10, bool pulldown_rst_mode = false)
+  {
+    epd2.init(serial_diag_bitrate, initial, reset_duration, pulldown_rst_mode);
+    _using_partial_mode = false;
+    _current_page = 0;
+    setFullWindow();
+  }
+  void fillScreen(uint16_t color)
+  {
+    uint8_t data = (color == GxEPD_BLACK) ? 0x00 : 0xFF;
+    for (uint16_t x = 0; x < sizeof(_buffer); x++)
+      _buffer[x] = data;
+  }
+  void setFullWindow()
+  {
+    _using_partial_mode = false;
+    _pw_x = 0;
+    _pw_y = 0;
+    _pw_w = GxEPD2_Type::WIDTH;
+    _pw_h = GxEPD2_Type::HEIGHT;
+  }
+  void setPartialWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+  {
+    if (!epd2.hasPartialUpdate)
+      return;
+    _pw_x = x < (uint16_t)width() ? x : width();
+    _pw_y = y < (uint16_t)height() ? y : height();
+    _pw_w = w < (uint16_t)(width() - _pw_x) ? w : width() - _pw_x;
+    _pw_h = h < (uint16_t)(height() - _pw_y) ? h : height() - _pw_y;
+    _rotate(_pw_x, _pw_y, _pw_w, _pw_h);
+    _using_partial_mode = true;
+    // make _pw_x, _pw_w multiple of 8
+    _pw_w += _pw_x % 8;
+    if (_pw_w % 8 > 0)
+      _pw_w += 8 - _pw_w % 8;
+    _pw_x -= _pw_x % 8;
+  }
+  void firstPage()
+  {
+    fillScreen(GxEPD_WHITE);
+    _current_page = 0;
+  }
+  bool nextPage()
+  {
+    if (_using_partial_mode)
+    {
+      epd2.writeImage(_buffer, _pw_x, _pw_y, _pw_w, _pw_h);
+      epd2.refresh(_pw_x, _pw_y, _pw_w, _pw_h);
+      if (epd2.hasFastPartialUpdate)
+        epd2.writeImageAgain(_buffer, _pw_x, _pw_y, _pw_w, _pw_h);
+    }
+    else
+    {
+      epd2.writeImageForFullRefresh(_buffer, 0, 0, GxEPD2_Type::WIDTH, GxEPD2_Type::HEIGHT);
+      epd2.refresh(false);
+      if (epd2.hasFastPartialUpdate)
+        epd2.writeImageAgain(_buffer, 0, 0, GxEPD2_Type::WIDTH, GxEPD2_Type::HEIGHT);
+    }
+    return false;
+  }
+  void hibernate()
+  {
+    epd2.hibernate();
+  }
+  /// @brief The frame buffer, native orientation, rows of WIDTH / 8 bytes (frame checks of the host tools)
+  const uint8_t *buffer() const
+  {
+    return _buffer;
+  }
+
+private:
+  void _rotate(uint16_t &x, uint16_t &y, uint16_t &w, uint16_t &h)
+  {
+    uint16_t t;
+    switch (getRotation())
+    {
+    case 1:
+      t = x;
+      x = y;
+      y = t;
+      t = w;
+      w = h;
+      h = t;
+      x = GxEPD2_Type::WIDTH - x - w;
+      break;
+    case 2:
+      x = GxEPD2_Type::WIDTH - x - w;
+      y = GxEPD2_Type::HEIGHT - y - h;
+      break;
+    case 3:
+      t = x;
+      x = y;
+      y = t;
+      t = w;
+      w = h;
+      h = t;
+      y = GxEPD2_Type::HEIGHT - y - h;
+      break;
+    }
+  }
+
+  uint8_t _buffer[(GxEPD2_Type::WIDTH / 8) * page_height];
+  bool _using_partial_mode;
+  uint16_t _pw_x, _pw_y, _pw_w, _pw_h;
+  int16_t _current_page;
+};
+
+#endif
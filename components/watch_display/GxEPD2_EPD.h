@@ -0,0 +1,174 @@
+// *****************************************************************************
+// Display layer of the ESP-IDF build and of the host tools: GxEPD2's
+// GxEPD2_EPD base class (version 1.5.2), same protected primitives and
+// members, same reset, transfer and BUSY wait sequences, so
+// GxEPD2_154_D67_Watch sends the panel what it sends in the Arduino build.
+// Pins and SPI through the board's Arduino.h and SPI.h: components/idf_shim
+// on the ESP32, tools/host (virtual clock, SSD1681 emulator) on the PC.
+// *****************************************************************************
+
+#ifndef WATCH_DISPLAY_GxEPD2_EPD_H
+#define WATCH_DISPLAY_GxEPD2_EPD_H
+
+#include <Arduino.h>
+#include <SPI.h>
+
+#include "GxEPD2.h"
+
+class GxEPD2_EPD
+{
+public:
+  // attributes
+  const uint16_t WIDTH;
+  const uint16_t HEIGHT;
+  const GxEPD2::Panel panel;
+  const bool hasColor;
+  const bool hasPartialUpdate;
+  const bool hasFastPartialUpdate;
+  // constructor
+  GxEPD2_EPD(int16_t cs, int16_t dc, int16_t rst, int16_t busy, int16_t busy_level, uint32_t busy_timeout,
+             uint16_t w, uint16_t h, GxEPD2::Panel p, bool c, bool pu, bool fpu)
+      : WIDTH(w), HEIGHT(h), panel(p), hasColor(c), hasPartialUpdate(pu), hasFastPartialUpdate(fpu),
+        _cs(cs), _dc(dc), _rst(rst), _busy(busy), _busy_level(busy_level), _busy_timeout(busy_timeout), _diag_enabled(false),
+        _pulldown_rst_mode(false), _pSPIx(&SPI), _spi_settings(4000000, MSBFIRST, SPI_MODE0), _initial_write(true), _initial_refresh(true), _power_is_on(false),
+        _using_partial_mode(false), _hibernating(false), _init_display_done(false), _reset_duration(10),
+        _busy_callback(NULL), _busy_callback_parameter(NULL)
+  {
+  }
+  virtual ~GxEPD2_EPD() {}
+  virtual void init(uint32_t serial_diag_bitrate = 0)
+  {
+    init(serial_diag_bitrate, true, 10, false);
+  }
+  virtual void init(uint32_t serial_diag_bitrate, bool initial, uint16_t reset_duration = 10, bool pulldown_rst_mode = false)
+  {
+    _initial_write = initial;
+    _initial_refresh = initial;
+    _pulldown_rst_mode = pulldown_rst_mode;
+    _power_is_on = false;
+    _using_partial_mode = false;
+    _hibernating = false;
+    _init_display_done = false;
+    _reset_duration = reset_duration;
+    if (serial_diag_bitrate > 0)
+      _diag_enabled = true;
+    if (_cs >= 0)
+    {
+      digitalWrite(_cs, HIGH);
+      pinMode(_cs, OUTPUT);
+    }
+    if (_dc >= 0)
+    {
+      digitalWrite(_dc, HIGH);
+      pinMode(_dc, OUTPUT);
+    }
+    _reset();
+    if (_busy >= 0)
+      pinMode(_busy, INPUT);
+    _pSPIx->begin();
+  }
+  void setBusyCallback(void (*busyCallback)(const void *), const void *busy_callback_parameter = 0)
+  {
+    _busy_callback = busyCallback;
+    _busy_callback_parameter = busy_callback_parameter;
+  }
+
+protected:
+  void _reset()
+  {
+    if (_rst >= 0)
+    {
+      digitalWrite(_rst, HIGH);
+      pinMode(_rst, OUTPUT);
+      delay(10);
+      digitalWrite(_rst, LOW);
+      delay(_reset_duration);
+      digitalWrite(_rst, HIGH);
+      delay(_reset_duration > 10 ? _reset_duration : 10);
+      _hibernating = false;
+    }
+  }
+  void _waitWhileBusy(const char *comment = 0, uint16_t busy_time = 5000)
+  {
+    if (_busy < 0)
+    {
+      delay(busy_time);
+      return;
+    }
+    delay(1); // add some margin to become active
+    uint32_t start = micros();
+    while (1)
+    {
+      if (digitalRead(_busy) != _busy_level)
+        break;
+      if (_busy_callback)
+        _busy_callback(_busy_callback_parameter);
+      else
+        delay(1);
+      if (digitalRead(_busy) != _busy_level)
+        break;
+      if (micros() - start > _busy_timeout)
+      {
+        Serial.println("Busy Timeout!");
+        break;
+      }
+    }
+    if (comment && _diag_enabled)
+      Serial.printf("%s : %u\n", comment, micros() - start);
+  }
+  void _writeCommand(uint8_t c)
+  {
+    _pSPIx->beginTransaction(_spi_settings);
+    if (_dc >= 0)
+      digitalWrite(_dc, LOW);
+    if (_cs >= 0)
+      digitalWrite(_cs, LOW);
+    _pSPIx->transfer(c);
+    if (_cs >= 0)
+      digitalWrite(_cs, HIGH);
+    if (_dc >= 0)
+      digitalWrite(_dc, HIGH);
+    _pSPIx->endTransaction();
+  }
+  void _writeData(uint8_t d)
+  {
+    _pSPIx->beginTransaction(_spi_settings);
+    if (_cs >= 0)
+      digitalWrite(_cs, LOW);
+    _pSPIx->transfer(d);
+    if (_cs >= 0)
+      digitalWrite(_cs, HIGH);
+    _pSPIx->endTransaction();
+  }
+  void _startTransfer()
+  {
+    _pSPIx->beginTransaction(_spi_settings);
+    if (_cs >= 0)
+      digitalWrite(_cs, LOW);
+  }
+  void _transfer(uint8_t value)
+  {
+    _pSPIx->transfer(value);
+  }
+  void _endTransfer()
+  {
+    if (_cs >= 0)
+      digitalWrite(_cs, HIGH);
+    _pSPIx->endTransaction();
+  }
+
+protected:
+  int16_t _cs, _dc, _rst, _busy, _busy_level;
+  uint32_t _busy_timeout;
+  bool _diag_enabled, _pulldown_rst_mode;
+  SPIClass *_pSPIx;
+  SPISettings _spi_settings;
+  bool _initial_write, _initial_refresh;
+  bool _power_is_on, _using_partial_mode, _hibernating;
+  bool _init_display_done;
+  uint16_t _reset_duration;
+  void (*_busy_callback)(const void *);
+  const void *_busy_callback_parameter;
+};
+
+#endif
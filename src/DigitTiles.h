@@ -0,0 +1,45 @@
+// *****************************************************************************
+// Digit tiles of WatchSegment18pt7b, format rowrepeat, for DISPLAY_DIGIT_TILES (digit_tiles.h).
+// Generated by tools/digit_tiles.cpp, do not edit: 344 bytes of flash (318 of tiles, 26 of offsets).
+// Plain const data, in flash on the ESP32.
+// *****************************************************************************
+
+#ifndef DIGIT_TILES_DATA_H
+#define DIGIT_TILES_DATA_H
+
+#include "digit_tiles.h"
+
+const uint8_t digitTilesData[] = {
+    0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0x80, 0x00, 0x00, 0x00, 0x00, 0x7F, 0x81,
+    0x00, 0x1F, 0xFF, 0xFC, 0x7F, 0x89, 0x00, 0x00, 0x00, 0x00, 0x7F, 0x81,
+    0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0x80, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0x80,
+    0x00, 0x00, 0x00, 0x00, 0x7F, 0x81, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0x8E,
+    0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0x80, 0x00, 0x00, 0x03, 0xFF, 0xFF, 0x81,
+    0x00, 0x1F, 0xE3, 0xFC, 0x7F, 0x89, 0x00, 0xFF, 0xE0, 0x00, 0x7F, 0x81,
+    0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0x80, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0x80,
+    0x00, 0x00, 0x00, 0x00, 0x7F, 0x81, 0x00, 0x1F, 0xE3, 0xFC, 0x7F, 0x89,
+    0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0x83, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0x80,
+    0x00, 0x00, 0x00, 0x00, 0x7F, 0x81, 0x00, 0xFF, 0xE3, 0xFF, 0xFF, 0x89,
+    0x00, 0x00, 0x03, 0xFF, 0xFF, 0x81, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0x80,
+    0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0x80, 0x00, 0xFF, 0xE0, 0x00, 0x7F, 0x81,
+    0x00, 0x1F, 0xE3, 0xFC, 0x7F, 0x89, 0x00, 0x00, 0x03, 0xFF, 0xFF, 0x81,
+    0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0x80, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0x80,
+    0x00, 0xFF, 0xE0, 0x00, 0x7F, 0x81, 0x00, 0x1F, 0xE3, 0xFC, 0x7F, 0x89,
+    0x00, 0x00, 0x00, 0x00, 0x7F, 0x81, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0x80,
+    0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0x80, 0x00, 0x00, 0x00, 0x00, 0x7F, 0x81,
+    0x00, 0x1F, 0xFF, 0xFF, 0xFF, 0x89, 0x00, 0x00, 0x03, 0xFF, 0xFF, 0x81,
+    0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0x80, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0x80,
+    0x00, 0x00, 0x00, 0x00, 0x7F, 0x81, 0x00, 0x1F, 0xE3, 0xFC, 0x7F, 0x89,
+    0x00, 0x00, 0x00, 0x00, 0x7F, 0x81, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0x80,
+    0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0x80, 0x00, 0x00, 0x00, 0x00, 0x7F, 0x81,
+    0x00, 0x1F, 0xE3, 0xFC, 0x7F, 0x89, 0x00, 0x00, 0x03, 0xFF, 0xFF, 0x81,
+    0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0x80, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0x87,
+    0x00, 0xF8, 0xFF, 0x8F, 0xFF, 0x81, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0x87,
+    0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0x83, 0x00, 0xFF, 0xE3, 0xFF, 0xFF, 0x89,
+    0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0x83};
+
+const uint16_t digitTilesOffsets[] = {0, 30, 48, 78, 102, 132, 162, 192, 222, 252, 282, 300, 318};
+
+const DigitTileSet digitTiles = {DIGIT_TILE_ROW_REPEAT, 21, 25, -24, 2, -24, 101, 25, "0123456789:-", digitTilesOffsets, digitTilesData};
+
+#endif
@@ -0,0 +1,126 @@
+// *****************************************************************************
+// Native digit tiles of WatchSegment18pt7b for DISPLAY_DIGIT_TILES_NATIVE (digit_tiles.h):
+// rows of the hours and minutes RAM windows of the 200x200 layout, written to
+// the controller straight from flash.
+// Generated by tools/digit_tiles.cpp, do not edit: 1275 bytes.
+// *****************************************************************************
+
+#ifndef DIGIT_TILES_NATIVE_DATA_H
+#define DIGIT_TILES_NATIVE_DATA_H
+
+#include "digit_tiles.h"
+
+const uint8_t digitTilesNativeData[] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0x00,
+    0x00, 0x00, 0xFF, 0xFE, 0x00, 0x00, 0x00, 0xFF, 0xFE, 0x00, 0x00, 0x00,
+    0xFF, 0xFE, 0x3F, 0xFF, 0xF8, 0xFF, 0xFE, 0x3F, 0xFF, 0xF8, 0xFF, 0xFE,
+    0x3F, 0xFF, 0xF8, 0xFF, 0xFE, 0x3F, 0xFF, 0xF8, 0xFF, 0xFE, 0x3F, 0xFF,
+    0xF8, 0xFF, 0xFE, 0x3F, 0xFF, 0xF8, 0xFF, 0xFE, 0x3F, 0xFF, 0xF8, 0xFF,
+    0xFE, 0x3F, 0xFF, 0xF8, 0xFF, 0xFE, 0x3F, 0xFF, 0xF8, 0xFF, 0xFE, 0x3F,
+    0xFF, 0xF8, 0xFF, 0xFE, 0x3F, 0xFF, 0xF8, 0xFF, 0xFE, 0x00, 0x00, 0x00,
+    0xFF, 0xFE, 0x00, 0x00, 0x00, 0xFF, 0xFE, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0x00, 0x00, 0x00, 0xFF,
+    0xFE, 0x00, 0x00, 0x00, 0xFF, 0xFE, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0x00, 0x07, 0xFF, 0xFF, 0xFE, 0x00, 0x07,
+    0xFF, 0xFF, 0xFE, 0x00, 0x07, 0xFF, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF,
+    0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x3F,
+    0xC7, 0xF8, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8,
+    0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE,
+    0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x3F, 0xC7,
+    0xF8, 0xFF, 0xFF, 0xFF, 0xC0, 0x00, 0xFF, 0xFF, 0xFF, 0xC0, 0x00, 0xFF,
+    0xFF, 0xFF, 0xC0, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFE, 0x00, 0x00, 0x00, 0xFF, 0xFE, 0x00, 0x00, 0x00, 0xFF, 0xFE,
+    0x00, 0x00, 0x00, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x3F, 0xC7,
+    0xF8, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF,
+    0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x3F,
+    0xC7, 0xF8, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8,
+    0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0x00,
+    0x00, 0x00, 0xFF, 0xFE, 0x00, 0x00, 0x00, 0xFF, 0xFE, 0x00, 0x00, 0x00,
+    0xFF, 0xFF, 0xFF, 0xC7, 0xFF, 0xFF, 0xFF, 0xFF, 0xC7, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xC7, 0xFF, 0xFF, 0xFF, 0xFF, 0xC7, 0xFF, 0xFF, 0xFF, 0xFF, 0xC7,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xC7, 0xFF, 0xFF, 0xFF, 0xFF, 0xC7, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xC7, 0xFF, 0xFF, 0xFF, 0xFF, 0xC7, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xC7, 0xFF, 0xFF, 0xFF, 0xFF, 0xC7, 0xFF, 0xFF, 0xFE, 0x00, 0x07, 0xFF,
+    0xFF, 0xFE, 0x00, 0x07, 0xFF, 0xFF, 0xFE, 0x00, 0x07, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xC0, 0x00, 0xFF,
+    0xFF, 0xFF, 0xC0, 0x00, 0xFF, 0xFF, 0xFF, 0xC0, 0x00, 0xFF, 0xFE, 0x3F,
+    0xC7, 0xF8, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8,
+    0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE,
+    0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x3F, 0xC7,
+    0xF8, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF,
+    0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x00, 0x07, 0xFF, 0xFF, 0xFE, 0x00,
+    0x07, 0xFF, 0xFF, 0xFE, 0x00, 0x07, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xC0, 0x00, 0xFF, 0xFF, 0xFF, 0xC0,
+    0x00, 0xFF, 0xFF, 0xFF, 0xC0, 0x00, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF,
+    0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x3F,
+    0xC7, 0xF8, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8,
+    0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE,
+    0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x3F, 0xC7,
+    0xF8, 0xFF, 0xFE, 0x00, 0x00, 0x00, 0xFF, 0xFE, 0x00, 0x00, 0x00, 0xFF,
+    0xFE, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFE, 0x00, 0x00, 0x00, 0xFF, 0xFE, 0x00, 0x00, 0x00, 0xFF, 0xFE,
+    0x00, 0x00, 0x00, 0xFF, 0xFE, 0x3F, 0xFF, 0xFF, 0xFF, 0xFE, 0x3F, 0xFF,
+    0xFF, 0xFF, 0xFE, 0x3F, 0xFF, 0xFF, 0xFF, 0xFE, 0x3F, 0xFF, 0xFF, 0xFF,
+    0xFE, 0x3F, 0xFF, 0xFF, 0xFF, 0xFE, 0x3F, 0xFF, 0xFF, 0xFF, 0xFE, 0x3F,
+    0xFF, 0xFF, 0xFF, 0xFE, 0x3F, 0xFF, 0xFF, 0xFF, 0xFE, 0x3F, 0xFF, 0xFF,
+    0xFF, 0xFE, 0x3F, 0xFF, 0xFF, 0xFF, 0xFE, 0x3F, 0xFF, 0xFF, 0xFF, 0xFE,
+    0x00, 0x07, 0xFF, 0xFF, 0xFE, 0x00, 0x07, 0xFF, 0xFF, 0xFE, 0x00, 0x07,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0x00,
+    0x00, 0x00, 0xFF, 0xFE, 0x00, 0x00, 0x00, 0xFF, 0xFE, 0x00, 0x00, 0x00,
+    0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE,
+    0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x3F, 0xC7,
+    0xF8, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF,
+    0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x3F,
+    0xC7, 0xF8, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x00, 0x00, 0x00,
+    0xFF, 0xFE, 0x00, 0x00, 0x00, 0xFF, 0xFE, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0x00, 0x00, 0x00, 0xFF,
+    0xFE, 0x00, 0x00, 0x00, 0xFF, 0xFE, 0x00, 0x00, 0x00, 0xFF, 0xFE, 0x3F,
+    0xC7, 0xF8, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8,
+    0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE,
+    0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x3F, 0xC7,
+    0xF8, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x3F, 0xC7, 0xF8, 0xFF,
+    0xFE, 0x3F, 0xC7, 0xF8, 0xFF, 0xFE, 0x00, 0x07, 0xFF, 0xFF, 0xFE, 0x00,
+    0x07, 0xFF, 0xFF, 0xFE, 0x00, 0x07, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xF1, 0xFF, 0x1F, 0xFF, 0xFF, 0xF1, 0xFF, 0x1F,
+    0xFF, 0xFF, 0xF1, 0xFF, 0x1F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xC7, 0xFF, 0xFF, 0xFF, 0xFF, 0xC7,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xC7, 0xFF, 0xFF, 0xFF, 0xFF, 0xC7, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xC7, 0xFF, 0xFF, 0xFF, 0xFF, 0xC7, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xC7, 0xFF, 0xFF, 0xFF, 0xFF, 0xC7, 0xFF, 0xFF, 0xFF, 0xFF, 0xC7, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xC7, 0xFF, 0xFF, 0xFF, 0xFF, 0xC7, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+const uint8_t digitTilesNativeWhite[] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF};
+
+const DigitTileNative digitTilesNative = {47, 111, 80, 40, 21, 3, "0123456789:-", digitTilesNativeData, digitTilesNativeWhite};
+
+#endif
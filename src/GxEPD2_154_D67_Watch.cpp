@@ -0,0 +1,651 @@
+// *****************************************************************************
+// Watch specific driver for the GDEH0154D67 200x200 SSD1681 panel.
+// See GxEPD2_154_D67_Watch.h.
+// SSD1681 commands used here (datasheet names):
+// 0x01 driver output control, 0x03 gate voltage, 0x04 source voltage,
+// 0x10 deep sleep, 0x11 data entry mode, 0x12 software reset,
+// 0x18 temperature sensor, 0x1A/0x1B write/read temperature register, 0x20 master activation, 0x22 display update control 2,
+// 0x24 write RAM (new, black/white), 0x26 write RAM (old), 0x2C VCOM,
+// 0x32 write LUT, 0x3C border waveform, 0x3F end option,
+// 0x44/0x45 RAM x/y window, 0x4E/0x4F RAM x/y address counter
+// *****************************************************************************
+
+#include "GxEPD2_154_D67_Watch.h"
+#include "ssd1681_lut.h"
+
+// Display update control 2 (0x22) sequences
+#define SSD1681_UPDATE_POWER_ON 0xE0      // clock and analog on
+#define SSD1681_UPDATE_POWER_OFF 0x83     // analog and clock off
+#define SSD1681_UPDATE_FULL 0xF7          // load temperature and OTP LUT, display mode 1, then power off
+#define SSD1681_UPDATE_PARTIAL 0xFC       // load temperature and OTP LUT, display mode 2, stay powered
+#define SSD1681_UPDATE_PARTIAL_LUT 0xCC   // display mode 2 with the LUT in the registers, stay powered
+#define SSD1681_UPDATE_LOAD_TEMPERATURE 0x20 // bit of the sequences above that reads the temperature sensor
+
+GxEPD2_154_D67_Watch::GxEPD2_154_D67_Watch(int16_t cs, int16_t dc, int16_t rst, int16_t busy) : GxEPD2_EPD(cs, dc, rst, busy, HIGH, 10000000, WIDTH, HEIGHT, panel, hasColor, hasPartialUpdate, hasFastPartialUpdate),
+                                                                                                _partial_lut(NULL),
+                                                                                                _partial_lut_loaded(false),
+                                                                                                _use_temperature(false),
+                                                                                                _temperature(0),
+                                                                                                _last_update_micros(0),
+                                                                                                _single_ram_write(false),
+                                                                                                _old_ram_synced(false),
+                                                                                                _old_ram_written(false),
+                                                                                                _ram_bytes_written(0),
+                                                                                                _ram_write_micros(0),
+                                                                                                _warm_wake(false),
+                                                                                                _warm_config(false),
+                                                                                                _warm_failed(false),
+                                                                                                _init_display_micros(0),
+                                                                                                _trace(NULL)
+{
+}
+
+void GxEPD2_154_D67_Watch::init(uint32_t serial_diag_bitrate, bool initial, uint16_t reset_duration, bool pulldown_rst_mode)
+{
+  uint32_t start = micros();
+  _warm_config = false;
+  _warm_failed = false;
+
+  // Pin and SPI setup of GxEPD2_EPD::init() without its reset pulse: the reset is this driver's _reset(), so every
+  // bus and pin event of a wake goes through the primitives below (recorded with SPI_TRACE)
+  int16_t rst = _rst;
+  _rst = -1;
+  GxEPD2_EPD::init(serial_diag_bitrate, initial, reset_duration, pulldown_rst_mode);
+  _rst = rst;
+  if (!_warm_wake || initial || _rst < 0)
+  {
+    _reset();
+    _init_display_micros += micros() - start;
+    return;
+  }
+
+  digitalWrite(_rst, HIGH);
+  pinMode(_rst, OUTPUT);
+
+  // An idle controller isn't busy, and still holds the marker sleepWarm() left in the temperature register. Only a
+  // read of the marker proves the registers and the LUT survived: a reset controller reads 0x7FF, a bus that can't
+  // read back reads invalid, both take the reset path
+  bool expected = (digitalRead(_busy) != _busy_level);
+  if (expected)
+  {
+    _init_display_done = true;
+    expected = (readTemperature() == SSD1681_WARM_MARKER);
+  }
+  if (expected)
+  {
+    _init_display_done = true;
+    _warm_config = true;
+  }
+  else
+  {
+    // Unexpected state (reset or power loss while sleeping): back to the cold path
+    if (_diag_enabled)
+      Serial.println("GxEPD2_154_D67_Watch: warm wake failed, reset");
+    _init_display_done = false;
+    _partial_lut_loaded = false;
+    _old_ram_synced = false;
+    _warm_failed = true;
+    _reset();
+  }
+  _init_display_micros += micros() - start;
+}
+
+void GxEPD2_154_D67_Watch::selectWarmWake(bool warm, bool partialLutLoaded)
+{
+  _warm_wake = warm;
+  _partial_lut_loaded = warm && partialLutLoaded;
+}
+
+void GxEPD2_154_D67_Watch::sleepWarm()
+{
+  _writeCommand(0x1A);
+  _writeData(SSD1681_WARM_MARKER >> 4);
+  _writeData((SSD1681_WARM_MARKER & 0x0F) << 4);
+  _PowerOff();
+}
+
+void GxEPD2_154_D67_Watch::selectSingleRamWrite(bool enable)
+{
+  _single_ram_write = enable;
+}
+
+void GxEPD2_154_D67_Watch::setTemperature(uint16_t temperature)
+{
+  _use_temperature = true;
+  _temperature = temperature;
+}
+
+void GxEPD2_154_D67_Watch::useTemperatureSensor()
+{
+  _use_temperature = false;
+}
+
+uint16_t GxEPD2_154_D67_Watch::readTemperature()
+{
+  if (!_init_display_done || _hibernating)
+    return SSD1681_TEMPERATURE_INVALID;
+  _writeCommand(0x1B);
+
+  // The data line is bidirectional: release it and clock the two bytes in by hand
+  _pSPIx->end();
+  pinMode(MOSI, INPUT);
+  pinMode(SCK, OUTPUT);
+  digitalWrite(SCK, LOW);
+  digitalWrite(_dc, HIGH);
+  digitalWrite(_cs, LOW);
+  uint16_t value = 0;
+  for (uint8_t i = 0; i < 16; i++)
+  {
+    digitalWrite(SCK, HIGH);
+    value = (value << 1) | (digitalRead(MOSI) ? 1 : 0);
+    digitalWrite(SCK, LOW);
+  }
+  digitalWrite(_cs, HIGH);
+  _pSPIx->begin();
+#if SPI_TRACE
+  // the bytes read, as the data of 0x1B
+  if (_trace)
+  {
+    spi_trace_data(_trace, value >> 8);
+    spi_trace_data(_trace, value & 0xFF);
+  }
+#endif
+
+  // 12 bit value, left aligned; a floating or write only line reads all ones or all zeros
+  if (value == 0xFFFF || value == 0x0000)
+    return SSD1681_TEMPERATURE_INVALID;
+  return value >> 4;
+}
+
+void GxEPD2_154_D67_Watch::selectPartialWaveform(const uint8_t *lut)
+{
+  if (lut != _partial_lut)
+    _partial_lut_loaded = false;
+  _partial_lut = lut;
+}
+
+void GxEPD2_154_D67_Watch::clearScreen(uint8_t value)
+{
+  writeScreenBuffer(value);
+  refresh(true);
+  writeScreenBufferAgain(value);
+}
+
+void GxEPD2_154_D67_Watch::writeScreenBuffer(uint8_t value)
+{
+  if (!_using_partial_mode)
+    _Init_Part();
+  if (_initial_write)
+    _writeScreenBuffer(0x26, value); // set previous
+  _writeScreenBuffer(0x24, value);   // set current
+  _initial_write = false;            // initial full screen buffer clean done
+}
+
+void GxEPD2_154_D67_Watch::writeScreenBufferAgain(uint8_t value)
+{
+  if (!_using_partial_mode)
+    _Init_Part();
+  _writeScreenBuffer(0x24, value); // set current
+  _writeScreenBuffer(0x26, value); // set previous
+  _old_ram_synced = true;
+}
+
+void GxEPD2_154_D67_Watch::_writeScreenBuffer(uint8_t command, uint8_t value)
+{
+  uint32_t start = micros();
+  _RamWritten(command, uint32_t(WIDTH) * uint32_t(HEIGHT) / 8);
+  _writeCommand(command);
+  _startTransfer();
+  for (uint32_t i = 0; i < uint32_t(WIDTH) * uint32_t(HEIGHT) / 8; i++)
+    _transfer(value);
+  _endTransfer();
+  _ram_write_micros += micros() - start;
+}
+
+void GxEPD2_154_D67_Watch::writeImage(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+{
+  _writeImage(0x24, bitmap, x, y, w, h, invert, mirror_y, pgm);
+}
+
+void GxEPD2_154_D67_Watch::writeImageForFullRefresh(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+{
+  _writeImage(0x26, bitmap, x, y, w, h, invert, mirror_y, pgm); // set previous
+  _writeImage(0x24, bitmap, x, y, w, h, invert, mirror_y, pgm); // set current
+}
+
+void GxEPD2_154_D67_Watch::writeImageAgain(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+{
+  if (_single_ram_write && _old_ram_synced)
+    return; // both RAMs hold the displayed frame already
+  _writeImage(0x26, bitmap, x, y, w, h, invert, mirror_y, pgm); // set previous
+  _writeImage(0x24, bitmap, x, y, w, h, invert, mirror_y, pgm); // set current
+  _old_ram_synced = true;
+}
+
+void GxEPD2_154_D67_Watch::_writeImage(uint8_t command, const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+{
+  _writeImagePart(command, bitmap, 0, 0, w, h, x, y, w, h, invert, mirror_y, pgm);
+}
+
+void GxEPD2_154_D67_Watch::writeImagePart(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                                          int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+{
+  _writeImagePart(0x24, bitmap, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y, pgm);
+}
+
+void GxEPD2_154_D67_Watch::writeImagePartAgain(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                                               int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+{
+  if (_single_ram_write && _old_ram_synced)
+    return; // both RAMs hold the displayed frame already
+  _writeImagePart(0x26, bitmap, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y, pgm);
+  _writeImagePart(0x24, bitmap, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y, pgm);
+  _old_ram_synced = true;
+}
+
+void WATCH_HOT GxEPD2_154_D67_Watch::_writeImagePart(uint8_t command, const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                                           int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+{
+  if (_initial_write)
+    writeScreenBuffer(); // initial full screen buffer clean
+  uint32_t start = micros();
+  delay(1);              // yield() to avoid WDT on ESP8266 and ESP32
+  if ((w_bitmap < 0) || (h_bitmap < 0) || (w < 0) || (h < 0))
+    return;
+  if ((x_part < 0) || (x_part >= w_bitmap))
+    return;
+  if ((y_part < 0) || (y_part >= h_bitmap))
+    return;
+  int16_t wb_bitmap = (w_bitmap + 7) / 8; // width bytes, bitmaps are padded
+  x_part -= x_part % 8;                   // byte boundary
+  w = w_bitmap - x_part < w ? w_bitmap - x_part : w; // limit
+  h = h_bitmap - y_part < h ? h_bitmap - y_part : h; // limit
+  x -= x % 8;                             // byte boundary
+  w = 8 * ((w + 7) / 8);                  // byte boundary, bitmaps are padded
+  int16_t x1 = x < 0 ? 0 : x;             // limit
+  int16_t y1 = y < 0 ? 0 : y;             // limit
+  int16_t w1 = x + w < int16_t(WIDTH) ? w : int16_t(WIDTH) - x;   // limit
+  int16_t h1 = y + h < int16_t(HEIGHT) ? h : int16_t(HEIGHT) - y; // limit
+  int16_t dx = x1 - x;
+  int16_t dy = y1 - y;
+  w1 -= dx;
+  h1 -= dy;
+  if ((w1 <= 0) || (h1 <= 0))
+    return;
+  if (!_using_partial_mode)
+  {
+    uint32_t init = micros();
+    _Init_Part();
+    start += micros() - init; // controller init, not RAM write
+  }
+  _setPartialRamArea(x1, y1, w1, h1);
+  _RamWritten(command, uint32_t(h1) * (w1 / 8));
+  _writeCommand(command);
+  _startTransfer();
+  for (int16_t i = 0; i < h1; i++)
+  {
+    for (int16_t j = 0; j < w1 / 8; j++)
+    {
+      uint8_t data;
+      // use wb_bitmap, h_bitmap of bitmap for index!
+      int16_t idx = mirror_y ? x_part / 8 + j + dx / 8 + ((h_bitmap - 1 - (y_part + i + dy))) * wb_bitmap
+                             : x_part / 8 + j + dx / 8 + (y_part + i + dy) * wb_bitmap;
+      if (pgm)
+        data = pgm_read_byte(&bitmap[idx]);
+      else
+        data = bitmap[idx];
+      if (invert)
+        data = ~data;
+      _transfer(data);
+    }
+  }
+  _endTransfer();
+  delay(1); // yield() to avoid WDT on ESP8266 and ESP32
+  _ram_write_micros += micros() - start;
+}
+
+void GxEPD2_154_D67_Watch::writeImageBulk(const uint8_t *data, int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  _writeImageBulk(0x24, data, x, y, w, h);
+}
+
+void GxEPD2_154_D67_Watch::writeImageBulkAgain(const uint8_t *data, int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  if (_single_ram_write && _old_ram_synced)
+    return; // both RAMs hold the displayed frame already
+  _writeImageBulk(0x26, data, x, y, w, h); // set previous
+  _writeImageBulk(0x24, data, x, y, w, h); // set current
+  _old_ram_synced = true;
+}
+
+void WATCH_HOT GxEPD2_154_D67_Watch::_writeImageBulk(uint8_t command, const uint8_t *data, int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  if (_initial_write)
+    writeScreenBuffer(); // initial full screen buffer clean
+  if ((x % 8) || (w % 8) || (x < 0) || (y < 0) || (w <= 0) || (h <= 0) || (x + w > int16_t(WIDTH)) || (y + h > int16_t(HEIGHT)))
+    return;
+  if (!_using_partial_mode)
+    _Init_Part();
+  uint32_t start = micros();
+  _setPartialRamArea(x, y, w, h);
+  uint32_t bytes = uint32_t(h) * (w / 8);
+  _RamWritten(command, bytes);
+  _writeCommand(command);
+  _startTransfer();
+#if SPI_TRACE
+  if (_trace)
+  {
+    for (uint32_t i = 0; i < bytes; i++)
+      _transfer(data[i]);
+  }
+  else
+#endif
+    _pSPIx->writeBytes(data, bytes); // CPU fills the SPI FIFO from memory: DMA can't read flash
+  _endTransfer();
+  _ram_write_micros += micros() - start;
+}
+
+void GxEPD2_154_D67_Watch::writeImage(const uint8_t *black, const uint8_t *color, int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+{
+  if (black)
+    writeImage(black, x, y, w, h, invert, mirror_y, pgm);
+}
+
+void GxEPD2_154_D67_Watch::writeImagePart(const uint8_t *black, const uint8_t *color, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                                          int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+{
+  if (black)
+    writeImagePart(black, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y, pgm);
+}
+
+void GxEPD2_154_D67_Watch::writeNative(const uint8_t *data1, const uint8_t *data2, int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+{
+  if (data1)
+    writeImage(data1, x, y, w, h, invert, mirror_y, pgm);
+}
+
+void GxEPD2_154_D67_Watch::drawImage(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+{
+  writeImage(bitmap, x, y, w, h, invert, mirror_y, pgm);
+  refresh(x, y, w, h);
+  writeImageAgain(bitmap, x, y, w, h, invert, mirror_y, pgm);
+}
+
+void GxEPD2_154_D67_Watch::drawImagePart(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                                         int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+{
+  writeImagePart(bitmap, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y, pgm);
+  refresh(x, y, w, h);
+  writeImagePartAgain(bitmap, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y, pgm);
+}
+
+void GxEPD2_154_D67_Watch::drawImage(const uint8_t *black, const uint8_t *color, int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+{
+  if (black)
+    drawImage(black, x, y, w, h, invert, mirror_y, pgm);
+}
+
+void GxEPD2_154_D67_Watch::drawImagePart(const uint8_t *black, const uint8_t *color, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                                         int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+{
+  if (black)
+    drawImagePart(black, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y, pgm);
+}
+
+void GxEPD2_154_D67_Watch::drawNative(const uint8_t *data1, const uint8_t *data2, int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+{
+  if (data1)
+    drawImage(data1, x, y, w, h, invert, mirror_y, pgm);
+}
+
+void GxEPD2_154_D67_Watch::refresh(bool partial_update_mode)
+{
+  if (partial_update_mode)
+    refresh(0, 0, WIDTH, HEIGHT);
+  else
+  {
+    if (_using_partial_mode)
+      _Init_Full();
+    _Update_Full();
+    _initial_refresh = false; // initial full update done
+  }
+}
+
+void GxEPD2_154_D67_Watch::refresh(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  if (_initial_refresh)
+    return refresh(false); // initial update needs be full update
+  // intersection with screen
+  int16_t w1 = x < 0 ? w + x : w; // reduce
+  int16_t h1 = y < 0 ? h + y : h; // reduce
+  int16_t x1 = x < 0 ? 0 : x;     // limit
+  int16_t y1 = y < 0 ? 0 : y;     // limit
+  w1 = x1 + w1 < int16_t(WIDTH) ? w1 : int16_t(WIDTH) - x1;   // limit
+  h1 = y1 + h1 < int16_t(HEIGHT) ? h1 : int16_t(HEIGHT) - y1; // limit
+  if ((w1 <= 0) || (h1 <= 0))
+    return;
+  // make x1, w1 multiple of 8
+  w1 += x1 % 8;
+  if (w1 % 8 > 0)
+    w1 += 8 - w1 % 8;
+  x1 -= x1 % 8;
+  if (!_using_partial_mode)
+    _Init_Part();
+  _setPartialRamArea(x1, y1, w1, h1);
+  _Update_Part();
+}
+
+void GxEPD2_154_D67_Watch::powerOff()
+{
+  _PowerOff();
+}
+
+void GxEPD2_154_D67_Watch::hibernate()
+{
+  _PowerOff();
+  if (_rst >= 0)
+  {
+    _writeCommand(0x10); // deep sleep mode
+    _writeData(0x1);     // enter deep sleep
+    _hibernating = true;
+    _init_display_done = false;
+    _partial_lut_loaded = false;
+    _warm_config = false;
+  }
+}
+
+void GxEPD2_154_D67_Watch::_setPartialRamArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+  _writeCommand(0x11); // set ram entry mode
+  _writeData(0x03);    // x increase, y increase : normal mode
+  _writeCommand(0x44);
+  _writeData(x / 8);
+  _writeData((x + w - 1) / 8);
+  _writeCommand(0x45);
+  _writeData(y % 256);
+  _writeData(y / 256);
+  _writeData((y + h - 1) % 256);
+  _writeData((y + h - 1) / 256);
+  _writeCommand(0x4e);
+  _writeData(x / 8);
+  _writeCommand(0x4f);
+  _writeData(y % 256);
+  _writeData(y / 256);
+}
+
+void GxEPD2_154_D67_Watch::_PowerOn()
+{
+  if (!_power_is_on)
+  {
+    _writeCommand(0x22);
+    _writeData(SSD1681_UPDATE_POWER_ON);
+    _writeCommand(0x20);
+    _waitWhileBusy("_PowerOn", power_on_time);
+  }
+  _power_is_on = true;
+}
+
+void GxEPD2_154_D67_Watch::_PowerOff()
+{
+  if (_power_is_on)
+  {
+    _writeCommand(0x22);
+    _writeData(SSD1681_UPDATE_POWER_OFF);
+    _writeCommand(0x20);
+    _waitWhileBusy("_PowerOff", power_off_time);
+  }
+  _power_is_on = false;
+  _using_partial_mode = false;
+}
+
+void GxEPD2_154_D67_Watch::_InitDisplay()
+{
+  if (_warm_config)
+    return; // configured before sleepWarm(), kept by the controller
+  uint32_t start = micros();
+  if (_hibernating)
+    _reset();
+  delay(10);           // 10ms according to specs
+  _writeCommand(0x12); // soft reset
+  delay(10);           // 10ms according to specs
+  _partial_lut_loaded = false;
+  _writeCommand(0x01); // Driver output control
+  _writeData(0xC7);
+  _writeData(0x00);
+  _writeData(0x00);
+  _writeCommand(0x3C); // BorderWavefrom
+  _writeData(0x05);
+  _writeCommand(0x18); // Read built-in temperature sensor
+  _writeData(0x80);
+  _setPartialRamArea(0, 0, WIDTH, HEIGHT);
+  _init_display_done = true;
+  _init_display_micros += micros() - start;
+}
+
+void GxEPD2_154_D67_Watch::_Init_Full()
+{
+  _InitDisplay();
+  _PowerOn();
+  _using_partial_mode = false;
+}
+
+void GxEPD2_154_D67_Watch::_Init_Part()
+{
+  _InitDisplay();
+  _PowerOn();
+  _using_partial_mode = true;
+}
+
+void GxEPD2_154_D67_Watch::_RamWritten(uint8_t command, uint32_t bytes)
+{
+  _ram_bytes_written += bytes;
+  if (command == 0x26)
+    _old_ram_written = true;
+}
+
+uint8_t GxEPD2_154_D67_Watch::_UpdateSequence(uint8_t sequence)
+{
+  if (!_use_temperature || !(sequence & SSD1681_UPDATE_LOAD_TEMPERATURE))
+    return sequence;
+  // Cached temperature: write the register, skip the sensor read
+  _writeCommand(0x1A);
+  _writeData(_temperature >> 4);
+  _writeData((_temperature & 0x0F) << 4);
+  return sequence & ~SSD1681_UPDATE_LOAD_TEMPERATURE;
+}
+
+void GxEPD2_154_D67_Watch::_Update_Full()
+{
+  uint8_t sequence = _UpdateSequence(SSD1681_UPDATE_FULL);
+  _writeCommand(0x22);
+  _writeData(sequence);
+  uint32_t start = micros();
+  _writeCommand(0x20);
+  _waitWhileBusy("_Update_Full", full_refresh_time);
+  _last_update_micros = micros() - start;
+  _old_ram_synced = _old_ram_written; // display mode 1 leaves the old RAM alone
+  _old_ram_written = false;
+  _power_is_on = false;
+}
+
+void GxEPD2_154_D67_Watch::_Update_Part()
+{
+  uint8_t sequence = SSD1681_UPDATE_PARTIAL;
+  if (_partial_lut)
+  {
+    _LoadPartialWaveform();
+    sequence = SSD1681_UPDATE_PARTIAL_LUT;
+  }
+  sequence = _UpdateSequence(sequence);
+  _writeCommand(0x22);
+  _writeData(sequence);
+  uint32_t start = micros();
+  _writeCommand(0x20);
+  _waitWhileBusy("_Update_Part", partial_refresh_time);
+  _last_update_micros = micros() - start;
+  _old_ram_synced = true; // display mode 2 takes the displayed frame over as old frame
+  _old_ram_written = false;
+  _power_is_on = true;
+}
+
+void GxEPD2_154_D67_Watch::_LoadPartialWaveform()
+{
+  // Registers keep the LUT until the next (software) reset, one upload per wake is enough
+  if (_partial_lut_loaded)
+    return;
+  _writeCommand(0x32);
+  for (uint16_t i = 0; i < SSD1681_LUT_SIZE; i++)
+    _writeData(_partial_lut[i]);
+  _writeCommand(0x3F); // end option
+  _writeData(_partial_lut[153]);
+  _writeCommand(0x03); // gate voltage
+  _writeData(_partial_lut[154]);
+  _writeCommand(0x04); // source voltage VSH1, VSH2, VSL
+  _writeData(_partial_lut[155]);
+  _writeData(_partial_lut[156]);
+  _writeData(_partial_lut[157]);
+  _writeCommand(0x2C); // VCOM
+  _writeData(_partial_lut[158]);
+  _partial_lut_loaded = true;
+}
+
+#if SPI_TRACE
+void GxEPD2_154_D67_Watch::_reset()
+{
+  if (_trace && _rst >= 0)
+    spi_trace_pin(_trace, SPI_TRACE_PIN_RST, LOW, micros());
+  GxEPD2_EPD::_reset();
+  if (_trace && _rst >= 0)
+    spi_trace_pin(_trace, SPI_TRACE_PIN_RST, HIGH, micros());
+}
+
+void GxEPD2_154_D67_Watch::_waitWhileBusy(const char *comment, uint16_t busy_time)
+{
+  if (_trace)
+    spi_trace_pin(_trace, SPI_TRACE_PIN_BUSY, HIGH, micros());
+  GxEPD2_EPD::_waitWhileBusy(comment, busy_time);
+  if (_trace)
+    spi_trace_pin(_trace, SPI_TRACE_PIN_BUSY, LOW, micros());
+}
+
+void GxEPD2_154_D67_Watch::_writeCommand(uint8_t c)
+{
+  if (_trace)
+    spi_trace_command(_trace, c, micros());
+  GxEPD2_EPD::_writeCommand(c);
+}
+
+void GxEPD2_154_D67_Watch::_writeData(uint8_t d)
+{
+  if (_trace)
+    spi_trace_data(_trace, d);
+  GxEPD2_EPD::_writeData(d);
+}
+
+void GxEPD2_154_D67_Watch::_transfer(uint8_t value)
+{
+  if (_trace)
+    spi_trace_data(_trace, value);
+  GxEPD2_EPD::_transfer(value);
+}
+#endif
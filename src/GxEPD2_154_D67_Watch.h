@@ -0,0 +1,198 @@
+// *****************************************************************************
+// Watch specific driver for the GDEH0154D67 200x200 SSD1681 panel (HINK-E154A07-A1).
+// Same command sequences and behaviour as GxEPD2_154_D67 from GxEPD2
+// (https://github.com/ZinggJM/GxEPD2), so it drops into GxEPD2_BW unchanged,
+// plus the per wake optimizations of this project:
+// - selectPartialWaveform(): partial refreshes with a custom LUT (ssd1681_lut.h)
+//   instead of the waveform stored in the controller's OTP
+// - setTemperature(): update sequences use a cached temperature instead of
+//   reading the built-in sensor; readTemperature() gets the sensed value back
+// - lastUpdateMicros(), ramWriteMicros(): duration of the last refresh and of the
+//   RAM writes, for instrumentation
+// - selectSingleRamWrite(): partial updates write the new frame once, to the
+//   new RAM only; the old RAM is left to the controller, which takes the
+//   displayed frame over as old frame after each display mode 2 update
+// - sleepWarm() / selectWarmWake(): the controller idles between wakes instead
+//   of deep sleep, so the next wake needs no reset and no configuration
+// - setTrace(): with SPI_TRACE 1, commands, data (sent and read), reset and
+//   BUSY waits are recorded to a SpiTrace (spi_trace.h)
+// Selected in GxEPD2_display_selection_new_style.h.
+// *****************************************************************************
+
+#ifndef _GxEPD2_154_D67_Watch_H_
+#define _GxEPD2_154_D67_Watch_H_
+
+#include <GxEPD2_EPD.h>
+
+#include "spi_trace.h"
+
+class GxEPD2_154_D67_Watch : public GxEPD2_EPD
+{
+public:
+  // attributes
+  static const uint16_t WIDTH = 200;
+  static const uint16_t WIDTH_VISIBLE = WIDTH;
+  static const uint16_t HEIGHT = 200;
+  static const GxEPD2::Panel panel = GxEPD2::GDEH0154D67;
+  static const bool hasColor = false;
+  static const bool hasPartialUpdate = true;
+  static const bool hasFastPartialUpdate = true;
+  static const uint16_t power_on_time = 100;       // ms
+  static const uint16_t power_off_time = 150;      // ms
+  static const uint16_t full_refresh_time = 2600;  // ms
+  static const uint16_t partial_refresh_time = 500; // ms
+  // constructor
+  GxEPD2_154_D67_Watch(int16_t cs, int16_t dc, int16_t rst, int16_t busy);
+  using GxEPD2_EPD::init;
+  // no reset pulse after selectWarmWake(true), unless the controller isn't found as sleepWarm() left it
+  void init(uint32_t serial_diag_bitrate, bool initial, uint16_t reset_duration = 10, bool pulldown_rst_mode = false);
+  // methods (virtual)
+  //  Support for Bitmaps (Sprites) to Controller Buffer and to Screen
+  void clearScreen(uint8_t value = 0xFF); // init controller memory and screen (default white)
+  void writeScreenBuffer(uint8_t value = 0xFF); // init controller memory (default white)
+  void writeScreenBufferAgain(uint8_t value = 0xFF); // init previous buffer controller memory (default white)
+  // write to controller memory, without screen refresh; x and w should be multiple of 8
+  void writeImage(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
+  void writeImageForFullRefresh(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
+  void writeImagePart(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                      int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
+  void writeImage(const uint8_t *black, const uint8_t *color, int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
+  void writeImagePart(const uint8_t *black, const uint8_t *color, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                      int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
+  // write sprite of native data to controller memory, without screen refresh; x and w should be multiple of 8
+  void writeNative(const uint8_t *data1, const uint8_t *data2, int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
+  // write to controller memory, with screen refresh; x and w should be multiple of 8
+  void drawImage(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
+  void drawImagePart(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                     int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
+  void drawImage(const uint8_t *black, const uint8_t *color, int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
+  void drawImagePart(const uint8_t *black, const uint8_t *color, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                     int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
+  // write sprite of native data to controller memory, with screen refresh; x and w should be multiple of 8
+  void drawNative(const uint8_t *data1, const uint8_t *data2, int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
+  // write previous buffer to controller memory, after refresh, to keep old and new RAM in sync
+  void writeImageAgain(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
+  void writeImagePartAgain(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                           int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
+  // byte aligned window (x, w multiples of 8, inside the panel) straight from memory (flash), rows of w / 8 bytes,
+  // sent as one block (SPI.writeBytes()), no per byte loop; the Again variant as writeImageAgain()
+  void writeImageBulk(const uint8_t *data, int16_t x, int16_t y, int16_t w, int16_t h);
+  void writeImageBulkAgain(const uint8_t *data, int16_t x, int16_t y, int16_t w, int16_t h);
+  void refresh(bool partial_update_mode = false); // screen refresh from controller memory to full screen
+  void refresh(int16_t x, int16_t y, int16_t w, int16_t h); // screen refresh from controller memory, partial screen
+  void powerOff(); // turns off generation of panel driving voltages, avoids screen fading over time
+  void hibernate(); // turns powerOff() and sets controller to deep sleep for minimum power use, ONLY if wakeable by RST (rst >= 0)
+  // watch specific
+  // waveform for partial refreshes: a SSD1681_LUT_FULL_SIZE LUT (see ssd1681_lut.h), or NULL for the OTP waveform
+  void selectPartialWaveform(const uint8_t *lut);
+  // temperature register value (12 bit, 1/16 degree C) used instead of the built-in sensor
+  void setTemperature(uint16_t temperature);
+  void useTemperatureSensor(); // back to reading the built-in sensor on each update sequence
+  // temperature register, as sensed by the last update sequence that read the sensor, over the
+  // bidirectional data line (3 wire read), or SSD1681_TEMPERATURE_INVALID if the bus can't read
+  uint16_t readTemperature();
+  uint32_t lastUpdateMicros()
+  {
+    return _last_update_micros;
+  };
+  static const uint16_t SSD1681_TEMPERATURE_INVALID = 0xFFFF;
+  // Temperature register value left by sleepWarm(): not the reset value (0x7FF), not a floating or write only
+  // line (all ones or zeros), not a room temperature; every update after init() loads or writes the register
+  static const uint16_t SSD1681_WARM_MARKER = 0x5A5;
+  // skip the old RAM sync after partial updates while the old RAM is known to hold the displayed frame
+  void selectSingleRamWrite(bool enable);
+  // the old RAM (0x26) holds the displayed frame; kept across wakes by the caller (RAM survives hibernate)
+  bool oldRamSynced()
+  {
+    return _old_ram_synced;
+  };
+  void assumeOldRamSynced(bool synced)
+  {
+    _old_ram_synced = synced;
+  };
+  uint32_t ramBytesWritten() // controller RAM bytes sent since construction
+  {
+    return _ram_bytes_written;
+  };
+  uint32_t ramWriteMicros() // time spent sending them (window, transfers, the driver's yields), init excluded
+  {
+    return _ram_write_micros;
+  };
+  // before init(), after selectPartialWaveform(): the controller was left by sleepWarm(), with the partial LUT loaded or not
+  void selectWarmWake(bool warm, bool partialLutLoaded);
+  bool warmWake() // init() resumed the controller without reset
+  {
+    return _warm_config;
+  };
+  // selectWarmWake(true), but init() couldn't verify the controller (lost state, or a bus that can't read back) and
+  // reset it: RAM contents unknown, the caller redraws the full frame
+  bool warmWakeFailed()
+  {
+    return _warm_failed;
+  };
+  // powerOff() without deep sleep: registers and RAM kept, no reset needed to resume; leaves SSD1681_WARM_MARKER
+  // in the temperature register, for init() to verify; the caller keeps reset and chip select high while the MCU sleeps
+  void sleepWarm();
+  bool partialLutLoaded()
+  {
+    return _partial_lut_loaded;
+  };
+  uint32_t initDisplayMicros() // time spent in controller (re)initialization since construction
+  {
+    return _init_display_micros;
+  };
+  // record the bus to trace (NULL: stop), only with SPI_TRACE 1
+  void setTrace(SpiTrace *trace)
+  {
+    _trace = trace;
+  };
+
+private:
+  void _writeScreenBuffer(uint8_t command, uint8_t value);
+  void _writeImage(uint8_t command, const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm);
+  void _writeImagePart(uint8_t command, const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                       int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm);
+  void _writeImageBulk(uint8_t command, const uint8_t *data, int16_t x, int16_t y, int16_t w, int16_t h);
+  void _setPartialRamArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+  void _PowerOn();
+  void _PowerOff();
+  void _InitDisplay();
+  void _Init_Full();
+  void _Init_Part();
+  void _Update_Full();
+  void _Update_Part();
+  void _LoadPartialWaveform();
+  uint8_t _UpdateSequence(uint8_t sequence);
+  void _RamWritten(uint8_t command, uint32_t bytes);
+#if SPI_TRACE
+  // recording layer: the GxEPD2_EPD primitives, each also recorded to _trace. The driver reaches the bus through
+  // these only (also the reset of init(), and the 3 wire read, recorded in readTemperature()); GxEPD2_EPD's other
+  // helpers (_writeDataPGM, _writeCommandData...) call the base primitives and would go unrecorded, so they are not
+  // used here. Not recorded: CS and DC edges (implied by the records). ssd1681_emulate checks the trace against
+  // the bytes the emulated controller sees
+  void _reset();
+  void _waitWhileBusy(const char *comment = 0, uint16_t busy_time = 5000);
+  void _writeCommand(uint8_t c);
+  void _writeData(uint8_t d);
+  void _transfer(uint8_t value);
+#endif
+
+private:
+  const uint8_t *_partial_lut;  // NULL: OTP waveform
+  bool _partial_lut_loaded;     // Registers hold _partial_lut (lost on reset and software reset)
+  bool _use_temperature;        // Use _temperature instead of the built-in sensor
+  uint16_t _temperature;
+  uint32_t _last_update_micros;
+  bool _single_ram_write;
+  bool _old_ram_synced;  // 0x26 holds the displayed frame
+  bool _old_ram_written; // 0x26 written since the last update, with the frame to display
+  uint32_t _ram_bytes_written;
+  uint32_t _ram_write_micros;
+  bool _warm_wake;               // selectWarmWake(true)
+  bool _warm_config;             // registers still hold the configuration, skip _InitDisplay
+  bool _warm_failed;             // warm wake selected, controller not verified: reset
+  uint32_t _init_display_micros;
+  SpiTrace *_trace;
+};
+
+#endif
@@ -17,6 +17,7 @@
 #define GxEPD2_150_BN_IS_BW true
 #define GxEPD2_154_IS_BW true
 #define GxEPD2_154_D67_IS_BW true
+#define GxEPD2_154_D67_Watch_IS_BW true
 #define GxEPD2_154_T8_IS_BW true
 #define GxEPD2_154_M09_IS_BW true
 #define GxEPD2_154_M10_IS_BW true
@@ -0,0 +1,76 @@
+// *****************************************************************************
+// Seven segment digit font, metrics of FreeMonoBold18pt7b, for the watch face
+// (DISPLAY_SEGMENT_FONT in watch_config.h). Glyphs '-' to ':' only.
+// Generated by tools/segment_font_gen.cpp, do not edit: 157776 pixels flipped per
+// day of minute changes, optional segments: 6 top bar on, 7 left bar on, 9 bottom bar on
+// *****************************************************************************
+
+#ifndef WATCH_SEGMENT_18PT7B_H
+#define WATCH_SEGMENT_18PT7B_H
+
+#include <gfxfont.h>
+
+const uint8_t WatchSegment18pt7bBitmaps[] PROGMEM = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0x80, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFC,
+    0x00, 0x7E, 0x00, 0x3F, 0x00, 0x1F, 0x80, 0x0F, 0xC0, 0x07, 0xE0, 0x03,
+    0xF0, 0x01, 0xF8, 0x00, 0xFC, 0x00, 0x7E, 0x00, 0x3F, 0x00, 0x1F, 0x80,
+    0x0F, 0xC0, 0x07, 0xE0, 0x03, 0xF0, 0x01, 0xF8, 0x00, 0xFC, 0x00, 0x7E,
+    0x00, 0x3F, 0x00, 0x1F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x80, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xE0, 0x1F, 0xFF, 0x8F,
+    0xFF, 0xC7, 0xFF, 0xE0, 0x00, 0x70, 0x00, 0x38, 0x00, 0x1C, 0x00, 0x0E,
+    0x00, 0x07, 0x00, 0x03, 0x80, 0x01, 0xC0, 0x00, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0x80, 0x01, 0xC0, 0x00, 0xE0, 0x00, 0x70, 0x00, 0x38,
+    0x00, 0x1C, 0x00, 0x0E, 0x00, 0x07, 0x00, 0x03, 0xFF, 0xF1, 0xFF, 0xF8,
+    0xFF, 0xFC, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xC0, 0x07, 0x00, 0x1C,
+    0x00, 0x70, 0x01, 0xC0, 0x07, 0x00, 0x1C, 0x00, 0x70, 0x01, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xF0, 0x01, 0xC0, 0x07, 0x00, 0x1C, 0x00, 0x70, 0x01,
+    0xC0, 0x07, 0x00, 0x1C, 0x00, 0x7F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFC, 0xE0,
+    0x03, 0xF0, 0x01, 0xF8, 0x00, 0xFC, 0x00, 0x7E, 0x00, 0x3F, 0x00, 0x1F,
+    0x80, 0x0F, 0xC0, 0x07, 0xE0, 0x03, 0xF0, 0x01, 0xF8, 0x00, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFC, 0x00, 0x0E, 0x00, 0x07, 0x00, 0x03, 0x80,
+    0x01, 0xC0, 0x00, 0xE0, 0x00, 0x70, 0x00, 0x38, 0x00, 0x1C, 0x00, 0x0E,
+    0x00, 0x07, 0x00, 0x03, 0x80, 0xFF, 0xFC, 0x7F, 0xFE, 0x3F, 0xFF, 0x1C,
+    0x00, 0x0E, 0x00, 0x07, 0x00, 0x03, 0x80, 0x01, 0xC0, 0x00, 0xE0, 0x00,
+    0x70, 0x00, 0x38, 0x00, 0x1F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFC, 0x00,
+    0x0E, 0x00, 0x07, 0x00, 0x03, 0x80, 0x01, 0xC0, 0x00, 0xE0, 0x00, 0x70,
+    0x00, 0x38, 0x00, 0x1C, 0x7F, 0xFE, 0x3F, 0xFF, 0x1F, 0xFF, 0x80, 0xFF,
+    0xFC, 0x7F, 0xFE, 0x3F, 0xFF, 0x1C, 0x00, 0x0E, 0x00, 0x07, 0x00, 0x03,
+    0x80, 0x01, 0xC0, 0x00, 0xE0, 0x00, 0x70, 0x00, 0x38, 0x00, 0x1F, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x80, 0x0F, 0xC0, 0x07, 0xE0, 0x03, 0xF0,
+    0x01, 0xF8, 0x00, 0xFC, 0x00, 0x7E, 0x00, 0x3F, 0x00, 0x1F, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0x80, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFC,
+    0x00, 0x7E, 0x00, 0x3F, 0x00, 0x1F, 0x80, 0x0F, 0xC0, 0x07, 0xE0, 0x03,
+    0xF0, 0x01, 0xF8, 0x00, 0xFC, 0x00, 0x7E, 0x00, 0x3F, 0x00, 0x1C, 0x00,
+    0x0E, 0x00, 0x07, 0x00, 0x03, 0x80, 0x01, 0xC0, 0x00, 0xE0, 0x00, 0x70,
+    0x00, 0x38, 0x00, 0x1C, 0x00, 0x0E, 0x00, 0x07, 0x00, 0x03, 0x80, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFC, 0x00, 0x7E, 0x00, 0x3F, 0x00, 0x1F,
+    0x80, 0x0F, 0xC0, 0x07, 0xE0, 0x03, 0xF0, 0x01, 0xF8, 0x00, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x80, 0x0F, 0xC0, 0x07, 0xE0, 0x03, 0xF0,
+    0x01, 0xF8, 0x00, 0xFC, 0x00, 0x7E, 0x00, 0x3F, 0x00, 0x1F, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0x80, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFC,
+    0x00, 0x7E, 0x00, 0x3F, 0x00, 0x1F, 0x80, 0x0F, 0xC0, 0x07, 0xE0, 0x03,
+    0xF0, 0x01, 0xF8, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFC, 0x00,
+    0x0E, 0x00, 0x07, 0x00, 0x03, 0x80, 0x01, 0xC0, 0x00, 0xE0, 0x00, 0x70,
+    0x00, 0x38, 0x00, 0x1C, 0x7F, 0xFE, 0x3F, 0xFF, 0x1F, 0xFF, 0x80, 0xFF,
+    0x80, 0x00, 0x00, 0x0F, 0xF8};
+
+const GFXglyph WatchSegment18pt7bGlyphs[] PROGMEM = {
+    {0, 11, 3, 21, 5, -13}, // 0x2D '-'
+    {5, 0, 0, 21, 0, 0}, // 0x2E '.'
+    {5, 0, 0, 21, 0, 0}, // 0x2F '/'
+    {5, 17, 25, 21, 2, -24}, // 0x30 '0'
+    {59, 3, 25, 21, 16, -24}, // 0x31 '1'
+    {69, 17, 25, 21, 2, -24}, // 0x32 '2'
+    {123, 14, 25, 21, 5, -24}, // 0x33 '3'
+    {167, 17, 25, 21, 2, -24}, // 0x34 '4'
+    {221, 17, 25, 21, 2, -24}, // 0x35 '5'
+    {275, 17, 25, 21, 2, -24}, // 0x36 '6'
+    {329, 17, 25, 21, 2, -24}, // 0x37 '7'
+    {383, 17, 25, 21, 2, -24}, // 0x38 '8'
+    {437, 17, 25, 21, 2, -24}, // 0x39 '9'
+    {491, 3, 15, 21, 9, -19}  // 0x3A ':'
+};
+
+const GFXfont WatchSegment18pt7b PROGMEM = {(uint8_t *)WatchSegment18pt7bBitmaps, (GFXglyph *)WatchSegment18pt7bGlyphs, 0x2D, 0x3A, 35};
+
+#endif
@@ -0,0 +1,97 @@
+// *****************************************************************************
+// Boot profile: where the time goes before setup(), on every deep sleep wake.
+// Marks, in boot order:
+// - BOOT_MARK_STUB: the deep sleep wake stub, right after the ROM (first
+//   stage) bootloader, before the second stage bootloader
+// - BOOT_MARK_CONSTRUCTORS: first static constructor of main.cpp, after the
+//   second stage bootloader, the app image load and the IDF startup
+// - BOOT_MARK_DISPLAY: after the GxEPD2 display object constructor
+// - BOOT_MARK_LCD: after the LiquidCrystal lcd object constructor
+// - BOOT_MARK_SETUP: setup() entry, after the Arduino core (app_main,
+//   initArduino, loop task); in the ESP-IDF build (WATCH_IDF) app_main calls
+//   setup() directly
+// Each mark holds the RTC slow clock counter (runs through the whole boot)
+// and the CPU cycle counter (counts from the CPU reset, at the XTAL clock in
+// the ROM, at the CPU clock from the IDF startup on). The ROM phase is the
+// stub cycle count at the XTAL clock, the bootloader phase comes from the
+// slow clock, the later ones from cycles at the CPU clock. Printed as BOOT
+// lines with WAKE_PROFILE (watch_config.h).
+// Plain C++ (no Arduino), the caller takes the marks.
+// *****************************************************************************
+
+#ifndef BOOT_PROFILE_H
+#define BOOT_PROFILE_H
+
+#include <stdint.h>
+
+enum BootMark
+{
+  BOOT_MARK_STUB,
+  BOOT_MARK_CONSTRUCTORS,
+  BOOT_MARK_DISPLAY,
+  BOOT_MARK_LCD,
+  BOOT_MARK_SETUP,
+  BOOT_MARK_COUNT,
+};
+
+enum BootPhase
+{
+  BOOT_PHASE_ROM,          // CPU reset to the wake stub: ROM bootloader (boot messages on UART0 included)
+  BOOT_PHASE_BOOTLOADER,   // Wake stub to the first constructor: second stage bootloader, app image load and check, IDF startup
+  BOOT_PHASE_DISPLAY_CTOR, // GxEPD2 display object constructor
+  BOOT_PHASE_LCD_CTOR,     // Static objects of main.cpp up to the lcd object, its constructor included
+  BOOT_PHASE_ARDUINO,      // Remaining constructors, app_main, initArduino, loop task, to setup() (ESP-IDF build: constructors, app_main)
+  BOOT_PHASE_COUNT,
+};
+
+static const char *const BOOT_PHASE_NAMES[BOOT_PHASE_COUNT] = {"rom", "bootloader", "display_ctor", "lcd_ctor", "arduino"};
+
+// Fractional bits of the slow clock calibration value (microseconds per tick), as rtc_clk_cal()
+#define BOOT_SLOW_CLOCK_CAL_FRACT 19
+
+/// @brief Counters at a mark
+struct BootStamp
+{
+  uint64_t ticks;  // RTC slow clock counter
+  uint32_t cycles; // CPU cycle counter
+};
+
+struct BootProfile
+{
+  uint32_t micros[BOOT_PHASE_COUNT];
+};
+
+/// @brief Slow clock ticks to microseconds
+/// @param ticks
+/// @param slowClockCal Calibration value, microseconds per tick << BOOT_SLOW_CLOCK_CAL_FRACT (esp_clk_slowclk_cal_get())
+inline uint32_t boot_ticks_to_micros(uint64_t ticks, uint32_t slowClockCal)
+{
+  return (uint32_t)((ticks * slowClockCal) >> BOOT_SLOW_CLOCK_CAL_FRACT);
+}
+
+/// @brief Phase durations from the marks
+/// @param profile
+/// @param stamps BOOT_MARK_COUNT marks
+/// @param stubRan The wake stub ran (deep sleep wake): without it the ROM and bootloader phases are unknown, left at 0
+/// @param slowClockCal
+/// @param xtalMHz CPU clock in the ROM
+/// @param cpuMHz CPU clock from the IDF startup on
+inline void boot_profile_compute(BootProfile *profile, const BootStamp *stamps, bool stubRan, uint32_t slowClockCal, uint32_t xtalMHz, uint32_t cpuMHz)
+{
+  profile->micros[BOOT_PHASE_ROM] = stubRan ? stamps[BOOT_MARK_STUB].cycles / xtalMHz : 0;
+  profile->micros[BOOT_PHASE_BOOTLOADER] = stubRan ? boot_ticks_to_micros(stamps[BOOT_MARK_CONSTRUCTORS].ticks - stamps[BOOT_MARK_STUB].ticks, slowClockCal) : 0;
+  profile->micros[BOOT_PHASE_DISPLAY_CTOR] = (stamps[BOOT_MARK_DISPLAY].cycles - stamps[BOOT_MARK_CONSTRUCTORS].cycles) / cpuMHz;
+  profile->micros[BOOT_PHASE_LCD_CTOR] = (stamps[BOOT_MARK_LCD].cycles - stamps[BOOT_MARK_DISPLAY].cycles) / cpuMHz;
+  profile->micros[BOOT_PHASE_ARDUINO] = (stamps[BOOT_MARK_SETUP].cycles - stamps[BOOT_MARK_LCD].cycles) / cpuMHz;
+}
+
+/// @brief Time before setup()
+inline uint32_t boot_profile_total(const BootProfile *profile)
+{
+  uint32_t total = 0;
+  for (uint8_t phase = 0; phase < BOOT_PHASE_COUNT; ++phase)
+    total += profile->micros[phase];
+  return total;
+}
+
+#endif
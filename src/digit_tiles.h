@@ -0,0 +1,366 @@
+// *****************************************************************************
+// Digit tiles: every time character pre-rendered as an opaque cell (monospaced
+// cell width x glyph box height) in the controller RAM layout (native
+// orientation, rotation 3, 1 = white), stored compressed in flash and decoded
+// row by row straight into a RAM window buffer (PanelBuffer). No glyph bitmap
+// decoding and no drawPixel() per pixel; a tile row lands on whole bytes
+// (shifted when the cell is not byte aligned).
+// Formats, per tile (all rows of (height + 7) / 8 bytes):
+// - DIGIT_TILE_RAW: the rows as they are
+// - DIGIT_TILE_PACKBITS: PackBits over the row bytes (n >= 0: n + 1 literal
+//   bytes, n < 0: the next byte 1 - n times)
+// - DIGIT_TILE_ROW_REPEAT: control byte then rows; bit 7 set: the previous row
+//   again (c & 0x7F) + 1 times, clear: c + 1 literal rows. Bold digits have
+//   long runs of identical rows (bars across the cell), so this decodes with
+//   no copy at all: a repeated row is the same pointer.
+// The smallest format is not the fastest wake: after deep sleep the flash
+// cache is cold, every 32 byte line read costs a flash access, and the
+// decoder's CPU time adds up; tools/digit_tiles.cpp measures both and writes
+// the tile set (src/DigitTiles.h) in the chosen format.
+// Plain C++ (no Arduino), shared with the host tools.
+// *****************************************************************************
+
+#ifndef DIGIT_TILES_H
+#define DIGIT_TILES_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include "watch_config.h"
+#include "display_layout.h"
+#include "refresh_scheduler.h"
+#include "multi_window.h"
+
+enum DigitTileFormat
+{
+  DIGIT_TILE_RAW,
+  DIGIT_TILE_PACKBITS,
+  DIGIT_TILE_ROW_REPEAT,
+  DIGIT_TILE_FORMAT_COUNT
+};
+
+// Longest tile row, in bytes (a glyph box of up to 200 pixels)
+#define DIGIT_TILE_ROW_BYTES_MAX 25
+
+/// @brief Tiles of a font, generated by tools/digit_tiles.cpp
+struct DigitTileSet
+{
+  uint8_t format;          // DigitTileFormat
+  uint8_t advance;         // Rows per tile: the cell width
+  uint8_t height;          // Pixels per row: the glyph box height
+  int8_t top;              // Box top, relative to the baseline
+  int16_t boundsX, boundsY; // Text bounds of DISPLAY_REFERENCE_TIME at cursor (0, 0)
+  uint16_t boundsW, boundsH;
+  const char *chars;       // Characters of the tiles, in order
+  const uint16_t *offsets; // Start of each tile in data, plus the end
+  const uint8_t *data;
+};
+
+/// @brief Row by row decoding of one tile
+struct DigitTileReader
+{
+  const DigitTileSet *set;
+  const uint8_t *src;
+  const uint8_t *row; // Last row returned
+  uint8_t rowBytes;
+  uint8_t repeat;     // DIGIT_TILE_ROW_REPEAT: rows left of the current run
+  uint8_t literal;
+  int16_t count;      // DIGIT_TILE_PACKBITS: bytes left of the current run, negative for a repeat
+  uint8_t value;
+  bool blank;         // Character without a tile: white rows
+  uint8_t buffer[DIGIT_TILE_ROW_BYTES_MAX];
+};
+
+/// @brief Start decoding the tile of a character
+/// @param reader
+/// @param set
+/// @param c A character without a tile gives white rows
+inline void digit_tile_reader_begin(DigitTileReader *reader, const DigitTileSet &set, char c)
+{
+  const char *found = strchr(set.chars, c);
+  reader->set = &set;
+  reader->rowBytes = (set.height + 7) / 8;
+  reader->repeat = 0;
+  reader->literal = 0;
+  reader->count = 0;
+  reader->blank = (c == 0) || (found == NULL);
+  reader->src = reader->blank ? NULL : set.data + set.offsets[found - set.chars];
+  reader->row = reader->buffer;
+  if (reader->blank)
+    memset(reader->buffer, 0xFF, reader->rowBytes);
+}
+
+/// @brief Next row of the tile (set.advance rows in all)
+/// @param reader
+/// @return The row bytes, valid until the next call
+inline const uint8_t *WATCH_HOT digit_tile_reader_next(DigitTileReader *reader)
+{
+  if (reader->blank)
+    return reader->buffer;
+  switch (reader->set->format)
+  {
+  case DIGIT_TILE_ROW_REPEAT:
+    if (reader->repeat)
+    {
+      reader->repeat--;
+      return reader->row;
+    }
+    if (!reader->literal)
+    {
+      uint8_t control = *reader->src++;
+      if (control & 0x80)
+      {
+        reader->repeat = control & 0x7F;
+        return reader->row;
+      }
+      reader->literal = control + 1;
+    }
+    reader->literal--;
+    reader->row = reader->src;
+    reader->src += reader->rowBytes;
+    return reader->row;
+  case DIGIT_TILE_PACKBITS:
+    for (uint8_t i = 0; i < reader->rowBytes; ++i)
+    {
+      if (reader->count == 0)
+      {
+        int8_t n = (int8_t)*reader->src++;
+        if (n >= 0)
+          reader->count = n + 1;
+        else
+        {
+          reader->count = n - 1; // -(1 - n)
+          reader->value = *reader->src++;
+        }
+      }
+      if (reader->count > 0)
+      {
+        reader->buffer[i] = *reader->src++;
+        reader->count--;
+      }
+      else
+      {
+        reader->buffer[i] = reader->value;
+        reader->count++;
+      }
+    }
+    return reader->buffer;
+  default:
+    reader->row = reader->src;
+    reader->src += reader->rowBytes;
+    return reader->row;
+  }
+}
+
+/// @brief Copy a tile row into a buffer row at a bit position, clipped (opaque)
+/// @param dest Buffer row
+/// @param destBits Buffer row width, in pixels
+/// @param x Bit position of the tile row
+/// @param row
+/// @param width Tile row width, in pixels
+inline void WATCH_HOT digit_tile_put_row(uint8_t *dest, int16_t destBits, int16_t x, const uint8_t *row, uint8_t width)
+{
+  if (x >= 0 && x + width <= destBits)
+  {
+    const uint8_t shift = x & 7;
+    uint8_t *out = dest + (x >> 3);
+    for (uint8_t bit = 0; bit < width; bit += 8, ++row, ++out)
+    {
+      const uint8_t mask = (width - bit >= 8) ? 0xFF : (uint8_t)(0xFF << (8 - (width - bit)));
+      const uint8_t value = *row & mask;
+      out[0] = (out[0] & ~(mask >> shift)) | (value >> shift);
+      if (shift && (uint8_t)(mask << (8 - shift)))
+        out[1] = (out[1] & ~(uint8_t)(mask << (8 - shift))) | (uint8_t)(value << (8 - shift));
+    }
+    return;
+  }
+  // Partly outside: bit by bit
+  for (uint8_t bit = 0; bit < width; ++bit)
+  {
+    int16_t to = x + bit;
+    if (to < 0 || to >= destBits)
+      continue;
+    if ((row[bit >> 3] >> (7 - (bit & 7))) & 1)
+      dest[to >> 3] |= 0x80 >> (to & 7);
+    else
+      dest[to >> 3] &= ~(0x80 >> (to & 7));
+  }
+}
+
+/// @brief Draw a text at the cursor (baseline), opaque cells
+/// @param target
+/// @param set
+/// @param text
+/// @param cursorX, cursorY Rotated coordinates
+inline void digit_tile_draw_text(const PanelBuffer &target, const DigitTileSet &set, const char *text, int16_t cursorX, int16_t cursorY)
+{
+  const uint16_t pitch = (target.panel.w + 7) / 8;
+  DigitTileReader reader;
+  for (; *text; ++text, cursorX += set.advance)
+  {
+    // Rotation 3: tile row r is panel y = HEIGHT - (cursorX + advance) + r, bit b is panel x = cursorY + top + b
+    int16_t y = (int16_t)target.displayHeight - (cursorX + set.advance) - target.panel.y;
+    int16_t x = cursorY + set.top - target.panel.x;
+    digit_tile_reader_begin(&reader, set, *text);
+    for (uint8_t r = 0; r < set.advance; ++r, ++y)
+    {
+      const uint8_t *row = digit_tile_reader_next(&reader);
+      if (y >= 0 && y < (int16_t)target.panel.h)
+        digit_tile_put_row(target.buffer + y * pitch, target.panel.w, x, row, set.height);
+    }
+  }
+}
+
+/// @brief Draw the time regions in the mask (draw_regions() for a buffer), the buffer cleared first
+/// @param target
+/// @param set
+/// @param layout
+/// @param hoursText
+/// @param minutesText
+/// @param regionMask REGION_BIT() of the regions to draw, the power reserve is not drawn here
+/// @param inverted White on black, used by the ghosting cleanup
+inline void digit_tile_draw_regions(const PanelBuffer &target, const DigitTileSet &set, const DisplayLayout &layout,
+                                    const char *hoursText, const char *minutesText, uint8_t regionMask, bool inverted)
+{
+  const uint32_t size = (uint32_t)((target.panel.w + 7) / 8) * target.panel.h;
+  memset(target.buffer, 0xFF, size);
+  if (regionMask & REGION_BIT(REGION_HOURS))
+    digit_tile_draw_text(target, set, hoursText, layout.cursorX, layout.cursorY);
+  if (regionMask & REGION_BIT(REGION_COLON))
+    digit_tile_draw_text(target, set, ":", layout.cursorX + 2 * layout.charAdvance, layout.cursorY);
+  if (regionMask & REGION_BIT(REGION_MINUTES))
+    digit_tile_draw_text(target, set, minutesText, layout.cursorX + 3 * layout.charAdvance, layout.cursorY);
+  if (inverted)
+    for (uint32_t i = 0; i < size; ++i)
+      target.buffer[i] = ~target.buffer[i];
+}
+
+/// @brief Compute the layout for a tile set, centered on the display (display_layout_measure() for fonts)
+/// @param set
+/// @param displayWidth, displayHeight Rotated display size
+/// @param layout
+inline void digit_tile_layout_compute(const DigitTileSet &set, uint16_t displayWidth, uint16_t displayHeight, DisplayLayout *layout)
+{
+  display_layout_compute(layout, set.boundsX, set.boundsY, set.boundsW, set.boundsH, set.advance, displayWidth, displayHeight);
+}
+
+/// @brief Pixels that flip between two texts of the same length (text_flip_count() for fonts)
+/// @param set
+/// @param previous
+/// @param next
+/// @return
+inline uint32_t WATCH_HOT digit_tile_text_flip_count(const DigitTileSet &set, const char *previous, const char *next)
+{
+  const uint8_t lastMask = (uint8_t)(0xFF << ((8 - set.height % 8) % 8));
+  uint32_t flips = 0;
+  DigitTileReader a, b;
+  for (; *previous && *next; ++previous, ++next)
+  {
+    if (*previous == *next)
+      continue;
+    digit_tile_reader_begin(&a, set, *previous);
+    digit_tile_reader_begin(&b, set, *next);
+    for (uint8_t r = 0; r < set.advance; ++r)
+    {
+      const uint8_t *rowA = digit_tile_reader_next(&a);
+      const uint8_t *rowB = digit_tile_reader_next(&b);
+      for (uint8_t i = 0; i < a.rowBytes; ++i)
+        flips += __builtin_popcount((rowA[i] ^ rowB[i]) & (i + 1 == a.rowBytes ? lastMask : 0xFF));
+    }
+  }
+  return flips;
+}
+
+// **********
+// Native tiles (DISPLAY_DIGIT_TILES_NATIVE): raw tiles pre-shifted for the layout,
+// each row exactly a row of the hours and minutes RAM windows, so a cell is
+// written to the controller straight from flash (writeImageBulk()), without a
+// buffer. The rows of a region outside its cells (safety margin) come from a
+// white block. ESP32 SPI DMA can't read flash: the bytes go through the SPI
+// FIFO, filled by the CPU from the memory-mapped flash.
+// **********
+
+// Most writes for a region: white rows, two cells, white rows
+#define DIGIT_TILE_NATIVE_WRITES_MAX 4
+
+/// @brief Native tiles, generated by tools/digit_tiles.cpp for one layout
+struct DigitTileNative
+{
+  int16_t cursorX, cursorY; // Layout the tiles were shifted for
+  int16_t panelX;           // Panel window of the hours and minutes regions: left edge and width, byte aligned
+  uint16_t panelW;
+  uint8_t rows;             // Rows per tile: the cell width
+  uint8_t whiteRows;        // Rows of the white block
+  const char *chars;        // Characters of the tiles, in order
+  const uint8_t *data;      // rows x panelW / 8 bytes per tile
+  const uint8_t *white;     // whiteRows x panelW / 8 bytes of 0xFF
+};
+
+/// @brief One controller RAM window write, from flash
+struct DigitTileWrite
+{
+  const uint8_t *data;
+  DisplayWindow panel;
+};
+
+/// @brief Add the write of the rows of a source starting at a rotated x, clipped to the region
+inline void digit_tile_native_add(DigitTileWrite *writes, uint8_t *count, const uint8_t *source, uint16_t rowBytes, int16_t sourceX,
+                                  int16_t sourceRows, int16_t regionX0, int16_t regionX1, uint16_t displayHeight, uint16_t panelX, uint16_t panelW)
+{
+  int16_t x0 = sourceX > regionX0 ? sourceX : regionX0;
+  int16_t x1 = (sourceX + sourceRows) < regionX1 ? (sourceX + sourceRows) : regionX1;
+  if (x1 <= x0)
+    return;
+  // Rotation 3: source row r is x = sourceX + sourceRows - 1 - r, panel y = displayHeight - 1 - x
+  const int16_t first = sourceX + sourceRows - x1;
+  DigitTileWrite &write = writes[(*count)++];
+  write.data = source + (uint32_t)first * rowBytes;
+  write.panel.x = panelX;
+  write.panel.y = displayHeight - x1;
+  write.panel.w = panelW;
+  write.panel.h = x1 - x0;
+}
+
+/// @brief Writes of a time region from the native tiles
+/// @param native
+/// @param layout Must be the layout of the tiles
+/// @param displayHeight Panel height
+/// @param region REGION_HOURS or REGION_MINUTES
+/// @param text The region text, 2 characters
+/// @param writes DIGIT_TILE_NATIVE_WRITES_MAX
+/// @return Number of writes, covering the region window; 0 when the tiles don't apply (other layout, other character)
+inline uint8_t digit_tile_native_plan(const DigitTileNative &native, const DisplayLayout &layout, uint16_t displayHeight, uint8_t region,
+                                      const char *text, DigitTileWrite *writes)
+{
+  if (region != REGION_HOURS && region != REGION_MINUTES)
+    return 0;
+  const DisplayWindow &window = (region == REGION_HOURS) ? layout.hours : layout.minutes;
+  const DisplayWindow panel = display_window_to_panel(window, displayHeight);
+  if (layout.cursorX != native.cursorX || layout.cursorY != native.cursorY || panel.x != native.panelX || panel.w != native.panelW ||
+      strlen(text) != 2)
+    return 0;
+  const uint16_t rowBytes = native.panelW / 8;
+  const uint32_t tileBytes = (uint32_t)native.rows * rowBytes;
+  const int16_t regionX0 = window.x, regionX1 = window.x + window.w;
+  const int16_t textX = layout.cursorX + (region == REGION_HOURS ? 0 : 3) * layout.charAdvance;
+  const int16_t textEnd = textX + 2 * native.rows;
+  const int16_t before = textX - regionX0, after = regionX1 - textEnd;
+  if (before > native.whiteRows || after > native.whiteRows)
+    return 0;
+  uint8_t count = 0;
+  for (uint8_t i = 0; i < 2; ++i)
+  {
+    const char *found = strchr(native.chars, text[i]);
+    if (!text[i] || !found)
+      return 0;
+    digit_tile_native_add(writes, &count, native.data + (found - native.chars) * tileBytes, rowBytes, textX + i * native.rows, native.rows,
+                          regionX0, regionX1, displayHeight, native.panelX, native.panelW);
+  }
+  if (before > 0)
+    digit_tile_native_add(writes, &count, native.white, rowBytes, regionX0, before, regionX0, regionX1, displayHeight, native.panelX, native.panelW);
+  if (after > 0)
+    digit_tile_native_add(writes, &count, native.white, rowBytes, textEnd, after, regionX0, regionX1, displayHeight, native.panelX, native.panelW);
+  return count;
+}
+
+#endif
@@ -0,0 +1,102 @@
+// *****************************************************************************
+// Display layout: the time "hh:mm" split into independent hours, colon and
+// minutes regions, each with its own fixed partial window.
+// The layout is computed once from the text bounds of a reference string
+// (monospaced font, so every "hh:mm" fits the same cells) and cached in RTC
+// memory, so a normal wake only picks the window of the region that changed.
+// Coordinates are in the rotated (setRotation(3)) space. With rotation 3 the
+// x axis runs along the panel gate lines, so splitting the regions along x
+// needs no byte alignment.
+// Plain C++ (no Arduino), shared with the host tools.
+// *****************************************************************************
+
+#ifndef DISPLAY_LAYOUT_H
+#define DISPLAY_LAYOUT_H
+
+#include <stdint.h>
+
+// Rotation, and the string measured to place the time
+#define DISPLAY_ROTATION 3
+#define DISPLAY_REFERENCE_TIME "00:00"
+
+// Safety margin around the text, in percent of its size
+#define DISPLAY_SAFETY_MARGIN_PERCENT 5
+
+/// @brief Partial window, rotated coordinates
+struct DisplayWindow
+{
+  int16_t x, y;
+  uint16_t w, h;
+};
+
+/// @brief Buffer in the controller RAM layout, covering a panel window (native orientation)
+struct PanelBuffer
+{
+  uint8_t *buffer;        // rows of (panel.w + 7) / 8 bytes, 1 = white
+  DisplayWindow panel;    // panel coordinates of the buffer
+  uint16_t displayHeight; // panel HEIGHT, for rotation 3
+};
+
+/// @brief Where the time is drawn and the partial window of each region
+struct DisplayLayout
+{
+  bool valid;
+  int16_t cursorX, cursorY; // Text cursor (baseline) of the first character
+  uint16_t charAdvance;     // Monospaced cell width
+  DisplayWindow time;       // Whole "hh:mm"
+  DisplayWindow hours;      // "hh"
+  DisplayWindow colon;      // ":"
+  DisplayWindow minutes;    // "mm"
+};
+
+/// @brief Compute the layout, centered on the display
+/// @param layout
+/// @param tbx, tby, tbw, tbh Text bounds of DISPLAY_REFERENCE_TIME at cursor (0, 0)
+/// @param charAdvance Font xAdvance (same for every glyph in a monospaced font)
+/// @param displayWidth, displayHeight Rotated display size
+inline void display_layout_compute(DisplayLayout *layout, int16_t tbx, int16_t tby, uint16_t tbw, uint16_t tbh,
+                                   uint16_t charAdvance, uint16_t displayWidth, uint16_t displayHeight)
+{
+  // Center the bounding box by transposition of the origin
+  layout->cursorX = ((displayWidth - tbw) / 2) - tbx;
+  layout->cursorY = ((displayHeight - tbh) / 2) - tby;
+  layout->charAdvance = charAdvance;
+
+  // Whole time window: the text bounds, plus a safety margin, mainly because of ints rounding down
+  uint16_t marginH = tbw * DISPLAY_SAFETY_MARGIN_PERCENT / 100;
+  uint16_t marginV = tbh * DISPLAY_SAFETY_MARGIN_PERCENT / 100;
+  layout->time.x = layout->cursorX + tbx - marginH;
+  layout->time.y = layout->cursorY + tby - marginV;
+  layout->time.w = tbw + marginH * 2;
+  layout->time.h = tbh + marginV * 2;
+
+  // Regions split at the character cell boundaries: "hh" | ":" | "mm"
+  int16_t colonStart = layout->cursorX + 2 * charAdvance;
+  int16_t minutesStart = layout->cursorX + 3 * charAdvance;
+  layout->hours = layout->time;
+  layout->hours.w = colonStart - layout->time.x;
+  layout->colon = layout->time;
+  layout->colon.x = colonStart;
+  layout->colon.w = charAdvance;
+  layout->minutes = layout->time;
+  layout->minutes.x = minutesStart;
+  layout->minutes.w = layout->time.x + layout->time.w - minutesStart;
+
+  layout->valid = true;
+}
+
+/// @brief Smallest window containing both windows
+/// @param a
+/// @param b
+/// @return
+inline DisplayWindow display_window_union(const DisplayWindow &a, const DisplayWindow &b)
+{
+  int16_t x0 = a.x < b.x ? a.x : b.x;
+  int16_t y0 = a.y < b.y ? a.y : b.y;
+  int16_t x1 = (a.x + a.w) > (b.x + b.w) ? (a.x + a.w) : (b.x + b.w);
+  int16_t y1 = (a.y + a.h) > (b.y + b.h) ? (a.y + a.h) : (b.y + b.h);
+  DisplayWindow window = {x0, y0, (uint16_t)(x1 - x0), (uint16_t)(y1 - y0)};
+  return window;
+}
+
+#endif
@@ -0,0 +1,116 @@
+// *****************************************************************************
+// Energy aware update policy.
+// The supply (storage capacitor) voltage measured during the previous BUSY
+// wait decides how much work this wake may do:
+// - normal: partial refresh every minute
+// - degraded: refresh only every ENERGY_DEGRADED_EVERY_MINUTES minutes
+// - hours only: refresh only when the hour changes, minutes shown as "--"
+// A small hysteresis avoids flipping between policies on every wake.
+// Plain C++ (no Arduino).
+// *****************************************************************************
+
+#ifndef ENERGY_POLICY_H
+#define ENERGY_POLICY_H
+
+#include <stdint.h>
+
+#include "watch_config.h"
+
+enum UpdatePolicy
+{
+  UPDATE_POLICY_NORMAL = 0,
+  UPDATE_POLICY_DEGRADED = 1,
+  UPDATE_POLICY_HOURS_ONLY = 2,
+};
+
+/// @brief Energy state kept in RTC memory
+struct EnergyState
+{
+  uint16_t supplyMillivolts;    // Lowest supply voltage seen during the last refresh, 0 if unknown
+  uint16_t policy;              // UpdatePolicy used by the last wake
+  uint32_t minutesSinceRefresh; // Minutes counted since the display was last refreshed
+};
+
+/// @brief Choose the update policy for the measured supply voltage
+/// @param supplyMillivolts Supply voltage, 0 if never measured (assume normal)
+/// @param previous Policy of the previous wake, for the hysteresis
+/// @return
+inline UpdatePolicy energy_choose_policy(uint16_t supplyMillivolts, UpdatePolicy previous)
+{
+  if (supplyMillivolts == 0)
+    return UPDATE_POLICY_NORMAL;
+
+  // Going up a level needs ENERGY_HYSTERESIS_MV more than going down
+  uint16_t degradedMillivolts = ENERGY_DEGRADED_BELOW_MV;
+  uint16_t hoursOnlyMillivolts = ENERGY_HOURS_ONLY_BELOW_MV;
+  if (previous >= UPDATE_POLICY_DEGRADED)
+    degradedMillivolts += ENERGY_HYSTERESIS_MV;
+  if (previous >= UPDATE_POLICY_HOURS_ONLY)
+    hoursOnlyMillivolts += ENERGY_HYSTERESIS_MV;
+
+  if (supplyMillivolts < hoursOnlyMillivolts)
+    return UPDATE_POLICY_HOURS_ONLY;
+  if (supplyMillivolts < degradedMillivolts)
+    return UPDATE_POLICY_DEGRADED;
+  return UPDATE_POLICY_NORMAL;
+}
+
+/// @brief Whether this wake refreshes the display
+/// @param policy Policy for this wake
+/// @param previous Policy of the previous wake (a change always refreshes, e.g. to show or hide "--")
+/// @param minuteCount Minutes since 00:00, already incremented
+/// @param minutesSinceRefresh Minutes since the last refresh, including this wake
+/// @return
+inline bool energy_should_refresh(UpdatePolicy policy, UpdatePolicy previous, int minuteCount, uint32_t minutesSinceRefresh)
+{
+  if (policy != previous)
+    return true;
+
+  switch (policy)
+  {
+  case UPDATE_POLICY_DEGRADED:
+    return minutesSinceRefresh >= ENERGY_DEGRADED_EVERY_MINUTES;
+  case UPDATE_POLICY_HOURS_ONLY:
+    // Also catch up if the wake exactly at the hour was missed
+    return (minuteCount % 60) == 0 || minutesSinceRefresh >= 60;
+  default:
+    return true;
+  }
+}
+
+/// @brief Supply voltage where the power reserve indicator reaches a level
+/// @param level 0 to POWER_RESERVE_LEVELS
+/// @return
+inline uint32_t power_reserve_level_millivolts(uint8_t level)
+{
+  return ENERGY_HOURS_ONLY_BELOW_MV + (uint32_t)level * (POWER_RESERVE_FULL_MV - ENERGY_HOURS_ONLY_BELOW_MV) / POWER_RESERVE_LEVELS;
+}
+
+/// @brief Quantized power reserve level for the power reserve indicator
+/// Like the policy, with a hysteresis: the level shown only changes once the supply is half a step past its
+/// bounds, so a reading that sits on a step (BUSY samples are noisy) doesn't redraw the bar every wake.
+/// @param supplyMillivolts Supply voltage, 0 if never measured (shown as full)
+/// @param shown Level on screen, 0xFF if none (plain quantization)
+/// @return 0 (empty, at the hours only threshold) to POWER_RESERVE_LEVELS (full)
+inline uint8_t power_reserve_level(uint16_t supplyMillivolts, uint8_t shown = 0xFF)
+{
+  uint8_t level;
+  if (supplyMillivolts == 0 || supplyMillivolts >= POWER_RESERVE_FULL_MV)
+    level = POWER_RESERVE_LEVELS;
+  else if (supplyMillivolts <= ENERGY_HOURS_ONLY_BELOW_MV)
+    level = 0;
+  else
+    level = (uint8_t)((uint32_t)(supplyMillivolts - ENERGY_HOURS_ONLY_BELOW_MV) * POWER_RESERVE_LEVELS /
+                      (POWER_RESERVE_FULL_MV - ENERGY_HOURS_ONLY_BELOW_MV));
+  if (supplyMillivolts == 0 || shown > POWER_RESERVE_LEVELS || level == shown)
+    return level;
+
+  const uint32_t halfStep = (POWER_RESERVE_FULL_MV - ENERGY_HOURS_ONLY_BELOW_MV) / (2 * POWER_RESERVE_LEVELS);
+  if (level > shown && supplyMillivolts < power_reserve_level_millivolts(shown + 1) + halfStep)
+    return shown;
+  if (level < shown && supplyMillivolts + halfStep >= power_reserve_level_millivolts(shown))
+    return shown;
+  return level;
+}
+
+#endif
@@ -0,0 +1,99 @@
+// *****************************************************************************
+// Changed pixel heuristic: choose partial, partial with cleanup or full
+// refresh from the number of pixels that flip between the frame on screen
+// and the next one.
+// The previous frame is cached in RTC memory as the text it shows (one glyph
+// per monospaced cell, same cursor), so the changed pixels are the XOR of
+// the two glyph bitmaps of each cell, read straight from the font in flash.
+// Four digits at most, a few microseconds, no frame buffer needed.
+// Plain C++ (no Arduino), only needs Adafruit GFX's gfxfont.h.
+// *****************************************************************************
+
+#ifndef FRAME_DIFF_H
+#define FRAME_DIFF_H
+
+#include <stdint.h>
+#include <gfxfont.h>
+
+#include "watch_config.h"
+
+enum RefreshMode
+{
+  REFRESH_MODE_PARTIAL,       // Plain partial refresh
+  REFRESH_MODE_PARTIAL_CLEAN, // Mid strength: window refreshed inverted, then normal
+  REFRESH_MODE_FULL,          // Full screen refresh
+};
+
+/// @brief Pixel of a glyph, in cursor relative coordinates
+/// @param font
+/// @param glyph
+/// @param x Relative to the cursor
+/// @param y Relative to the baseline
+/// @return 1 if set
+inline uint8_t glyph_pixel(const GFXfont *font, const GFXglyph *glyph, int16_t x, int16_t y)
+{
+  int16_t gx = x - glyph->xOffset;
+  int16_t gy = y - glyph->yOffset;
+  if (gx < 0 || gy < 0 || gx >= glyph->width || gy >= glyph->height)
+    return 0;
+  uint16_t bit = gy * glyph->width + gx;
+  return (font->bitmap[glyph->bitmapOffset + bit / 8] >> (7 - bit % 8)) & 1;
+}
+
+/// @brief Pixels that flip when glyph a is replaced by glyph b at the same cursor
+/// @param font
+/// @param a
+/// @param b
+/// @return
+inline uint32_t WATCH_HOT glyph_flip_count(const GFXfont *font, char a, char b)
+{
+  if (a == b)
+    return 0;
+  if ((uint8_t)a < font->first || (uint8_t)a > font->last || (uint8_t)b < font->first || (uint8_t)b > font->last)
+    return 0;
+  const GFXglyph *ga = &font->glyph[(uint8_t)a - font->first];
+  const GFXglyph *gb = &font->glyph[(uint8_t)b - font->first];
+
+  // Union of both glyph boxes
+  int16_t x0 = ga->xOffset < gb->xOffset ? ga->xOffset : gb->xOffset;
+  int16_t y0 = ga->yOffset < gb->yOffset ? ga->yOffset : gb->yOffset;
+  int16_t x1 = (ga->xOffset + ga->width) > (gb->xOffset + gb->width) ? (ga->xOffset + ga->width) : (gb->xOffset + gb->width);
+  int16_t y1 = (ga->yOffset + ga->height) > (gb->yOffset + gb->height) ? (ga->yOffset + ga->height) : (gb->yOffset + gb->height);
+
+  uint32_t flips = 0;
+  for (int16_t y = y0; y < y1; ++y)
+    for (int16_t x = x0; x < x1; ++x)
+      flips += glyph_pixel(font, ga, x, y) ^ glyph_pixel(font, gb, x, y);
+  return flips;
+}
+
+/// @brief Pixels that flip between two texts of the same length drawn with a monospaced font
+/// @param font
+/// @param previous
+/// @param next
+/// @return
+inline uint32_t text_flip_count(const GFXfont *font, const char *previous, const char *next)
+{
+  uint32_t flips = 0;
+  for (; *previous && *next; ++previous, ++next)
+    flips += glyph_flip_count(font, *previous, *next);
+  return flips;
+}
+
+/// @brief Choose the refresh mode from the changed pixel ratio and the per mode cost
+/// @param changedPixels
+/// @param windowPixels Pixels in the partial window
+/// @return
+inline RefreshMode refresh_choose_mode(uint32_t changedPixels, uint32_t windowPixels)
+{
+  // Few flips: the ghosting left by a plain partial refresh is tolerable
+  if (windowPixels == 0 || changedPixels * 100 <= windowPixels * REFRESH_GHOST_TOLERANCE_PERCENT)
+    return REFRESH_MODE_PARTIAL;
+
+  // Many flips (e.g. 23:59 to 00:00): clean them, with whichever mode is cheaper
+  if (REFRESH_COST_FULL_MS <= 2 * REFRESH_COST_PARTIAL_MS)
+    return REFRESH_MODE_FULL;
+  return REFRESH_MODE_PARTIAL_CLEAN;
+}
+
+#endif
@@ -0,0 +1,87 @@
+// *****************************************************************************
+// Generator time base (Spring Drive style).
+// The ULP samples the squared generator signal every GENERATOR_ULP_SAMPLE_US,
+// counts rising edges and, every GENERATOR_EDGES_PER_MINUTE edges, increments
+// a minute counter and wakes the main core.
+// This file is the reference model of the ULP program in generator_ulp.cpp,
+// step by step and with the same 16 bit arithmetic, so the host simulator
+// (tools/generator_pulse_sim.cpp) validates the real counting logic.
+// Plain C++ (no Arduino).
+// *****************************************************************************
+
+#ifndef GENERATOR_TIMEBASE_H
+#define GENERATOR_TIMEBASE_H
+
+#include <stdint.h>
+
+#include "watch_config.h"
+
+static_assert(GENERATOR_EDGES_PER_MINUTE > 0 && GENERATOR_EDGES_PER_MINUTE <= 0xFFFF,
+              "GENERATOR_EDGES_PER_MINUTE must fit the 16 bit ULP registers");
+
+/// @brief ULP state, mirrored word by word in RTC slow memory
+struct GeneratorCounter
+{
+  uint16_t edgeCount;    // Rising edges counted in the current minute
+  uint16_t lastLevel;    // Signal level at the previous sample
+  uint16_t threshold;    // Edges per minute (calibration)
+  uint16_t minuteTotal;  // Minutes counted by the ULP, wraps at 16 bits
+};
+
+/// @brief Start counting from a minute boundary
+/// @param counter
+/// @param edgesPerMinute Calibrated edges per minute
+inline void generator_counter_reset(GeneratorCounter *counter, uint16_t edgesPerMinute = GENERATOR_EDGES_PER_MINUTE)
+{
+  counter->edgeCount = 0;
+  counter->lastLevel = 0;
+  counter->threshold = edgesPerMinute;
+  counter->minuteTotal = 0;
+}
+
+/// @brief One ULP run: sample the signal, count a rising edge, detect the minute boundary
+/// @param counter
+/// @param level Sampled signal level (0 or 1)
+/// @return true when a minute boundary was crossed (the ULP wakes the main core)
+inline bool generator_counter_sample(GeneratorCounter *counter, uint16_t level)
+{
+  uint16_t edge = (uint16_t)(level - counter->lastLevel);
+  counter->lastLevel = level;
+  if (edge != 1)
+    return false;
+
+  ++counter->edgeCount;
+  if (counter->edgeCount < counter->threshold)
+    return false;
+
+  counter->edgeCount -= counter->threshold;
+  ++counter->minuteTotal;
+  return true;
+}
+
+/// @brief Minutes elapsed since the main core last looked, robust to the ULP counting meanwhile
+/// @param minuteTotal Current ULP minute total
+/// @param minutesConsumed Minute total already shown by the main core (updated)
+/// @return Minutes to add to the displayed time
+inline uint32_t generator_take_minutes(uint16_t minuteTotal, uint16_t *minutesConsumed)
+{
+  uint16_t elapsed = (uint16_t)(minuteTotal - *minutesConsumed);
+  *minutesConsumed = minuteTotal;
+  return elapsed;
+}
+
+/// @brief Generator edges counted since the main core last looked (rate log), from the same ULP snapshot
+/// as generator_take_minutes()
+/// @param minutes Minutes returned by generator_take_minutes() for this snapshot
+/// @param threshold Edges per minute of the ULP
+/// @param edgeCount Current ULP edge count within the minute
+/// @param edgesConsumed Edge count at the last look (updated)
+/// @return Edges counted in between
+inline uint32_t generator_take_edges(uint32_t minutes, uint16_t threshold, uint16_t edgeCount, uint16_t *edgesConsumed)
+{
+  uint32_t edges = minutes * threshold + edgeCount - *edgesConsumed;
+  *edgesConsumed = edgeCount;
+  return edges;
+}
+
+#endif
@@ -0,0 +1,137 @@
+// *****************************************************************************
+// ULP program for the generator time base (TIMEKEEPING_MODE_GENERATOR).
+// Written with the ULP macro assembler (esp32/ulp.h), so no ULP toolchain is needed.
+// Every GENERATOR_ULP_SAMPLE_US the ULP timer starts the program, which runs
+// a few microseconds and halts; the main core stays in deep sleep until a
+// full minute of generator edges has been counted.
+// References:
+// https://docs.espressif.com/projects/esp-idf/en/v4.4/esp32/api-guides/ulp_macros.html
+// *****************************************************************************
+
+#include "watch_config.h"
+
+#if TIMEKEEPING_MODE == TIMEKEEPING_MODE_GENERATOR
+
+#include <Arduino.h>
+#include "esp32/ulp.h"
+#include "driver/rtc_io.h"
+#include "soc/rtc_io_reg.h"
+#include "soc/rtc_cntl_reg.h"
+
+#include "generator_timebase.h"
+#include "generator_ulp.h"
+
+// Data words in RTC slow memory, after the program (same order as GeneratorCounter)
+#define ULP_DATA_OFFSET 64
+enum
+{
+  ULP_EDGE_COUNT,
+  ULP_LAST_LEVEL,
+  ULP_THRESHOLD,
+  ULP_MINUTE_TOTAL,
+  ULP_DATA_WORDS
+};
+
+// The ULP only writes the lower 16 bits of a word
+#define ULP_DATA(index) (RTC_SLOW_MEM[ULP_DATA_OFFSET + (index)] & 0xFFFF)
+
+// Minute total already shown by the main core
+RTC_DATA_ATTR uint16_t generatorMinutesConsumed = 0;
+// Edge count within the minute at the last look of the main core
+RTC_DATA_ATTR uint16_t generatorEdgesConsumed = 0;
+
+enum
+{
+  LBL_DONE,
+};
+
+// Same steps as generator_counter_sample() in generator_timebase.h
+static const ulp_insn_t generatorProgram[] = {
+    // R2 = current level, R3 = data base address
+    I_RD_REG(RTC_GPIO_IN_REG, RTC_GPIO_IN_NEXT_S + GENERATOR_RTC_GPIO, RTC_GPIO_IN_NEXT_S + GENERATOR_RTC_GPIO),
+    I_MOVR(R2, R0),
+    I_MOVI(R3, ULP_DATA_OFFSET),
+
+    // R0 = level - lastLevel: 1 only on a rising edge (0xFFFF on a falling edge)
+    I_LD(R1, R3, ULP_LAST_LEVEL),
+    I_ST(R2, R3, ULP_LAST_LEVEL),
+    I_SUBR(R0, R2, R1),
+    M_BL(LBL_DONE, 1),
+    M_BGE(LBL_DONE, 2),
+
+    // ++edgeCount
+    I_LD(R1, R3, ULP_EDGE_COUNT),
+    I_ADDI(R1, R1, 1),
+    I_ST(R1, R3, ULP_EDGE_COUNT),
+
+    // edgeCount - threshold borrows (overflow flag) while below the threshold
+    I_LD(R2, R3, ULP_THRESHOLD),
+    I_SUBR(R0, R1, R2),
+    M_BXF(LBL_DONE),
+
+    // Minute boundary: keep the extra edges, count the minute and wake the main core
+    I_ST(R0, R3, ULP_EDGE_COUNT),
+    I_LD(R1, R3, ULP_MINUTE_TOTAL),
+    I_ADDI(R1, R1, 1),
+    I_ST(R1, R3, ULP_MINUTE_TOTAL),
+    I_WAKE(),
+
+    M_LABEL(LBL_DONE),
+    I_HALT(),
+};
+
+/// @brief Write the initial counter state to RTC slow memory
+/// @param edgesPerMinute
+static void generator_ulp_write_data(uint16_t edgesPerMinute)
+{
+  GeneratorCounter counter;
+  generator_counter_reset(&counter, edgesPerMinute);
+  RTC_SLOW_MEM[ULP_DATA_OFFSET + ULP_EDGE_COUNT] = counter.edgeCount;
+  RTC_SLOW_MEM[ULP_DATA_OFFSET + ULP_LAST_LEVEL] = counter.lastLevel;
+  RTC_SLOW_MEM[ULP_DATA_OFFSET + ULP_THRESHOLD] = counter.threshold;
+  RTC_SLOW_MEM[ULP_DATA_OFFSET + ULP_MINUTE_TOTAL] = counter.minuteTotal;
+  generatorMinutesConsumed = counter.minuteTotal;
+  generatorEdgesConsumed = counter.edgeCount;
+}
+
+void generator_ulp_start(uint16_t edgesPerMinute)
+{
+  // Generator input: RTC GPIO, no pulls (the comparator drives it)
+  rtc_gpio_init(GENERATOR_GPIO);
+  rtc_gpio_set_direction(GENERATOR_GPIO, RTC_GPIO_MODE_INPUT_ONLY);
+  rtc_gpio_pullup_dis(GENERATOR_GPIO);
+  rtc_gpio_pulldown_dis(GENERATOR_GPIO);
+
+  generator_ulp_write_data(edgesPerMinute);
+
+  size_t programSize = sizeof(generatorProgram) / sizeof(ulp_insn_t);
+  ESP_ERROR_CHECK(ulp_process_macros_and_load(0, generatorProgram, &programSize));
+  assert(programSize <= ULP_DATA_OFFSET);
+
+  ESP_ERROR_CHECK(ulp_set_wakeup_period(0, GENERATOR_ULP_SAMPLE_US));
+  ESP_ERROR_CHECK(ulp_run(0));
+}
+
+void generator_ulp_reset()
+{
+  // Stop the ULP timer while the data words are rewritten, then let it run again
+  CLEAR_PERI_REG_MASK(RTC_CNTL_STATE0_REG, RTC_CNTL_ULP_CP_SLP_TIMER_EN);
+  generator_ulp_write_data(ULP_DATA(ULP_THRESHOLD));
+  SET_PERI_REG_MASK(RTC_CNTL_STATE0_REG, RTC_CNTL_ULP_CP_SLP_TIMER_EN);
+}
+
+uint32_t generator_ulp_take_minutes(uint32_t *edges)
+{
+  // The ULP may cross a minute boundary between the two reads: read again until the minute total holds
+  uint16_t minuteTotal, edgeCount;
+  do
+  {
+    minuteTotal = ULP_DATA(ULP_MINUTE_TOTAL);
+    edgeCount = ULP_DATA(ULP_EDGE_COUNT);
+  } while (minuteTotal != ULP_DATA(ULP_MINUTE_TOTAL));
+  uint32_t minutes = generator_take_minutes(minuteTotal, &generatorMinutesConsumed);
+  *edges = generator_take_edges(minutes, ULP_DATA(ULP_THRESHOLD), edgeCount, &generatorEdgesConsumed);
+  return minutes;
+}
+
+#endif
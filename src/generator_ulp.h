@@ -0,0 +1,23 @@
+// *****************************************************************************
+// ULP program for the generator time base (TIMEKEEPING_MODE_GENERATOR).
+// See generator_timebase.h for the reference model of the counting logic.
+// *****************************************************************************
+
+#ifndef GENERATOR_ULP_H
+#define GENERATOR_ULP_H
+
+#include <stdint.h>
+
+/// @brief Load the ULP program, configure the generator RTC GPIO and start sampling
+/// @param edgesPerMinute Calibrated edges per minute
+void generator_ulp_start(uint16_t edgesPerMinute);
+
+/// @brief Restart the count from a minute boundary (reset to 00:00), without reloading the program
+void generator_ulp_reset();
+
+/// @brief Minutes counted by the ULP since the last call (or the last start or reset)
+/// @param edges Generator edges counted over the same span, for the rate log
+/// @return Minutes to add to the displayed time
+uint32_t generator_ulp_take_minutes(uint32_t *edges);
+
+#endif
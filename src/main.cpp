@@ -20,37 +20,167 @@
 #include <string>
 #include "driver/gpio.h"
 #include "driver/rtc_io.h"
+#include "soc/rtc.h"
+#include "soc/rtc_cntl_reg.h"
+#include "esp32/clk.h"
+#include "esp32/rom/ets_sys.h"
+#include "esp_sleep.h"
+#include "watch_config.h"
 
 // For LCD displays
+#if WATCH_LCD
 #include <LiquidCrystal.h>
+#endif
 
-// For epaper displays
+// For epaper displays (the ESP-IDF build has the black and white display class only)
 #include <GxEPD2_BW.h>
+#if !WATCH_IDF
 #include <GxEPD2_3C.h>
 #include <GxEPD2_7C.h>
+#endif
 #include <Fonts/FreeMonoBold9pt7b.h>
-#include <Fonts/FreeMonoBold12pt7b.h>
 #include <Fonts/FreeMonoBold18pt7b.h>
-#include <Fonts/FreeMonoBold24pt7b.h>
+
+// Watch specific copy of the GxEPD2_154_D67 driver
+#include "GxEPD2_154_D67_Watch.h"
+#include "ssd1681_lut.h"
+
+// Boot profile (boot_profile.h): marks taken by static constructors, which run in definition order within this file
+#include "boot_profile.h"
+BootStamp bootStamps[BOOT_MARK_COUNT];
+struct BootStampTaker
+{
+  BootStampTaker(BootMark mark)
+  {
+    bootStamps[mark].cycles = ESP.getCycleCount();
+    bootStamps[mark].ticks = rtc_time_get();
+  }
+};
+BootStampTaker bootMarkConstructors(BOOT_MARK_CONSTRUCTORS);
 
 // select the display class and display driver class in the following file (new style):
 #include "GxEPD2_display_selection_new_style.h"
+BootStampTaker bootMarkDisplay(BOOT_MARK_DISPLAY);
+
+// Time keeping (watch_config.h above)
+#include "minute_accumulator.h"
+#include "rate_log.h"
+#include "energy_policy.h"
+#include "display_layout.h"
+#include "refresh_scheduler.h"
+#include "frame_diff.h"
+#include "multi_window.h"
+#include "wake_timeline.h"
+#include "spi_trace.h"
+#include "watch_render.h"
+#if TIMEKEEPING_MODE == TIMEKEEPING_MODE_GENERATOR
+#include "generator_ulp.h"
+#endif
+
+// Time font (FONT_SUBSET: only the time glyphs, generated by the tools/font_subset.py build step)
+#if DISPLAY_SEGMENT_FONT
+#include "WatchSegment18pt7b.h"
+#define WATCH_FONT WatchSegment18pt7b
+#elif FONT_SUBSET
+#include "FreeMonoBold18pt7bSubset.h"
+#define WATCH_FONT FreeMonoBold18pt7bSubset
+#else
+#define WATCH_FONT FreeMonoBold18pt7b
+#endif
+
+#if DISPLAY_DIGIT_TILES && !DISPLAY_SEGMENT_RENDER && !DISPLAY_SEGMENT_FONT
+// The tiles are WatchSegment18pt7b digits: with another font the colon and the layout wouldn't match them
+#error "DISPLAY_DIGIT_TILES needs DISPLAY_SEGMENT_FONT (the tiles are drawn from WatchSegment18pt7b)"
+#endif
+#if DISPLAY_DIGIT_TILES_NATIVE
+#include "DigitTilesNative.h"
+#endif
 
 using namespace std;
 
 // Mask for GPIO#32 and GPIO#33 pins, that will wake up ESP32 from deep sleep
 // GPIO#32: minute increment
 // GPIO#33: reset to zero minutes
+// In generator mode the ULP wakes the ESP32 every minute and only GPIO#33 is used
+#if TIMEKEEPING_MODE == TIMEKEEPING_MODE_GENERATOR
+#define BUTTON_PIN_BITMASK 0x200000000
+#else
 #define BUTTON_PIN_BITMASK 0x300000000
+#endif
 
 const int minuteCountStart = ((23 * 60) + 58) - 1;
 
 // Values stored even in deep sleep
 RTC_DATA_ATTR int bootCount = 0;
 RTC_DATA_ATTR int minuteCount = minuteCountStart;
-
+RTC_DATA_ATTR MinuteAccumulator minuteAccumulator = {0};
+RTC_DATA_ATTR uint32_t totalPulses = 0;
+RTC_DATA_ATTR RateLog rateLog = {0};
+RTC_DATA_ATTR EnergyState energyState = {0, UPDATE_POLICY_NORMAL, 0};
+RTC_DATA_ATTR uint8_t powerReserveLevelShown = 0xFF; // 0xFF: not on screen
+RTC_DATA_ATTR DisplayLayout displayLayout = {false};
+RTC_DATA_ATTR int shownHours = -1;   // -1: not on screen
+RTC_DATA_ATTR int shownMinutes = -2; // -1: "--", -2: not on screen
+RTC_DATA_ATTR GhostCounters ghostCounters = {{0}, 0};
+RTC_DATA_ATTR uint16_t cachedTemperature = GxEPD2_154_D67_Watch::SSD1681_TEMPERATURE_INVALID;
+RTC_DATA_ATTR uint32_t minutesSinceTemperature = 0;
+RTC_DATA_ATTR bool panelOldRamSynced = false; // panel RAM survives hibernate
+RTC_DATA_ATTR bool panelWarm = false;         // controller left idle by sleepWarm()
+RTC_DATA_ATTR bool panelPartialLutLoaded = false;
+RTC_DATA_ATTR WakePhaseAverage displayInitCold = {0, 0};
+RTC_DATA_ATTR WakePhaseAverage displayInitWarm = {0, 0};
+RTC_DATA_ATTR WakePhaseAverage hotPathAverage = {0, 0}; // CPU only phases of the wakes that drew (WAKE_HOT_IRAM on or off)
+// Boot profile: the wake stub mark (written before the second stage bootloader), averages over the deep sleep wakes
+RTC_DATA_ATTR uint32_t bootStubTicks[2] = {0, 0}; // low, high word
+RTC_DATA_ATTR uint32_t bootStubCycles = 0;
+RTC_DATA_ATTR bool bootStubRan = false;
+RTC_DATA_ATTR WakePhaseAverage bootAverages[BOOT_PHASE_COUNT];
+
+// Refresh time of the first update of a wake, split by sensed/cached temperature
+struct TemperatureStats
+{
+  uint32_t sensedCount;
+  uint64_t sensedMicros;
+  uint32_t cachedCount;
+  uint64_t cachedMicros;
+};
+RTC_DATA_ATTR TemperatureStats temperatureStats = {0, 0, 0, 0};
+
+// Lowest supply voltage sampled during this wake
+uint16_t supplyMillivoltsMin = 0;
+
+// Where the time of this wake goes
+WakeTimeline wakeTimeline;
+uint32_t renderMicros = 0; // drawing into the frame and canvas buffers, part of the display update phase
+#if SPI_TRACE
+// Display bus trace of the last wake that used the display, printed on the next reset wake
+RTC_DATA_ATTR uint8_t spiTraceBuffer[SPI_TRACE_RTC_SIZE];
+RTC_DATA_ATTR uint32_t spiTraceUsed = 0;
+SpiTrace spiTrace; // not started (no buffer) until the display is used
+#endif
+
+#if WATCH_LCD
 // initialize the LCD library with the numbers of the interface pins
 LiquidCrystal lcd(19, 23, 18, 17, 16, 15);
+#endif
+BootStampTaker bootMarkLcd(BOOT_MARK_LCD);
+
+/// @brief Deep sleep wake stub, run from RTC fast memory right after the ROM bootloader: take the boot profile stub
+/// mark. Flash and IRAM are not there yet: registers and ROM functions only, no 64 bit arithmetic
+extern "C" void RTC_IRAM_ATTR esp_wake_deep_sleep(void)
+{
+  uint32_t cycles;
+  asm volatile("rsr %0, ccount" : "=a"(cycles));
+  SET_PERI_REG_MASK(RTC_CNTL_TIME_UPDATE_REG, RTC_CNTL_TIME_UPDATE);
+  while (GET_PERI_REG_MASK(RTC_CNTL_TIME_UPDATE_REG, RTC_CNTL_TIME_VALID) == 0)
+    ets_delay_us(1);
+  SET_PERI_REG_MASK(RTC_CNTL_INT_CLR_REG, RTC_CNTL_TIME_VALID_INT_CLR);
+  bootStubTicks[0] = READ_PERI_REG(RTC_CNTL_TIME0_REG);
+  bootStubTicks[1] = READ_PERI_REG(RTC_CNTL_TIME1_REG);
+  bootStubCycles = cycles;
+  bootStubRan = true;
+  esp_default_wake_deep_sleep();
+}
 
 /// @brief Method to print the reason by which ESP32 has been awaken from sleep
 void print_wakeup_reason()
@@ -118,13 +248,254 @@ std::string string_format(const std::string fmt, ...)
   return str;
 }
 
+/// @brief Print the boot profile of this wake as BOOT lines (phase, microseconds, average over the deep sleep wakes)
+/// @param setupStamp Counters at setup() entry
+void print_boot_profile(const BootStamp &setupStamp)
+{
+#if WAKE_PROFILE
+  bootStamps[BOOT_MARK_SETUP] = setupStamp;
+  bootStamps[BOOT_MARK_STUB].ticks = ((uint64_t)bootStubTicks[1] << 32) | bootStubTicks[0];
+  bootStamps[BOOT_MARK_STUB].cycles = bootStubCycles;
+  BootProfile profile;
+  Serial.println(WATCH_IDF ? "Boot profile: ESP-IDF build" : "Boot profile: Arduino build");
+  boot_profile_compute(&profile, bootStamps, bootStubRan, esp_clk_slowclk_cal_get(), rtc_clk_xtal_freq_get(), ESP.getCpuFreqMHz());
+  for (uint8_t phase = 0; phase < BOOT_PHASE_COUNT; ++phase)
+  {
+    if (bootStubRan)
+      wake_phase_average_add(&bootAverages[phase], profile.micros[phase]);
+    Serial.printf("BOOT,%s,%u,%u\n", BOOT_PHASE_NAMES[phase], profile.micros[phase], wake_phase_average(&bootAverages[phase]));
+  }
+  Serial.printf("BOOT,total,%u\n", boot_profile_total(&profile));
+#endif
+  bootStubRan = false; // a reset doesn't run the stub
+}
+
+/// @brief Print the rate log as CSV, to be fitted by tools/rate_trim.cpp
+void print_rate_log()
+{
+  // Generator mode logs edges: nominally GENERATOR_EDGES_PER_MINUTE per minute, no trim
+#if TIMEKEEPING_MODE == TIMEKEEPING_MODE_GENERATOR
+  Serial.printf("RATECAL,%u,%d,%d,%d,%d\n", rateLog.slowClockCal, TIMEKEEPING_MODE, GENERATOR_EDGES_PER_MINUTE, 1, 0);
+#else
+  Serial.printf("RATECAL,%u,%d,%d,%d,%d\n", rateLog.slowClockCal, TIMEKEEPING_MODE, PULSES_PER_MINUTE_NUM, PULSES_PER_MINUTE_DEN, RATE_TRIM_PPM);
+#endif
+  for (uint32_t i = 0; i < rateLog.count; ++i)
+  {
+    const RateLogEntry *entry = rate_log_entry(&rateLog, i);
+    Serial.printf("RATELOG,%u,%llu\n", entry->pulses, entry->ticks);
+  }
+}
+
+/// @brief Print the SPI trace of the last wake as hex, to be decoded by tools/spi_trace_analyze.cpp
+void print_spi_trace()
+{
+#if SPI_TRACE
+  for (uint32_t offset = 0; offset < spiTraceUsed; offset += 32)
+  {
+    Serial.printf("SPITRACE,%u,", offset);
+    for (uint32_t i = offset; i < spiTraceUsed && i < offset + 32; ++i)
+      Serial.printf("%02X", spiTraceBuffer[i]);
+    Serial.println();
+  }
+#endif
+}
+
+/// @brief Close a wake phase, in the timeline and in the SPI trace
+/// @param phase
+void mark_phase(WakePhase phase)
+{
+  uint32_t now = micros();
+  wake_timeline_mark(&wakeTimeline, phase, now);
+#if SPI_TRACE
+  spi_trace_phase(&spiTrace, phase, now);
+#endif
+}
+
+/// @brief Sample the supply voltage, keeping the lowest value of this wake. Only while the panel is BUSY: the
+/// energy thresholds (watch_config.h) are for the supply under refresh load
+void sample_supply_voltage()
+{
+  uint16_t millivolts = analogReadMilliVolts(SUPPLY_ADC_PIN) * SUPPLY_DIVIDER_RATIO;
+  if (supplyMillivoltsMin == 0 || millivolts < supplyMillivoltsMin)
+    supplyMillivoltsMin = millivolts;
+}
+
+/// @brief Called by GxEPD2 in place of delay(1) while the panel is BUSY, so sampling adds no latency
+/// @param parameter
+void supply_busy_callback(const void *parameter)
+{
+  // A few samples are enough to see the sag under load, then behave like the default wait
+  static uint8_t samples = 0;
+  if (samples < 8)
+  {
+    sample_supply_voltage();
+    ++samples;
+  }
+  delay(1);
+}
+
+/// @brief Render a region into a canvas and write it to the controller RAM as its own window
+/// @param layout
+/// @param hoursText
+/// @param minutesText
+/// @param powerReserveLevel
+/// @param region
+/// @param inverted
+/// @param again After the update: sync the old RAM (nothing with single RAM write)
+void write_region_window(const DisplayLayout &layout, const String &hoursText, const String &minutesText,
+                         uint8_t powerReserveLevel, uint8_t region, bool inverted, bool again)
+{
+#if DISPLAY_DIGIT_TILES_NATIVE
+  // Hours and minutes straight from the flash tiles, no canvas (the inverted cleanup pass draws on the canvas)
+  DigitTileWrite writes[DIGIT_TILE_NATIVE_WRITES_MAX];
+  uint8_t writeCount = inverted ? 0 : digit_tile_native_plan(digitTilesNative, layout, display.epd2.HEIGHT, region,
+                                                             (region == REGION_HOURS ? hoursText : minutesText).c_str(), writes);
+  for (uint8_t i = 0; i < writeCount; ++i)
+  {
+    const DisplayWindow &write = writes[i].panel;
+    if (again)
+      display.epd2.writeImageBulkAgain(writes[i].data, write.x, write.y, write.w, write.h);
+    else
+      display.epd2.writeImageBulk(writes[i].data, write.x, write.y, write.w, write.h);
+  }
+  if (writeCount)
+    return;
+#endif
+  DisplayWindow panel = display_window_to_panel(region_window(layout, region), display.epd2.HEIGHT);
+  DisplayWindow window = display_window_from_panel(panel, display.epd2.HEIGHT);
+  uint32_t renderStart = micros();
+  GFXcanvas1 canvas(panel.w, panel.h); // native orientation, same bit layout as the controller RAM
+  canvas.setRotation(DISPLAY_ROTATION);
+  canvas.setFont(&WATCH_FONT);
+  canvas.fillScreen(GxEPD_WHITE);
+#if DISPLAY_SEGMENT_RENDER
+  // Time regions straight into the canvas buffer, whole bytes per span
+  if (region != REGION_POWER_RESERVE)
+  {
+    PanelBuffer target = {canvas.getBuffer(), panel, display.epd2.HEIGHT};
+    segment_draw_regions(target, segment_style_config(), layout, hoursText.c_str(), minutesText.c_str(), REGION_BIT(region), inverted);
+  }
+  else
+#elif DISPLAY_DIGIT_TILES
+  // Time regions decoded from the tiles straight into the canvas buffer
+  if (region != REGION_POWER_RESERVE)
+  {
+    PanelBuffer target = {canvas.getBuffer(), panel, display.epd2.HEIGHT};
+    digit_tile_draw_regions(target, digitTiles, layout, hoursText.c_str(), minutesText.c_str(), REGION_BIT(region), inverted);
+  }
+  else
+#endif
+    draw_regions(canvas, layout, hoursText.c_str(), minutesText.c_str(), powerReserveLevel, REGION_BIT(region), inverted, window.x, window.y);
+  renderMicros += micros() - renderStart;
+  if (again)
+    display.epd2.writeImageAgain(canvas.getBuffer(), panel.x, panel.y, panel.w, panel.h);
+  else
+    display.epd2.writeImage(canvas.getBuffer(), panel.x, panel.y, panel.w, panel.h);
+}
+
+/// @brief Update regions as separate RAM windows, with one update over their union or one update each
+/// @param layout
+/// @param hoursText
+/// @param minutesText
+/// @param powerReserveLevel
+/// @param regions
+/// @param count
+/// @param strategy MULTI_WINDOW_WRITE_EACH or MULTI_WINDOW_SEQUENTIAL (see multi_window.h)
+/// @param inverted
+void update_region_windows(const DisplayLayout &layout, const String &hoursText, const String &minutesText, uint8_t powerReserveLevel,
+                           const uint8_t *regions, uint8_t count, MultiWindowStrategy strategy, bool inverted)
+{
+  if (strategy == MULTI_WINDOW_SEQUENTIAL)
+  {
+    for (uint8_t i = 0; i < count; ++i)
+    {
+      DisplayWindow panel = display_window_to_panel(region_window(layout, regions[i]), display.epd2.HEIGHT);
+      write_region_window(layout, hoursText, minutesText, powerReserveLevel, regions[i], inverted, false);
+      display.epd2.refresh(panel.x, panel.y, panel.w, panel.h);
+      write_region_window(layout, hoursText, minutesText, powerReserveLevel, regions[i], inverted, true);
+    }
+    return;
+  }
+
+  DisplayWindow unionPanel = display_window_to_panel(region_window(layout, regions[0]), display.epd2.HEIGHT);
+  for (uint8_t i = 0; i < count; ++i)
+  {
+    unionPanel = display_window_union(unionPanel, display_window_to_panel(region_window(layout, regions[i]), display.epd2.HEIGHT));
+    write_region_window(layout, hoursText, minutesText, powerReserveLevel, regions[i], inverted, false);
+  }
+  display.epd2.refresh(unionPanel.x, unionPanel.y, unionPanel.w, unionPanel.h);
+  for (uint8_t i = 0; i < count; ++i)
+    write_region_window(layout, hoursText, minutesText, powerReserveLevel, regions[i], inverted, true);
+}
+
+/// @brief Put the ESP32 in deep sleep, waiting for the next pulse (never returns)
+void go_to_sleep()
+{
+  // https://docs.espressif.com/projects/esp-idf/en/latest/esp32/api-reference/system/sleep_modes.html
+  // Not tested to check if power consumption decreases or increases
+  // rtc_gpio_isolate(GPIO_NUM_32);
+  // rtc_gpio_isolate(GPIO_NUM_33);
+
+  // Keep the supply voltage for the next wake's update policy (only sampled under load, during BUSY)
+  if (supplyMillivoltsMin > 0)
+    energyState.supplyMillivolts = supplyMillivoltsMin;
+
+  // An idle controller must not see a reset or a chip select while the pins float
+  if (EPD_WARM_SLEEP && panelWarm)
+  {
+    gpio_hold_en(EPD_RST_GPIO);
+    gpio_hold_en(EPD_CS_GPIO);
+    gpio_deep_sleep_hold_en();
+  }
+
+  mark_phase(WAKE_PHASE_SLEEP);
+#if SPI_TRACE
+  if (spiTrace.buffer)
+    spiTraceUsed = spi_trace_end(&spiTrace, micros());
+#endif
+#if WAKE_PROFILE
+  for (uint8_t phase = 0; phase < WAKE_PHASE_COUNT; ++phase)
+    Serial.printf("TIMELINE,%s,%u\n", WAKE_PHASE_NAMES[phase], wakeTimeline.micros[phase]);
+  Serial.printf("TIMELINE,total,%u\n", wake_timeline_total(&wakeTimeline));
+
+  // The CPU only work of the wake (no BUSY, no reset pulse): wakeup, policy, layout, and of the display update the
+  // render (drawing into the buffers) and the controller RAM writes, also printed on their own. WAKE_HOT_IRAM moves
+  // the inner loops of render and RAM write only, the library code in them (GFX text, SPI) stays in flash; flash
+  // both builds and compare their averages
+  if (wakeTimeline.micros[WAKE_PHASE_LAYOUT])
+  {
+    uint32_t ramWriteMicros = display.epd2.ramWriteMicros();
+    uint32_t hotPathMicros = wakeTimeline.micros[WAKE_PHASE_WAKEUP] + wakeTimeline.micros[WAKE_PHASE_POLICY] + wakeTimeline.micros[WAKE_PHASE_LAYOUT] +
+                             renderMicros + ramWriteMicros;
+    wake_phase_average_add(&hotPathAverage, hotPathMicros);
+    Serial.printf("TIMELINE,render,%u\n", renderMicros);
+    Serial.printf("TIMELINE,ram_write,%u\n", ramWriteMicros);
+    Serial.printf("TIMELINE,hot_path,%u\n", hotPathMicros);
+    Serial.println("Hot path (us) average: " + String(wake_phase_average(&hotPathAverage)) + " over " + String(hotPathAverage.count) +
+                   " wakes, in IRAM: " + String(WAKE_HOT_IRAM));
+  }
+#endif
+
+  // Go to sleep now
+  Serial.println("Going to sleep now");
+  esp_deep_sleep_start();
+  Serial.println("This will never be printed");
+}
+
 const char HelloWorld[] = "Hello World!";
 
 void setup()
 {
+  // Timestamp the wake as early as possible, the rate log is only as good as this
+  uint32_t rateLogCycles = ESP.getCycleCount();
+  uint64_t wakeTicks = rtc_time_get();
+  BootStamp setupStamp = {wakeTicks, rateLogCycles};
+  rateLogCycles = ESP.getCycleCount() - rateLogCycles;
+  wake_timeline_start(&wakeTimeline, micros());
 
   Serial.begin(115200);
   // delay(1000); // Take some time to open up the Serial Monitor
+  print_boot_profile(setupStamp);
 
   // Shortcuts
   bool firstBoot = (bootCount == 0);
@@ -149,16 +520,36 @@ void setup()
   // If you were to use ext1, you would use it like
   esp_sleep_enable_ext1_wakeup(BUTTON_PIN_BITMASK, ESP_EXT1_WAKEUP_ANY_HIGH);
 
+#if TIMEKEEPING_MODE == TIMEKEEPING_MODE_GENERATOR
+  // The ULP keeps counting generator edges while the main core sleeps
+  esp_sleep_enable_ulp_wakeup();
+  if (firstBoot)
+    generator_ulp_start(GENERATOR_EDGES_PER_MINUTE);
+#endif
+
   // Print the wakeup reason for ESP32
   print_wakeup_reason();
 
   // Get the pin that woke the board and reset the minute counter, depending on the pin
   int wakeup_pin = get_ext1_wakeup_pin();
   Serial.println("Wakeup pin: " + String(wakeup_pin));
-  if (wakeup_pin == GPIO_NUM_33)
+  bool resetRequested = (wakeup_pin == GPIO_NUM_33);
+#if TIMEKEEPING_MODE == TIMEKEEPING_MODE_GENERATOR
+  uint32_t generatorEdges = 0; // edges the ULP counted since the last wake (rate log)
+#endif
+  if (resetRequested)
   {
+    print_rate_log();
+    print_spi_trace();
     minuteCount = -1;
     fullyInitDisplay = true;
+    minute_accumulator_reset(&minuteAccumulator);
+#if TIMEKEEPING_MODE == TIMEKEEPING_MODE_GENERATOR
+    // The edges up to the reset are real generator time: keep them in the rate log
+    if (!firstBoot)
+      generator_ulp_take_minutes(&generatorEdges);
+    generator_ulp_reset();
+#endif
   }
 
   // **********
@@ -170,20 +561,75 @@ void setup()
   String bootNumberMessage = "Boot number: " + String(bootCount);
   Serial.println(bootNumberMessage);
 
+  // Convert the pulse into elapsed minutes (first boot and reset always show a new minute)
+  uint32_t elapsedMinutes = 1;
+  if (!firstBoot && !resetRequested)
+  {
+#if TIMEKEEPING_MODE == TIMEKEEPING_MODE_GENERATOR
+    elapsedMinutes = generator_ulp_take_minutes(&generatorEdges);
+#else
+    elapsedMinutes = minute_accumulator_add_pulses(&minuteAccumulator, 1);
+#endif
+  }
+  Serial.println("Elapsed minutes: " + String(elapsedMinutes));
+
+  // Log the wake for rate calibration
+#if TIMEKEEPING_MODE == TIMEKEEPING_MODE_GENERATOR
+  uint32_t wakePulses = generatorEdges; // counted edges: none on first boot, the ones before a reset
+#else
+  uint32_t wakePulses = (firstBoot || resetRequested) ? 0 : 1;
+#endif
+  uint32_t rateLogAppendCycles = ESP.getCycleCount();
+  uint32_t previousPulses = totalPulses;
+  totalPulses += wakePulses;
+  if (totalPulses / RATE_LOG_EVERY_PULSES != previousPulses / RATE_LOG_EVERY_PULSES)
+    rate_log_append(&rateLog, totalPulses, wakeTicks);
+  rateLog.slowClockCal = esp_clk_slowclk_cal_get();
+  rateLogCycles += ESP.getCycleCount() - rateLogAppendCycles;
+#if WAKE_PROFILE
+  Serial.println("Rate log cost (us): " + String((float)rateLogCycles / ESP.getCpuFreqMHz()));
+#endif
+
+  mark_phase(WAKE_PHASE_WAKEUP);
+
+  // Nothing changes on screen until a minute boundary is crossed
+  if (elapsedMinutes == 0)
+    go_to_sleep();
+
   // Increment minute counter
-  const int minMinutes = 0;
   const int maxMinutes = 24 * 60;
-  ++minuteCount;
-  if (minuteCount >= maxMinutes)
-    minuteCount = minMinutes;
+  minuteCount = (minuteCount + elapsedMinutes) % maxMinutes;
+
+  // **********
+  // Energy
+  // **********
+
+  // Choose how much work this wake can afford, from the voltage measured during the last refresh
+  UpdatePolicy previousPolicy = (UpdatePolicy)energyState.policy;
+  UpdatePolicy updatePolicy = energy_choose_policy(energyState.supplyMillivolts, previousPolicy);
+  energyState.minutesSinceRefresh += elapsedMinutes;
+  bool refreshDisplay = fullyInitDisplay || energy_should_refresh(updatePolicy, previousPolicy, minuteCount, energyState.minutesSinceRefresh);
+  energyState.policy = updatePolicy;
+  Serial.println("Supply (mV): " + String(energyState.supplyMillivolts) + ", policy: " + String(updatePolicy) + ", refresh? " + String(refreshDisplay));
+
+  if (!refreshDisplay)
+  {
+    // No sample here: unloaded, the supply reads above the BUSY (under load) value the thresholds are set
+    // against, and would flip the policy back to normal; the last refresh's value stays
+    go_to_sleep();
+  }
+  energyState.minutesSinceRefresh = 0;
 
   // Format time for display (hh24:mi) and print it
   int hours = minuteCount / 60;
   int minutes = minuteCount % 60;
 // String time = String(hours) + ":" + String(minutes);
 std:
-  string formattedTimeCpp = string_format("%02d:%02d", hours, minutes);
+  string formattedTimeCpp = (updatePolicy == UPDATE_POLICY_HOURS_ONLY) ? string_format("%02d:--", hours) : string_format("%02d:%02d", hours, minutes);
   String formattedTime = String(formattedTimeCpp.c_str());
+  String hoursText = formattedTime.substring(0, 2);
+  String minutesText = formattedTime.substring(3, 5);
+  int minutesShown = (updatePolicy == UPDATE_POLICY_HOURS_ONLY) ? -1 : minutes; // -1: "--"
   String timeMessage = "Time: " + formattedTime;
   Serial.println(timeMessage);
 
@@ -204,81 +650,263 @@ std:
   // Epaper
   // **********
 
+  // Ghosting: a full refresh when due (at the quiet hour) or a single region cleanup
+  GhostDecision ghostDecision = ghost_schedule(&ghostCounters, minuteCount, updatePolicy == UPDATE_POLICY_NORMAL);
+  bool fullRefresh = fullyInitDisplay || (ghostDecision.action == GHOST_ACTION_FULL_REFRESH);
+
   // Debug
   String fullyInitDisplayMessage = fullyInitDisplay ? "true" : "false";
   fullyInitDisplayMessage = "fullyInitDisplay? " + fullyInitDisplayMessage;
   Serial.println(fullyInitDisplayMessage);
+  Serial.println("Partials since full refresh: " + String(ghostCounters.partialsSinceFull) + ", fullRefresh? " + String(fullRefresh));
 
   // Display initialization and setup
   // display.init(115200); // default 10ms reset pulse, e.g. for bare panels with DESPI-C02
   // display.init(115200, true, 2, false); // USE THIS for Waveshare boards with "clever" reset circuit, 2ms reset pulse
+#if SPI_TRACE
+  spi_trace_begin(&spiTrace, spiTraceBuffer, sizeof(spiTraceBuffer), NULL, 0, micros());
+  display.epd2.setTrace(&spiTrace);
+#endif
+  mark_phase(WAKE_PHASE_POLICY);
+  gpio_hold_dis(EPD_RST_GPIO);
+  gpio_hold_dis(EPD_CS_GPIO);
+  display.epd2.selectPartialWaveform(EPD_FAST_PARTIAL_LUT ? SSD1681_LUT_FAST_PARTIAL : NULL);
+  display.epd2.selectWarmWake(EPD_WARM_SLEEP && panelWarm, panelPartialLutLoaded);
   display.init(115200, fullyInitDisplay, 2, false);
+  uint32_t initDisplayMicros = display.epd2.initDisplayMicros(); // the rest of the init runs lazily in the update
+  Serial.println("Warm wake? " + String(display.epd2.warmWake()) + ", failed? " + String(display.epd2.warmWakeFailed()));
+  // A warm wake that couldn't be verified reset the controller: its RAM no longer holds the shown frame
+  if (display.epd2.warmWakeFailed())
+    fullRefresh = true;
+  display.epd2.setBusyCallback(supply_busy_callback);
+  display.epd2.selectSingleRamWrite(EPD_SINGLE_RAM_WRITE);
+  display.epd2.assumeOldRamSynced(panelOldRamSynced && !fullyInitDisplay && !display.epd2.warmWakeFailed());
+
+  // Temperature: sense it every EPD_TEMPERATURE_CACHE_MINUTES, use the cached value otherwise
+  minutesSinceTemperature += elapsedMinutes;
+  bool senseTemperature = (EPD_TEMPERATURE_CACHE_MINUTES == 0) || fullRefresh ||
+                          (cachedTemperature == GxEPD2_154_D67_Watch::SSD1681_TEMPERATURE_INVALID) ||
+                          (minutesSinceTemperature >= EPD_TEMPERATURE_CACHE_MINUTES);
+  if (senseTemperature)
+    display.epd2.useTemperatureSensor();
+  else
+    display.epd2.setTemperature(cachedTemperature);
   display.firstPage();
   // display.setRotation(1);
   display.setRotation(3);
   // display.setFont(&FreeMonoBold9pt7b);
-  display.setFont(&FreeMonoBold18pt7b);
+  display.setFont(&WATCH_FONT);
   display.setTextColor(GxEPD_BLACK);
+  mark_phase(WAKE_PHASE_DISPLAY_INIT);
+
+  // The layout only depends on the font, compute it once and keep it in RTC memory
+  if (!displayLayout.valid || fullyInitDisplay)
+  {
+    display_layout_measure(display, &WATCH_FONT, &displayLayout);
+  }
+  const DisplayLayout &layout = displayLayout;
+  Serial.println("x: " + String(layout.cursorX) + ", y: " + String(layout.cursorY) + ", advance: " + String(layout.charAdvance));
+
+  // Changed pixel heuristic, from the text still on screen (cached in RTC memory)
+  RefreshMode refreshMode = REFRESH_MODE_FULL;
+  if (!fullRefresh)
+  {
+    uint32_t heuristicCycles = ESP.getCycleCount();
+    std::string previousTime = (shownMinutes < 0) ? string_format("%02d:--", shownHours) : string_format("%02d:%02d", shownHours, shownMinutes);
+    DisplayWindow changeWindow = (hours != shownHours) ? display_window_union(layout.hours, layout.minutes) : layout.minutes;
+#if DISPLAY_SEGMENT_RENDER
+    uint32_t changedPixels = segment_text_flip_count(segment_style_config(), previousTime.c_str(), formattedTime.c_str());
+#elif DISPLAY_DIGIT_TILES
+    uint32_t changedPixels = digit_tile_text_flip_count(digitTiles, previousTime.c_str(), formattedTime.c_str());
+#else
+    uint32_t changedPixels = text_flip_count(&WATCH_FONT, previousTime.c_str(), formattedTime.c_str());
+#endif
+    refreshMode = refresh_choose_mode(changedPixels, (uint32_t)changeWindow.w * changeWindow.h);
+    fullRefresh = (refreshMode == REFRESH_MODE_FULL);
+    heuristicCycles = ESP.getCycleCount() - heuristicCycles;
+#if WAKE_PROFILE
+    Serial.println("Changed pixels: " + String(changedPixels) + " of " + String(changeWindow.w * changeWindow.h) +
+                   ", refresh mode: " + String(refreshMode) + ", heuristic cost (us): " + String((float)heuristicCycles / ESP.getCpuFreqMHz()));
+#endif
+  }
 
-  // With a monospaced font, the text boundaries for 5 chars (hh24:mi) should always be the same
-  int16_t tbx, tby;
-  uint16_t tbw, tbh;
-  display.getTextBounds(formattedTime, 0, 0, &tbx, &tby, &tbw, &tbh);
-  Serial.println("tbx: " + String(tbx) + ", tby: " + String(tby) + ", tbw: " + String(tbw) + ", tbh: " + String(tbh));
-
-  // Center the bounding box by transposition of the origin:
-  uint16_t x = ((display.width() - tbw) / 2) - tbx;
-  uint16_t y = ((display.height() - tbh) / 2) - tby;
-  Serial.println("x: " + String(x) + ", y: " + String(y));
-
-  // Partial window coordinates
-  int16_t pwx, pwy;
-  uint16_t pww, pwh;
-  pwx = x;
-  pwy = y - tbh; // As far as I understand, the y here is the baseline (bottom) of the text, not the top, like the lines on a notebook
-  pww = tbw;
-  pwh = tbh;
-  Serial.println("pwx: " + String(pwx) + ", pwy: " + String(pwy) + ", pww: " + String(pww) + ", pwh: " + String(pwh));
-
-  // Add a safety margin, mainly because of ints rouding down
-  uint16_t safetyMarginInPixelsH = tbw * 0.05;
-  uint16_t safetyMarginInPixelsV = tbh * 0.05;
-  pwx = pwx - safetyMarginInPixelsH;
-  pwy = pwy - safetyMarginInPixelsV;
-  pww = pww + (safetyMarginInPixelsH * 2);
-  pwh = pwh + (safetyMarginInPixelsV * 2);
-  Serial.println("pwx: " + String(pwx) + ", pwy: " + String(pwy) + ", pww: " + String(pww) + ", pwh: " + String(pwh));
-
-  // Guarantee a full update for reset purposes
-  if (fullyInitDisplay)
+  // Only the regions whose text changed are redrawn: minutes every minute, hours at :00, colon never
+  bool hoursDirty = fullRefresh || (hours != shownHours);
+  bool minutesDirty = fullRefresh || (minutesShown != shownMinutes);
+  // Hours and minutes together: one window over both, or separate RAM windows, whichever is cheaper
+  MultiWindowStrategy multiWindow = MULTI_WINDOW_UNION;
+  const uint8_t timeRegions[] = {REGION_HOURS, REGION_MINUTES};
+  if (!fullRefresh && hoursDirty && minutesDirty)
+  {
+    DisplayWindow panelWindows[] = {display_window_to_panel(layout.hours, display.epd2.HEIGHT),
+                                    display_window_to_panel(layout.minutes, display.epd2.HEIGHT)};
+    MultiWindowPlan plan;
+    multi_window_plan(&plan, panelWindows, 2, EPD_SINGLE_RAM_WRITE ? 1 : 3);
+    multiWindow = plan.strategy;
+#if WAKE_PROFILE
+    Serial.println("Multi window cost (us) union: " + String(plan.costMicros[MULTI_WINDOW_UNION]) +
+                   ", write each: " + String(plan.costMicros[MULTI_WINDOW_WRITE_EACH]) +
+                   ", sequential: " + String(plan.costMicros[MULTI_WINDOW_SEQUENTIAL]) + ", strategy: " + String(multiWindow));
+#endif
+  }
+  // A window over hours and minutes also covers the colon, which then must be drawn again (same pixels)
+  bool colonDirty = fullRefresh || (hoursDirty && minutesDirty && multiWindow == MULTI_WINDOW_UNION);
+
+  // The power reserve level only changes when the supply gets half a step past the level shown
+  uint8_t powerReserveLevel = power_reserve_level(energyState.supplyMillivolts, powerReserveLevelShown);
+  bool drawPowerReserve = POWER_RESERVE_INDICATOR && (fullRefresh || powerReserveLevel != powerReserveLevelShown);
+
+  uint8_t regionMask = (hoursDirty ? REGION_BIT(REGION_HOURS) : 0) |
+                       (colonDirty ? REGION_BIT(REGION_COLON) : 0) |
+                       (minutesDirty ? REGION_BIT(REGION_MINUTES) : 0) |
+                       ((fullRefresh && drawPowerReserve) ? REGION_BIT(REGION_POWER_RESERVE) : 0);
+
+  DisplayWindow window = layout.minutes;
+  if (hoursDirty && minutesDirty)
+    window = display_window_union(layout.hours, layout.minutes);
+  else if (hoursDirty)
+    window = layout.hours;
+
+  // Guarantee a full update for reset (and ghosting cleanup) purposes
+  if (fullRefresh)
     display.setFullWindow();
   else
-    display.setPartialWindow(pwx, pwy, pww, pwh);
+    display.setPartialWindow(window.x, window.y, window.w, window.h);
+  Serial.println("pwx: " + String(window.x) + ", pwy: " + String(window.y) + ", pww: " + String(window.w) + ", pwh: " + String(window.h));
 
-  // Update the display
-  display.firstPage();
-  do
+  mark_phase(WAKE_PHASE_LAYOUT);
+
+  // Update the display (twice, inverted first, when many pixels flip and need cleaning)
+  if (regionMask != 0)
+  {
+    int passes = (refreshMode == REFRESH_MODE_PARTIAL_CLEAN) ? 2 : 1;
+    for (int pass = 0; pass < passes; ++pass)
+    {
+      if (multiWindow != MULTI_WINDOW_UNION)
+      {
+        update_region_windows(layout, hoursText, minutesText, powerReserveLevel, timeRegions, 2, multiWindow, pass < passes - 1);
+        continue;
+      }
+      display.firstPage();
+      do
+      {
+        // display.fillScreen(GxEPD_WHITE);
+        uint32_t renderStart = micros();
+        draw_regions(display, layout, hoursText.c_str(), minutesText.c_str(), powerReserveLevel, regionMask, pass < passes - 1);
+        renderMicros += micros() - renderStart;
+      } while (display.nextPage());
+    }
+    shownHours = hours;
+    shownMinutes = minutesShown;
+    if (fullRefresh)
+      ghost_full_refreshed(&ghostCounters);
+    else if (refreshMode == REFRESH_MODE_PARTIAL_CLEAN)
+    {
+      for (uint8_t region = 0; region < REGION_COUNT; ++region)
+        if (regionMask & REGION_BIT(region))
+          ghost_region_cleaned(&ghostCounters, region);
+    }
+    else
+      ghost_count_partial(&ghostCounters, regionMask);
+
+    uint32_t updateMicros = display.epd2.lastUpdateMicros();
+    if (senseTemperature)
+    {
+      temperatureStats.sensedCount++;
+      temperatureStats.sensedMicros += updateMicros;
+    }
+    else
+    {
+      temperatureStats.cachedCount++;
+      temperatureStats.cachedMicros += updateMicros;
+    }
+  }
+
+  // Only update sequences with the OTP waveform read the sensor
+  if (senseTemperature && EPD_TEMPERATURE_CACHE_MINUTES != 0 && regionMask != 0 && (fullRefresh || !EPD_FAST_PARTIAL_LUT))
+  {
+    uint16_t temperature = display.epd2.readTemperature();
+    if (temperature != GxEPD2_154_D67_Watch::SSD1681_TEMPERATURE_INVALID)
+    {
+      cachedTemperature = temperature;
+      minutesSinceTemperature = 0;
+    }
+    Serial.println("Temperature (1/16 C): " + String(temperature));
+  }
+#if WAKE_PROFILE
+  if (temperatureStats.sensedCount && temperatureStats.cachedCount)
+  {
+    // Refreshes of different modes and windows mix here, so this is an average over the usage pattern
+    uint32_t sensedAverage = temperatureStats.sensedMicros / temperatureStats.sensedCount;
+    uint32_t cachedAverage = temperatureStats.cachedMicros / temperatureStats.cachedCount;
+    Serial.println("Refresh (us) sensed: " + String(sensedAverage) + " x" + String(temperatureStats.sensedCount) +
+                   ", cached: " + String(cachedAverage) + " x" + String(temperatureStats.cachedCount) +
+                   ", saved: " + String((int32_t)(sensedAverage - cachedAverage)));
+  }
+#endif
+
+  // Power reserve in its own partial window, so the common wake sends nothing extra
+  if (!fullRefresh && drawPowerReserve)
+  {
+    display.setPartialWindow(powerReserveX, powerReserveY, powerReserveW, powerReserveH);
+    display.firstPage();
+    do
+    {
+      uint32_t renderStart = micros();
+      draw_regions(display, layout, hoursText.c_str(), minutesText.c_str(), powerReserveLevel, REGION_BIT(REGION_POWER_RESERVE), false);
+      renderMicros += micros() - renderStart;
+    } while (display.nextPage());
+    ghost_count_partial(&ghostCounters, REGION_BIT(REGION_POWER_RESERVE));
+  }
+  if (drawPowerReserve)
+    powerReserveLevelShown = powerReserveLevel;
+
+  // Ghosting cleanup of one region: drive all its pixels inverted, then back to normal
+  if (!fullRefresh && ghostDecision.action == GHOST_ACTION_CLEAN_REGION)
   {
-    // display.fillScreen(GxEPD_WHITE);
-    display.setCursor(x, y);
-    display.print(formattedTime);
-  } while (display.nextPage());
+    Serial.println("Ghosting cleanup of region " + String(ghostDecision.region));
+    DisplayWindow cleanupWindow = region_window(layout, ghostDecision.region);
+    display.setPartialWindow(cleanupWindow.x, cleanupWindow.y, cleanupWindow.w, cleanupWindow.h);
+    for (int pass = 0; pass < 2; ++pass)
+    {
+      display.firstPage();
+      do
+      {
+        uint32_t renderStart = micros();
+        draw_regions(display, layout, hoursText.c_str(), minutesText.c_str(), powerReserveLevelShown, REGION_BIT(ghostDecision.region), pass == 0);
+        renderMicros += micros() - renderStart;
+      } while (display.nextPage());
+    }
+    ghost_region_cleaned(&ghostCounters, ghostDecision.region);
+  }
 
-  display.hibernate();
+  mark_phase(WAKE_PHASE_DISPLAY_UPDATE);
+  wake_timeline_move(&wakeTimeline, WAKE_PHASE_DISPLAY_UPDATE, WAKE_PHASE_DISPLAY_INIT, display.epd2.initDisplayMicros() - initDisplayMicros);
+#if WAKE_PROFILE
+  uint32_t displayInitMicros = wakeTimeline.micros[WAKE_PHASE_DISPLAY_INIT];
+  wake_phase_average_add(display.epd2.warmWake() ? &displayInitWarm : &displayInitCold, displayInitMicros);
+  if (displayInitCold.count && displayInitWarm.count)
+    Serial.println("Display init (us) cold: " + String(wake_phase_average(&displayInitCold)) +
+                   ", warm: " + String(wake_phase_average(&displayInitWarm)) +
+                   ", saved: " + String((int32_t)(wake_phase_average(&displayInitCold) - wake_phase_average(&displayInitWarm))));
+#endif
+
+  panelOldRamSynced = display.epd2.oldRamSynced();
+  panelPartialLutLoaded = display.epd2.partialLutLoaded();
+#if WAKE_PROFILE
+  Serial.println("Panel RAM bytes written: " + String(display.epd2.ramBytesWritten()));
+#endif
+  if (EPD_WARM_SLEEP)
+    display.epd2.sleepWarm();
+  else
+    display.hibernate();
+  panelWarm = EPD_WARM_SLEEP;
 
   // **********
   // Sleep
   // **********
 
-  // https://docs.espressif.com/projects/esp-idf/en/latest/esp32/api-reference/system/sleep_modes.html
-  // Not tested to check if power consumption decreases or increases
-  // rtc_gpio_isolate(GPIO_NUM_32);
-  // rtc_gpio_isolate(GPIO_NUM_33);
-
-  // Go to sleep now
-  Serial.println("Going to sleep now");
-  esp_deep_sleep_start();
-  Serial.println("This will never be printed");
+  go_to_sleep();
 }
 
 void loop()
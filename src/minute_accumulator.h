@@ -0,0 +1,60 @@
+// *****************************************************************************
+// Fractional pulse to minute accumulator.
+// The movement fires PULSES_PER_MINUTE_NUM / PULSES_PER_MINUTE_DEN pulses per
+// minute, so one pulse is worth DEN / NUM minutes. Instead of floating point,
+// a Bresenham style accumulator keeps the remainder as an integer: every pulse
+// adds "step" and every time "threshold" is crossed a whole minute elapses.
+// No rounding error is ever thrown away, so there is no long run drift.
+// RATE_TRIM_PPM regulates the watch: it scales the time counted per pulse.
+// Plain C++ (no Arduino), so it can also be compiled by the host tools.
+// *****************************************************************************
+
+#ifndef MINUTE_ACCUMULATOR_H
+#define MINUTE_ACCUMULATOR_H
+
+#include <stdint.h>
+
+#include "watch_config.h"
+
+// Accumulator units per pulse and per minute for the configured ratio and rate trim
+#define MINUTE_ACCUMULATOR_STEP ((uint64_t)PULSES_PER_MINUTE_DEN * (uint64_t)(1000000 + RATE_TRIM_PPM))
+#define MINUTE_ACCUMULATOR_THRESHOLD ((uint64_t)PULSES_PER_MINUTE_NUM * 1000000ull)
+
+static_assert(RATE_TRIM_PPM > -1000000, "RATE_TRIM_PPM out of range");
+
+/// @brief Fraction of a minute already counted but not yet shown. Kept in RTC memory.
+struct MinuteAccumulator
+{
+  uint64_t remainder; // Always < threshold
+};
+
+/// @brief Forget any partial minute, e.g. when the watch is reset to 00:00
+/// @param accumulator
+inline void minute_accumulator_reset(MinuteAccumulator *accumulator)
+{
+  accumulator->remainder = 0;
+}
+
+/// @brief Add pulses to the accumulator and return how many whole minutes elapsed
+/// @param accumulator
+/// @param pulses Number of pulses since the last call (usually 1, one per wake up)
+/// @param step Accumulator units per pulse
+/// @param threshold Accumulator units per minute
+/// @return Whole minutes elapsed, 0 when the pulse did not cross a minute boundary
+inline uint32_t minute_accumulator_add_pulses(MinuteAccumulator *accumulator, uint32_t pulses,
+                                              uint64_t step = MINUTE_ACCUMULATOR_STEP,
+                                              uint64_t threshold = MINUTE_ACCUMULATOR_THRESHOLD)
+{
+  accumulator->remainder += step * pulses;
+
+  // Usually at most one iteration, but a low ratio (e.g. 1 pulse / 2 minutes) gives more
+  uint32_t minutes = 0;
+  while (accumulator->remainder >= threshold)
+  {
+    accumulator->remainder -= threshold;
+    ++minutes;
+  }
+  return minutes;
+}
+
+#endif
@@ -0,0 +1,108 @@
+// *****************************************************************************
+// Several dirty windows in one wake (e.g. hours and minutes, without the
+// colon between them): compare the ways of sending them to the panel.
+// - MULTI_WINDOW_UNION: one partial window over their union (what
+//   setPartialWindow() does), the gaps are sent too
+// - MULTI_WINDOW_WRITE_EACH: each window written to the controller RAM on its
+//   own, then one update over the union; the gaps hold the same frame in both
+//   RAMs, so the differential update leaves them alone
+// - MULTI_WINDOW_SEQUENTIAL: write and update each window in turn
+// The refresh time does not depend on the window size (the controller scans
+// the whole panel), so the costs differ by the RAM bytes and update count.
+// Windows are in panel coordinates, x byte aligned (see display_window_to_panel).
+// Plain C++ (no Arduino), shared with the host tools.
+// *****************************************************************************
+
+#ifndef MULTI_WINDOW_H
+#define MULTI_WINDOW_H
+
+#include <stdint.h>
+
+#include "watch_config.h"
+#include "display_layout.h"
+
+// Command and data bytes to set a RAM window and its address counter, plus the write RAM command
+#define MULTI_WINDOW_SETUP_BYTES 16
+
+#define MULTI_WINDOW_MAX 8
+
+enum MultiWindowStrategy
+{
+  MULTI_WINDOW_UNION,
+  MULTI_WINDOW_WRITE_EACH,
+  MULTI_WINDOW_SEQUENTIAL,
+  MULTI_WINDOW_STRATEGY_COUNT,
+};
+
+/// @brief Cost of each strategy for a set of windows, and the cheapest
+struct MultiWindowPlan
+{
+  MultiWindowStrategy strategy;
+  DisplayWindow unionWindow;
+  uint32_t ramBytes[MULTI_WINDOW_STRATEGY_COUNT];
+  uint8_t updates[MULTI_WINDOW_STRATEGY_COUNT];
+  uint32_t costMicros[MULTI_WINDOW_STRATEGY_COUNT];
+};
+
+/// @brief Panel window of a rotated (DISPLAY_ROTATION 3) window, x widened to byte boundaries
+/// @param window Rotated coordinates
+/// @param panelHeight Native panel height
+/// @return
+inline DisplayWindow display_window_to_panel(const DisplayWindow &window, uint16_t panelHeight)
+{
+  // Rotation 3: panel x = y, panel y = panelHeight - 1 - x
+  int16_t x0 = window.y & ~7;
+  int16_t x1 = (window.y + window.h + 7) & ~7;
+  DisplayWindow panel = {x0, (int16_t)(panelHeight - window.x - window.w), (uint16_t)(x1 - x0), window.w};
+  return panel;
+}
+
+/// @brief Rotated window covering a panel window, inverse of display_window_to_panel
+/// @param panel
+/// @param panelHeight
+/// @return
+inline DisplayWindow display_window_from_panel(const DisplayWindow &panel, uint16_t panelHeight)
+{
+  DisplayWindow window = {(int16_t)(panelHeight - panel.y - panel.h), panel.x, panel.h, panel.w};
+  return window;
+}
+
+/// @brief Controller RAM bytes of a byte aligned panel window
+inline uint32_t multi_window_bytes(const DisplayWindow &panel)
+{
+  return (uint32_t)(panel.w / 8) * panel.h;
+}
+
+/// @brief Cost of the strategies for a dirty set
+/// @param plan
+/// @param panelWindows Byte aligned, not overlapping
+/// @param count 1 to MULTI_WINDOW_MAX
+/// @param ramWrites Times each window goes to the RAM: 3 with GxEPD2's old RAM sync, 1 with single RAM write
+inline void multi_window_plan(MultiWindowPlan *plan, const DisplayWindow *panelWindows, uint8_t count, uint8_t ramWrites)
+{
+  plan->unionWindow = panelWindows[0];
+  uint32_t eachBytes = 0;
+  for (uint8_t i = 0; i < count; ++i)
+  {
+    plan->unionWindow = display_window_union(plan->unionWindow, panelWindows[i]);
+    eachBytes += multi_window_bytes(panelWindows[i]) * ramWrites + MULTI_WINDOW_SETUP_BYTES * ramWrites;
+  }
+
+  // Every update sets its window once more
+  plan->ramBytes[MULTI_WINDOW_UNION] = (multi_window_bytes(plan->unionWindow) + MULTI_WINDOW_SETUP_BYTES) * ramWrites + MULTI_WINDOW_SETUP_BYTES;
+  plan->updates[MULTI_WINDOW_UNION] = 1;
+  plan->ramBytes[MULTI_WINDOW_WRITE_EACH] = eachBytes + MULTI_WINDOW_SETUP_BYTES;
+  plan->updates[MULTI_WINDOW_WRITE_EACH] = 1;
+  plan->ramBytes[MULTI_WINDOW_SEQUENTIAL] = eachBytes + MULTI_WINDOW_SETUP_BYTES * count;
+  plan->updates[MULTI_WINDOW_SEQUENTIAL] = count;
+
+  plan->strategy = MULTI_WINDOW_UNION;
+  for (uint8_t s = 0; s < MULTI_WINDOW_STRATEGY_COUNT; ++s)
+  {
+    plan->costMicros[s] = plan->ramBytes[s] * REFRESH_COST_SPI_BYTE_NS / 1000 + plan->updates[s] * REFRESH_COST_PARTIAL_MS * 1000UL;
+    if (plan->costMicros[s] < plan->costMicros[plan->strategy])
+      plan->strategy = (MultiWindowStrategy)s;
+  }
+}
+
+#endif
@@ -0,0 +1,58 @@
+// *****************************************************************************
+// Rate log: ring buffer in RTC memory with the RTC slow clock time of the
+// wakes, used to compare the mechanical pulse rate against the ESP32 clock.
+// Dumped over Serial on a GPIO#33 reset, then fitted on the PC by
+// tools/rate_trim.cpp, which prints the RATE_TRIM_PPM for watch_config.h.
+// Appending is a handful of stores, the timestamp read is the only real cost.
+// Plain C++ (no Arduino).
+// *****************************************************************************
+
+#ifndef RATE_LOG_H
+#define RATE_LOG_H
+
+#include <stdint.h>
+
+#include "watch_config.h"
+
+/// @brief One logged wake
+struct RateLogEntry
+{
+  uint32_t pulses;     // Total pulses (or generator edges) counted so far
+  uint32_t reserved;   // Keeps ticks 8 byte aligned
+  uint64_t ticks;      // RTC slow clock ticks at wake
+};
+
+/// @brief Ring buffer of the last RATE_LOG_SIZE logged wakes
+struct RateLog
+{
+  uint32_t next;         // Index of the next entry to write
+  uint32_t count;        // Valid entries, up to RATE_LOG_SIZE
+  uint32_t slowClockCal; // Microseconds per slow clock tick, Q13.19 fixed point (esp_clk_slowclk_cal_get)
+  RateLogEntry entries[RATE_LOG_SIZE];
+};
+
+/// @brief Add an entry, overwriting the oldest one when full
+/// @param log
+/// @param pulses
+/// @param ticks
+inline void rate_log_append(RateLog *log, uint32_t pulses, uint64_t ticks)
+{
+  RateLogEntry *entry = &log->entries[log->next];
+  entry->pulses = pulses;
+  entry->ticks = ticks;
+  log->next = (log->next + 1) % RATE_LOG_SIZE;
+  if (log->count < RATE_LOG_SIZE)
+    ++log->count;
+}
+
+/// @brief Entry by age
+/// @param log
+/// @param index 0 is the oldest entry, count - 1 the newest
+/// @return
+inline const RateLogEntry *rate_log_entry(const RateLog *log, uint32_t index)
+{
+  uint32_t oldest = (log->next + RATE_LOG_SIZE - log->count) % RATE_LOG_SIZE;
+  return &log->entries[(oldest + index) % RATE_LOG_SIZE];
+}
+
+#endif
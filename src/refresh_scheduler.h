@@ -0,0 +1,116 @@
+// *****************************************************************************
+// Ghosting aware refresh scheduler.
+// Every partial refresh leaves a little ghosting in the area it drives. Per
+// region counters in RTC memory track how many partial refreshes each area
+// has had, and the scheduler decides when to clean up:
+// - region cleanup: that region alone is refreshed inverted and then normal,
+//   driving all its pixels through both transitions (two small partial
+//   refreshes, far cheaper than a full refresh with its flashing)
+// - full refresh: after many partial refreshes in total, at the quiet hour
+//   (GHOST_QUIET_HOUR, when nobody is looking at the watch)
+// Both wait for the normal energy policy, unless the hard limit (twice the
+// threshold) is reached.
+// Plain C++ (no Arduino).
+// *****************************************************************************
+
+#ifndef REFRESH_SCHEDULER_H
+#define REFRESH_SCHEDULER_H
+
+#include <stdint.h>
+
+#include "watch_config.h"
+
+// Display regions, also used as bit masks
+enum DisplayRegion
+{
+  REGION_HOURS = 0,
+  REGION_COLON = 1,
+  REGION_MINUTES = 2,
+  REGION_POWER_RESERVE = 3,
+  REGION_COUNT = 4,
+};
+#define REGION_BIT(region) (1u << (region))
+
+enum GhostAction
+{
+  GHOST_ACTION_NONE,
+  GHOST_ACTION_CLEAN_REGION,
+  GHOST_ACTION_FULL_REFRESH,
+};
+
+/// @brief What the scheduler wants done this wake
+struct GhostDecision
+{
+  GhostAction action;
+  uint8_t region; // For GHOST_ACTION_CLEAN_REGION
+};
+
+/// @brief Partial refresh counters, kept in RTC memory
+struct GhostCounters
+{
+  uint16_t regionPartials[REGION_COUNT]; // Since the region was last cleaned
+  uint32_t partialsSinceFull;            // Since the last full refresh
+};
+
+/// @brief Count one partial refresh over the regions in the mask
+/// @param counters
+/// @param regionMask REGION_BIT() of each region inside the refreshed window
+inline void ghost_count_partial(GhostCounters *counters, uint8_t regionMask)
+{
+  for (uint8_t region = 0; region < REGION_COUNT; ++region)
+    if ((regionMask & REGION_BIT(region)) && counters->regionPartials[region] < 0xFFFF)
+      ++counters->regionPartials[region];
+  ++counters->partialsSinceFull;
+}
+
+/// @brief A region was cleaned up
+/// @param counters
+/// @param region
+inline void ghost_region_cleaned(GhostCounters *counters, uint8_t region)
+{
+  counters->regionPartials[region] = 0;
+}
+
+/// @brief A full refresh cleans everything
+/// @param counters
+inline void ghost_full_refreshed(GhostCounters *counters)
+{
+  for (uint8_t region = 0; region < REGION_COUNT; ++region)
+    counters->regionPartials[region] = 0;
+  counters->partialsSinceFull = 0;
+}
+
+/// @brief Decide the cleanup for this wake
+/// @param counters
+/// @param minuteCount Minutes since 00:00
+/// @param energyPlentiful Whether the energy policy is normal
+/// @return
+inline GhostDecision ghost_schedule(const GhostCounters *counters, int minuteCount, bool energyPlentiful)
+{
+  GhostDecision decision = {GHOST_ACTION_NONE, 0};
+
+  // Full refresh: at the quiet hour once due, or as soon as possible when long overdue
+  bool quietHour = (minuteCount / 60) == GHOST_QUIET_HOUR;
+  if (counters->partialsSinceFull >= 2u * GHOST_FULL_REFRESH_THRESHOLD ||
+      (counters->partialsSinceFull >= GHOST_FULL_REFRESH_THRESHOLD && quietHour && energyPlentiful))
+  {
+    decision.action = GHOST_ACTION_FULL_REFRESH;
+    return decision;
+  }
+
+  // Region cleanup: the most refreshed region, if due
+  uint8_t worst = 0;
+  for (uint8_t region = 1; region < REGION_COUNT; ++region)
+    if (counters->regionPartials[region] > counters->regionPartials[worst])
+      worst = region;
+  uint16_t partials = counters->regionPartials[worst];
+  if (partials >= 2u * GHOST_REGION_CLEANUP_THRESHOLD ||
+      (partials >= GHOST_REGION_CLEANUP_THRESHOLD && energyPlentiful))
+  {
+    decision.action = GHOST_ACTION_CLEAN_REGION;
+    decision.region = worst;
+  }
+  return decision;
+}
+
+#endif
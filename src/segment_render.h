@@ -0,0 +1,323 @@
+// *****************************************************************************
+// Seven segment time renderer: digits drawn as filled rectangles instead of
+// glyph bitmaps, at any size up to the panel (SEGMENT_DIGIT_W/H, stroke and
+// advance in watch_config.h), with no font data (10 bytes of segment masks).
+// Into a buffer in the controller RAM layout (GFXcanvas1 in native
+// orientation, 1 = white, MSB first) each rectangle becomes horizontal span
+// fills of whole bytes (masked at both ends), instead of a drawPixel() per
+// pixel as with glyphs; through Adafruit GFX it is a fillRect() per segment.
+// Same shapes as WatchSegment18pt7b (tools/segment_font_gen.cpp), pixel for
+// pixel at the default size, and the same layout (display_layout.h) and
+// changed pixel heuristic (frame_diff.h) as the fonts, computed from the
+// rectangles. tools/segment_render_bench.cpp compares it with display.print().
+// Plain C++ (no Arduino), shared with the host tools.
+// *****************************************************************************
+
+#ifndef SEGMENT_RENDER_H
+#define SEGMENT_RENDER_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include "watch_config.h"
+#include "display_layout.h"
+#include "refresh_scheduler.h"
+
+// Segments: a top, b top right, c bottom right, d bottom, e bottom left, f top left, g middle
+#define SEGMENT_A (1 << 0)
+#define SEGMENT_B (1 << 1)
+#define SEGMENT_C (1 << 2)
+#define SEGMENT_D (1 << 3)
+#define SEGMENT_E (1 << 4)
+#define SEGMENT_F (1 << 5)
+#define SEGMENT_G (1 << 6)
+#define SEGMENT_COLON (1 << 7) // Two dots, not a segment
+
+// Rectangles of one character at most (seven segments)
+#define SEGMENT_RECTS_MAX 7
+
+// Digits 0 to 9, with the 6 top bar, 7 left bar and 9 bottom bar (fewest flips, see segment_font_gen.cpp)
+static const uint8_t SEGMENT_DIGITS[10] = {
+    SEGMENT_A | SEGMENT_B | SEGMENT_C | SEGMENT_D | SEGMENT_E | SEGMENT_F,
+    SEGMENT_B | SEGMENT_C,
+    SEGMENT_A | SEGMENT_B | SEGMENT_G | SEGMENT_E | SEGMENT_D,
+    SEGMENT_A | SEGMENT_B | SEGMENT_G | SEGMENT_C | SEGMENT_D,
+    SEGMENT_F | SEGMENT_G | SEGMENT_B | SEGMENT_C,
+    SEGMENT_A | SEGMENT_F | SEGMENT_G | SEGMENT_C | SEGMENT_D,
+    SEGMENT_A | SEGMENT_F | SEGMENT_G | SEGMENT_C | SEGMENT_D | SEGMENT_E,
+    SEGMENT_A | SEGMENT_B | SEGMENT_C | SEGMENT_F,
+    SEGMENT_A | SEGMENT_B | SEGMENT_C | SEGMENT_D | SEGMENT_E | SEGMENT_F | SEGMENT_G,
+    SEGMENT_A | SEGMENT_B | SEGMENT_C | SEGMENT_D | SEGMENT_F | SEGMENT_G,
+};
+
+/// @brief Size of the characters: digit box, bar thickness and monospaced cell width
+struct SegmentStyle
+{
+  uint16_t digitW, digitH;
+  uint16_t stroke;
+  uint16_t advance;
+};
+
+/// @brief Style from watch_config.h
+/// @return
+inline SegmentStyle segment_style_config()
+{
+  SegmentStyle style = {SEGMENT_DIGIT_W, SEGMENT_DIGIT_H, SEGMENT_STROKE, SEGMENT_ADVANCE};
+  return style;
+}
+
+/// @brief Segments of a character, 0 for the ones not drawn (they only advance the cursor)
+/// @param c
+/// @return
+inline uint8_t segment_char_mask(char c)
+{
+  if (c >= '0' && c <= '9')
+    return SEGMENT_DIGITS[c - '0'];
+  if (c == '-')
+    return SEGMENT_G;
+  if (c == ':')
+    return SEGMENT_COLON;
+  return 0;
+}
+
+/// @brief Rectangles of a character, rotated coordinates
+/// @param style
+/// @param c
+/// @param cursorX, cursorY Cursor (baseline), as for a font: the digit box ends on the baseline
+/// @param rects SEGMENT_RECTS_MAX entries
+/// @return Number of rectangles
+inline uint8_t segment_char_rects(const SegmentStyle &style, char c, int16_t cursorX, int16_t cursorY, DisplayWindow *rects)
+{
+  const uint8_t mask = segment_char_mask(c);
+  const int16_t x = cursorX + (style.advance - style.digitW) / 2;
+  const int16_t y = cursorY - (style.digitH - 1);
+  const uint16_t w = style.digitW, h = style.digitH, s = style.stroke;
+  const uint16_t middle = (h - s) / 2;
+  uint8_t count = 0;
+  if (mask & SEGMENT_COLON)
+  {
+    const int16_t dotX = x + (w - s) / 2;
+    DisplayWindow top = {dotX, (int16_t)(y + middle / 2), s, s};
+    DisplayWindow bottom = {dotX, (int16_t)(y + h - s - middle / 2), s, s};
+    rects[count++] = top;
+    rects[count++] = bottom;
+    return count;
+  }
+  // Vertical bars own the corners, horizontal bars fill in between
+  const DisplayWindow segments[7] = {
+      {(int16_t)(x + s), y, (uint16_t)(w - 2 * s), s},                        // a
+      {(int16_t)(x + w - s), y, s, (uint16_t)(middle + s)},                   // b
+      {(int16_t)(x + w - s), (int16_t)(y + middle), s, (uint16_t)(h - middle)}, // c
+      {(int16_t)(x + s), (int16_t)(y + h - s), (uint16_t)(w - 2 * s), s},     // d
+      {x, (int16_t)(y + middle), s, (uint16_t)(h - middle)},                  // e
+      {x, y, s, (uint16_t)(middle + s)},                                      // f
+      {(int16_t)(x + s), (int16_t)(y + middle), (uint16_t)(w - 2 * s), s},    // g
+  };
+  for (uint8_t i = 0; i < 7; ++i)
+    if (mask & (1 << i))
+      rects[count++] = segments[i];
+  return count;
+}
+
+/// @brief Text bounds, as Adafruit GFX getTextBounds() at cursor (0, 0)
+/// @param style
+/// @param text
+/// @param x1, y1, w, h
+inline void segment_text_bounds(const SegmentStyle &style, const char *text, int16_t *x1, int16_t *y1, uint16_t *w, uint16_t *h)
+{
+  int16_t minX = 0x7FFF, minY = 0x7FFF, maxX = -1, maxY = -1;
+  int16_t cursorX = 0;
+  DisplayWindow rects[SEGMENT_RECTS_MAX];
+  for (; *text; ++text, cursorX += style.advance)
+  {
+    uint8_t count = segment_char_rects(style, *text, cursorX, 0, rects);
+    for (uint8_t i = 0; i < count; ++i)
+    {
+      minX = rects[i].x < minX ? rects[i].x : minX;
+      minY = rects[i].y < minY ? rects[i].y : minY;
+      maxX = (rects[i].x + rects[i].w - 1) > maxX ? (rects[i].x + rects[i].w - 1) : maxX;
+      maxY = (rects[i].y + rects[i].h - 1) > maxY ? (rects[i].y + rects[i].h - 1) : maxY;
+    }
+  }
+  *x1 = maxX >= minX ? minX : 0;
+  *y1 = maxY >= minY ? minY : 0;
+  *w = maxX >= minX ? maxX - minX + 1 : 0;
+  *h = maxY >= minY ? maxY - minY + 1 : 0;
+}
+
+/// @brief Compute the layout for a style, centered on the display (display_layout_measure() for fonts)
+/// @param style
+/// @param displayWidth, displayHeight Rotated display size
+/// @param layout
+inline void segment_layout_compute(const SegmentStyle &style, uint16_t displayWidth, uint16_t displayHeight, DisplayLayout *layout)
+{
+  int16_t tbx, tby;
+  uint16_t tbw, tbh;
+  segment_text_bounds(style, DISPLAY_REFERENCE_TIME, &tbx, &tby, &tbw, &tbh);
+  display_layout_compute(layout, tbx, tby, tbw, tbh, style.advance, displayWidth, displayHeight);
+}
+
+/// @brief Pixels that flip when character a is replaced by character b in the same cell
+/// Computed on the grid of the rectangle edges (a few dozen cells), whatever the size
+/// @param style
+/// @param a
+/// @param b
+/// @return
+inline uint32_t WATCH_HOT segment_flip_count(const SegmentStyle &style, char a, char b)
+{
+  if (a == b)
+    return 0;
+  DisplayWindow rects[2 * SEGMENT_RECTS_MAX];
+  uint8_t countA = segment_char_rects(style, a, 0, 0, rects);
+  uint8_t count = countA + segment_char_rects(style, b, 0, 0, rects + countA);
+
+  // Edges, sorted (insertion sort, 28 values at most)
+  int16_t xs[4 * SEGMENT_RECTS_MAX], ys[4 * SEGMENT_RECTS_MAX];
+  uint8_t edges = 0;
+  for (uint8_t i = 0; i < count; ++i)
+  {
+    xs[edges] = rects[i].x;
+    ys[edges++] = rects[i].y;
+    xs[edges] = rects[i].x + rects[i].w;
+    ys[edges++] = rects[i].y + rects[i].h;
+  }
+  for (uint8_t i = 1; i < edges; ++i)
+    for (uint8_t j = i; j > 0 && xs[j - 1] > xs[j]; --j)
+    {
+      int16_t t = xs[j];
+      xs[j] = xs[j - 1];
+      xs[j - 1] = t;
+    }
+  for (uint8_t i = 1; i < edges; ++i)
+    for (uint8_t j = i; j > 0 && ys[j - 1] > ys[j]; --j)
+    {
+      int16_t t = ys[j];
+      ys[j] = ys[j - 1];
+      ys[j - 1] = t;
+    }
+
+  // Each grid cell is covered by a, by b, by both or by none
+  uint32_t flips = 0;
+  for (uint8_t yi = 0; yi + 1 < edges; ++yi)
+  {
+    if (ys[yi] == ys[yi + 1])
+      continue;
+    for (uint8_t xi = 0; xi + 1 < edges; ++xi)
+    {
+      if (xs[xi] == xs[xi + 1])
+        continue;
+      bool inA = false, inB = false;
+      for (uint8_t i = 0; i < count; ++i)
+      {
+        bool inside = xs[xi] >= rects[i].x && xs[xi] < rects[i].x + rects[i].w && ys[yi] >= rects[i].y && ys[yi] < rects[i].y + rects[i].h;
+        if (inside && i < countA)
+          inA = true;
+        else if (inside)
+          inB = true;
+      }
+      if (inA != inB)
+        flips += (uint32_t)(xs[xi + 1] - xs[xi]) * (ys[yi + 1] - ys[yi]);
+    }
+  }
+  return flips;
+}
+
+/// @brief Pixels that flip between two texts of the same length (text_flip_count() for fonts)
+/// @param style
+/// @param previous
+/// @param next
+/// @return
+inline uint32_t segment_text_flip_count(const SegmentStyle &style, const char *previous, const char *next)
+{
+  uint32_t flips = 0;
+  for (; *previous && *next; ++previous, ++next)
+    flips += segment_flip_count(style, *previous, *next);
+  return flips;
+}
+
+/// @brief Set bits x0 to x1 - 1 of a row, whole bytes in the middle
+/// @param row
+/// @param x0
+/// @param x1
+/// @param white
+inline void segment_fill_span(uint8_t *row, int16_t x0, int16_t x1, bool white)
+{
+  int16_t first = x0 / 8, last = (x1 - 1) / 8;
+  uint8_t firstMask = 0xFF >> (x0 % 8);
+  uint8_t lastMask = 0xFF << (7 - (x1 - 1) % 8);
+  if (first == last)
+    firstMask &= lastMask;
+  if (white)
+    row[first] |= firstMask;
+  else
+    row[first] &= ~firstMask;
+  if (first == last)
+    return;
+  if (last > first + 1)
+    memset(row + first + 1, white ? 0xFF : 0x00, last - first - 1);
+  if (white)
+    row[last] |= lastMask;
+  else
+    row[last] &= ~lastMask;
+}
+
+/// @brief Fill a rectangle, rotated (rotation 3) coordinates, clipped to the buffer
+/// @param target
+/// @param rect
+/// @param white
+inline void WATCH_HOT segment_fill_rect(const PanelBuffer &target, const DisplayWindow &rect, bool white)
+{
+  // Rotation 3: panel x = y, panel y = HEIGHT - 1 - x
+  int16_t x0 = rect.y - target.panel.x;
+  int16_t x1 = x0 + rect.h;
+  int16_t y0 = (int16_t)target.displayHeight - rect.x - rect.w - target.panel.y;
+  int16_t y1 = y0 + rect.w;
+  x0 = x0 < 0 ? 0 : x0;
+  y0 = y0 < 0 ? 0 : y0;
+  x1 = x1 > (int16_t)target.panel.w ? target.panel.w : x1;
+  y1 = y1 > (int16_t)target.panel.h ? target.panel.h : y1;
+  if (x0 >= x1 || y0 >= y1)
+    return;
+  const uint16_t pitch = (target.panel.w + 7) / 8;
+  for (int16_t y = y0; y < y1; ++y)
+    segment_fill_span(target.buffer + y * pitch, x0, x1, white);
+}
+
+/// @brief Draw a text at the cursor (baseline)
+/// @param target
+/// @param style
+/// @param text
+/// @param cursorX, cursorY Rotated coordinates
+/// @param white Color of the segments
+inline void segment_draw_text(const PanelBuffer &target, const SegmentStyle &style, const char *text, int16_t cursorX, int16_t cursorY, bool white)
+{
+  DisplayWindow rects[SEGMENT_RECTS_MAX];
+  for (; *text; ++text, cursorX += style.advance)
+  {
+    uint8_t count = segment_char_rects(style, *text, cursorX, cursorY, rects);
+    for (uint8_t i = 0; i < count; ++i)
+      segment_fill_rect(target, rects[i], white);
+  }
+}
+
+/// @brief Draw the time regions in the mask (draw_regions() for a buffer), the buffer cleared first
+/// @param target
+/// @param style
+/// @param layout
+/// @param hoursText
+/// @param minutesText
+/// @param regionMask REGION_BIT() of the regions to draw, the power reserve is not drawn here
+/// @param inverted White on black, used by the ghosting cleanup
+inline void segment_draw_regions(const PanelBuffer &target, const SegmentStyle &style, const DisplayLayout &layout,
+                                 const char *hoursText, const char *minutesText, uint8_t regionMask, bool inverted)
+{
+  memset(target.buffer, inverted ? 0x00 : 0xFF, ((target.panel.w + 7) / 8) * target.panel.h);
+  if (regionMask & REGION_BIT(REGION_HOURS))
+    segment_draw_text(target, style, hoursText, layout.cursorX, layout.cursorY, inverted);
+  if (regionMask & REGION_BIT(REGION_COLON))
+    segment_draw_text(target, style, ":", layout.cursorX + 2 * layout.charAdvance, layout.cursorY, inverted);
+  if (regionMask & REGION_BIT(REGION_MINUTES))
+    segment_draw_text(target, style, minutesText, layout.cursorX + 3 * layout.charAdvance, layout.cursorY, inverted);
+}
+
+#endif
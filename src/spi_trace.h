@@ -0,0 +1,204 @@
+// *****************************************************************************
+// SPI trace: what the display driver sends the panel during a wake, as a
+// compact binary record of commands, data, reset and BUSY edges, wake phases
+// and time, decoded on the PC by tools/spi_trace_analyze.cpp.
+// Recorded by GxEPD2_154_D67_Watch (SPI_TRACE 1) at its transfer primitives,
+// i.e. at the DC/CS level: a command is a byte sent with DC low, data bytes
+// with DC high; the two bytes of the temperature read (0x1B) are its data. On the ESP32 the buffer is in RTC memory and only the first
+// SPI_TRACE_DATA_STORED bytes of a data run are kept (the rest are counted and
+// summed); on the host the buffer is a file sized one and everything is kept.
+// Format: "ST", version, then records, each a tag byte (type in bits 7..5,
+// argument in bits 4..0) followed by its payload:
+// - COMMAND: command byte
+// - DATA: varint length, varint stored, stored bytes, sum of all bytes (16 bit)
+// - PIN: argument = pin << 1 | level (SPI_TRACE_PIN_*); for BUSY, 1 when the
+//   driver starts waiting and 0 when BUSY is released
+// - TIME: varint microseconds since the previous TIME (emitted before a record
+//   other than data when at least SPI_TRACE_TIME_RESOLUTION_US have passed)
+// - PHASE: argument = WakePhase that ends, like wake_timeline_mark(): the
+//   records since the previous PHASE belong to it
+// - END: the buffer was full, records after this point were dropped
+// Plain C++ (no Arduino), the caller passes the time.
+// *****************************************************************************
+
+#ifndef SPI_TRACE_H
+#define SPI_TRACE_H
+
+#include <stdint.h>
+
+#include "watch_config.h"
+
+#define SPI_TRACE_VERSION 1
+#define SPI_TRACE_HEADER_SIZE 3
+#define SPI_TRACE_TIME_RESOLUTION_US 20
+
+enum SpiTraceRecord
+{
+  SPI_TRACE_COMMAND = 0,
+  SPI_TRACE_DATA = 1,
+  SPI_TRACE_PIN = 2,
+  SPI_TRACE_TIME = 3,
+  SPI_TRACE_PHASE = 4,
+  SPI_TRACE_END = 7,
+};
+
+enum SpiTracePin
+{
+  SPI_TRACE_PIN_RST = 0,
+  SPI_TRACE_PIN_BUSY = 1,
+};
+
+/// @brief Recorder state, the records go to buffer
+struct SpiTrace
+{
+  uint8_t *buffer;
+  uint32_t size;
+  uint32_t used;
+  uint32_t storedMax;  // Data bytes kept per run
+  uint32_t lastTime;
+  uint32_t bytes;      // Bus bytes recorded (commands and data), also those dropped when full
+  bool full;
+  // Data run in progress
+  uint32_t runLength;
+  uint16_t runSum;
+  uint8_t run[SPI_TRACE_DATA_STORED];
+  uint8_t *runLarge;   // Host: a buffer of storedMax bytes, else NULL and run[] is used
+};
+
+/// @brief Room for the record, marking the end of the trace if there is none
+inline bool spi_trace_reserve(SpiTrace *trace, uint32_t bytes)
+{
+  if (trace->full || trace->buffer == NULL) // full, or not started
+    return false;
+  if (trace->used + bytes + 1 > trace->size) // keep one byte for END
+  {
+    trace->buffer[trace->used++] = SPI_TRACE_END << 5;
+    trace->full = true;
+    return false;
+  }
+  return true;
+}
+
+inline void spi_trace_varint(SpiTrace *trace, uint32_t value)
+{
+  do
+  {
+    uint8_t byte = value & 0x7F;
+    value >>= 7;
+    trace->buffer[trace->used++] = byte | (value ? 0x80 : 0);
+  } while (value);
+}
+
+/// @brief Close the data run in progress
+inline void spi_trace_flush(SpiTrace *trace)
+{
+  if (trace->runLength == 0)
+    return;
+  uint32_t stored = trace->runLength < trace->storedMax ? trace->runLength : trace->storedMax;
+  if (spi_trace_reserve(trace, 1 + 5 + 5 + stored + 2))
+  {
+    const uint8_t *run = trace->runLarge ? trace->runLarge : trace->run;
+    trace->buffer[trace->used++] = SPI_TRACE_DATA << 5;
+    spi_trace_varint(trace, trace->runLength);
+    spi_trace_varint(trace, stored);
+    for (uint32_t i = 0; i < stored; ++i)
+      trace->buffer[trace->used++] = run[i];
+    trace->buffer[trace->used++] = trace->runSum & 0xFF;
+    trace->buffer[trace->used++] = trace->runSum >> 8;
+  }
+  trace->runLength = 0;
+  trace->runSum = 0;
+}
+
+/// @brief Time record, if enough time has passed
+inline void spi_trace_time(SpiTrace *trace, uint32_t now)
+{
+  uint32_t delta = now - trace->lastTime;
+  if (delta < SPI_TRACE_TIME_RESOLUTION_US)
+    return;
+  spi_trace_flush(trace);
+  if (!spi_trace_reserve(trace, 1 + 5))
+    return;
+  trace->buffer[trace->used++] = SPI_TRACE_TIME << 5;
+  spi_trace_varint(trace, delta);
+  trace->lastTime = now;
+}
+
+/// @brief Start a trace (one wake) in a buffer
+/// @param trace
+/// @param buffer
+/// @param size
+/// @param runLarge NULL to keep SPI_TRACE_DATA_STORED bytes per data run, or a buffer of storedMax bytes
+/// @param storedMax
+/// @param now
+inline void spi_trace_begin(SpiTrace *trace, uint8_t *buffer, uint32_t size, uint8_t *runLarge, uint32_t storedMax, uint32_t now)
+{
+  trace->buffer = buffer;
+  trace->size = size;
+  trace->used = 0;
+  trace->runLarge = runLarge;
+  trace->storedMax = runLarge ? storedMax : SPI_TRACE_DATA_STORED;
+  trace->lastTime = now;
+  trace->bytes = 0;
+  trace->full = false;
+  trace->runLength = 0;
+  trace->runSum = 0;
+  if (size < SPI_TRACE_HEADER_SIZE + 1)
+  {
+    trace->full = true;
+    return;
+  }
+  buffer[trace->used++] = 'S';
+  buffer[trace->used++] = 'T';
+  buffer[trace->used++] = SPI_TRACE_VERSION;
+}
+
+inline void spi_trace_command(SpiTrace *trace, uint8_t command, uint32_t now)
+{
+  trace->bytes++;
+  spi_trace_time(trace, now);
+  spi_trace_flush(trace);
+  if (!spi_trace_reserve(trace, 2))
+    return;
+  trace->buffer[trace->used++] = SPI_TRACE_COMMAND << 5;
+  trace->buffer[trace->used++] = command;
+}
+
+/// @brief Data byte, added to the run in progress (the run's time is recorded by the next record)
+inline void spi_trace_data(SpiTrace *trace, uint8_t data)
+{
+  if (trace->runLength < trace->storedMax)
+    (trace->runLarge ? trace->runLarge : trace->run)[trace->runLength] = data;
+  trace->runLength++;
+  trace->runSum += data;
+  trace->bytes++;
+}
+
+inline void spi_trace_pin(SpiTrace *trace, SpiTracePin pin, uint8_t level, uint32_t now)
+{
+  spi_trace_time(trace, now);
+  spi_trace_flush(trace);
+  if (!spi_trace_reserve(trace, 1))
+    return;
+  trace->buffer[trace->used++] = (SPI_TRACE_PIN << 5) | (pin << 1) | (level ? 1 : 0);
+}
+
+inline void spi_trace_phase(SpiTrace *trace, uint8_t phase, uint32_t now)
+{
+  spi_trace_time(trace, now);
+  spi_trace_flush(trace);
+  if (!spi_trace_reserve(trace, 1))
+    return;
+  trace->buffer[trace->used++] = (SPI_TRACE_PHASE << 5) | (phase & 0x1F);
+}
+
+/// @brief Close the trace
+/// @return Bytes used
+inline uint32_t spi_trace_end(SpiTrace *trace, uint32_t now)
+{
+  spi_trace_time(trace, now);
+  spi_trace_flush(trace);
+  return trace->used;
+}
+
+#endif
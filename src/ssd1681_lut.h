@@ -0,0 +1,136 @@
+// *****************************************************************************
+// Waveform look up tables for the SSD1681 (GDEH0154D67, HINK-E154A07-A1).
+// Layout, 159 bytes:
+// - [0, 60): VS, voltage source of LUT0..LUT4, 12 groups each, one byte per
+//   group with phases A, B, C, D in 2 bits each (A in bits 7..6):
+//   00 VSS, 01 VSH1, 10 VSL, 11 VSH2
+//   In display mode 2 the LUT of a pixel is chosen by (old, new) RAM bits:
+//   LUT0 black->black, LUT1 black->white, LUT2 white->black, LUT3 white->white
+// - [60, 144): 12 groups of TPA, TPB, SRAB, TPC, TPD, SRCD, RP (frames, repeats)
+// - [144, 150): FR, frame rate, one nibble per group (even group in the high nibble)
+// - [150, 153): XON, gate scan selection
+// - [153, 159): EOPT (0x3F), VGH (0x03), VSH1, VSH2, VSL (0x04), VCOM (0x2C)
+// The first 153 bytes go with command 0x32, the rest with the commands above.
+// Decoded and timed on the PC by tools/lut_inspect.cpp.
+// *****************************************************************************
+
+#ifndef SSD1681_LUT_H
+#define SSD1681_LUT_H
+
+#include <stdint.h>
+
+#define SSD1681_LUT_SIZE 153
+#define SSD1681_LUT_FULL_SIZE 159
+#define SSD1681_LUT_GROUPS 12
+#define SSD1681_LUT_COUNT 5
+
+// Frame rate of an FR nibble (assumed 25 Hz steps, check the datasheet revision of the panel)
+#define SSD1681_FRAME_HZ(fr) (25.0f * ((fr) + 1))
+
+/// @brief Decoded duration of a waveform
+struct Ssd1681LutTiming
+{
+  uint32_t frames;                        // Total frames, with repeats
+  uint32_t phases;                        // Phases with a non zero duration
+  uint32_t drivenFrames[SSD1681_LUT_COUNT]; // Frames each LUT drives a voltage other than VSS
+  float milliseconds;                     // Estimated duration of the drive sequence
+};
+
+/// @brief Voltage source of a LUT in a group and phase
+/// @param lut
+/// @param lutIndex 0 to 4
+/// @param group 0 to 11
+/// @param phase 0 (A) to 3 (D)
+/// @return 0 VSS, 1 VSH1, 2 VSL, 3 VSH2
+inline uint8_t ssd1681_lut_voltage(const uint8_t *lut, uint8_t lutIndex, uint8_t group, uint8_t phase)
+{
+  return (lut[lutIndex * SSD1681_LUT_GROUPS + group] >> (6 - 2 * phase)) & 0x03;
+}
+
+/// @brief Decode the timing of a waveform
+/// @param lut At least SSD1681_LUT_SIZE bytes
+/// @return
+inline Ssd1681LutTiming ssd1681_lut_timing(const uint8_t *lut)
+{
+  Ssd1681LutTiming timing = {0, 0, {0}, 0.0f};
+  for (uint8_t group = 0; group < SSD1681_LUT_GROUPS; ++group)
+  {
+    const uint8_t *tp = &lut[60 + group * 7]; // TPA, TPB, SRAB, TPC, TPD, SRCD, RP
+    const uint8_t phaseFrames[4] = {tp[0], tp[1], tp[3], tp[4]};
+    const uint8_t phaseRepeats[4] = {tp[2], tp[2], tp[5], tp[5]};
+    uint8_t fr = lut[144 + group / 2];
+    fr = (group % 2 == 0) ? (fr >> 4) : (fr & 0x0F);
+
+    uint32_t groupFrames = 0;
+    for (uint8_t phase = 0; phase < 4; ++phase)
+    {
+      if (phaseFrames[phase] == 0)
+        continue;
+      uint32_t frames = (uint32_t)phaseFrames[phase] * (phaseRepeats[phase] + 1) * (tp[6] + 1);
+      ++timing.phases;
+      groupFrames += frames;
+      for (uint8_t lutIndex = 0; lutIndex < SSD1681_LUT_COUNT; ++lutIndex)
+        if (ssd1681_lut_voltage(lut, lutIndex, group, phase) != 0)
+          timing.drivenFrames[lutIndex] += frames;
+    }
+    timing.frames += groupFrames;
+    timing.milliseconds += groupFrames * 1000.0f / SSD1681_FRAME_HZ(fr);
+  }
+  return timing;
+}
+
+// Partial waveform as found in the panel vendor demo code, for comparison only
+// (the firmware uses the one in OTP unless a custom LUT is selected)
+const uint8_t SSD1681_LUT_REFERENCE_PARTIAL[SSD1681_LUT_FULL_SIZE] = {
+    0x00, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // LUT0 B->B
+    0x80, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // LUT1 B->W
+    0x40, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // LUT2 W->B
+    0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // LUT3 W->W
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // LUT4
+    0x0F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,                               // Group 0
+    0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,                               // Group 1
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x22, 0x22, 0x22, 0x22, 0x22, 0x22, // FR
+    0x00, 0x00, 0x00,                   // XON
+    0x02, 0x17, 0x41, 0xB0, 0x32, 0x28, // EOPT, VGH, VSH1, VSH2, VSL, VCOM
+};
+
+// Tuned fast partial waveform for the black on white digits:
+// - pixels that do not change (LUT0, LUT3) are not driven at all
+// - the main drive phase is 10 frames instead of 15, the short settling
+//   group is kept
+// Shorter drive leaves a little more ghosting, which the ghosting scheduler
+// (refresh_scheduler.h) cleans up
+const uint8_t SSD1681_LUT_FAST_PARTIAL[SSD1681_LUT_FULL_SIZE] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // LUT0 B->B
+    0x80, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // LUT1 B->W
+    0x40, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // LUT2 W->B
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // LUT3 W->W
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // LUT4
+    0x0A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,                               // Group 0
+    0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,                               // Group 1
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x22, 0x22, 0x22, 0x22, 0x22, 0x22, // FR
+    0x00, 0x00, 0x00,                   // XON
+    0x02, 0x17, 0x41, 0xB0, 0x32, 0x28, // EOPT, VGH, VSH1, VSH2, VSL, VCOM
+};
+
+#endif
@@ -0,0 +1,100 @@
+// *****************************************************************************
+// Wake timeline: microseconds spent in each phase of a wake, from the app
+// startup to deep sleep, printed over Serial as TIMELINE lines before sleeping
+// (WAKE_PROFILE, watch_config.h).
+// Phases are closed in order by wake_timeline_mark(), each one gets the time
+// since the previous mark, so the marks cost a timer read each.
+// Running averages of a phase, kept in RTC memory, compare two variants of it
+// across wakes (e.g. warm and cold display init).
+// Plain C++ (no Arduino), the caller passes the time.
+// *****************************************************************************
+
+#ifndef WAKE_TIMELINE_H
+#define WAKE_TIMELINE_H
+
+#include <stdint.h>
+
+enum WakePhase
+{
+  WAKE_PHASE_BOOT,           // Timer start (app startup) to setup(): core init, constructors
+  WAKE_PHASE_WAKEUP,         // Wake sources, wake reason, minute counting, rate log
+  WAKE_PHASE_POLICY,         // Energy policy, text, ghosting decision
+  WAKE_PHASE_DISPLAY_INIT,   // display.init() and the controller (re)initialization
+  WAKE_PHASE_LAYOUT,         // Layout, changed pixel heuristic, window planning
+  WAKE_PHASE_DISPLAY_UPDATE, // Drawing, SPI writes and refreshes (BUSY)
+  WAKE_PHASE_SLEEP,          // Panel sleep, up to deep sleep
+  WAKE_PHASE_COUNT,
+};
+
+static const char *const WAKE_PHASE_NAMES[WAKE_PHASE_COUNT] = {"boot", "wakeup", "policy", "display_init", "layout", "display_update", "sleep"};
+
+struct WakeTimeline
+{
+  uint32_t last; // Time of the last mark
+  uint32_t micros[WAKE_PHASE_COUNT];
+};
+
+/// @brief Running average of a phase over many wakes
+struct WakePhaseAverage
+{
+  uint32_t count;
+  uint64_t micros;
+};
+
+/// @brief Start the timeline at setup() entry, the time before is the boot phase
+/// @param timeline
+/// @param now Microseconds since app startup (micros())
+inline void wake_timeline_start(WakeTimeline *timeline, uint32_t now)
+{
+  for (uint8_t phase = 0; phase < WAKE_PHASE_COUNT; ++phase)
+    timeline->micros[phase] = 0;
+  timeline->micros[WAKE_PHASE_BOOT] = now;
+  timeline->last = now;
+}
+
+/// @brief Close a phase: the time since the previous mark is added to it
+/// @param timeline
+/// @param phase
+/// @param now
+inline void wake_timeline_mark(WakeTimeline *timeline, WakePhase phase, uint32_t now)
+{
+  timeline->micros[phase] += now - timeline->last;
+  timeline->last = now;
+}
+
+/// @brief Move time measured inside a phase to another one (e.g. lazy controller init during the update)
+/// @param timeline
+/// @param from
+/// @param to
+/// @param micros
+inline void wake_timeline_move(WakeTimeline *timeline, WakePhase from, WakePhase to, uint32_t micros)
+{
+  if (micros > timeline->micros[from])
+    micros = timeline->micros[from];
+  timeline->micros[from] -= micros;
+  timeline->micros[to] += micros;
+}
+
+/// @brief Total wake time so far
+inline uint32_t wake_timeline_total(const WakeTimeline *timeline)
+{
+  uint32_t total = 0;
+  for (uint8_t phase = 0; phase < WAKE_PHASE_COUNT; ++phase)
+    total += timeline->micros[phase];
+  return total;
+}
+
+/// @brief Add a sample to a running average
+inline void wake_phase_average_add(WakePhaseAverage *average, uint32_t micros)
+{
+  average->count++;
+  average->micros += micros;
+}
+
+/// @brief Average of the samples, 0 without samples
+inline uint32_t wake_phase_average(const WakePhaseAverage *average)
+{
+  return average->count ? (uint32_t)(average->micros / average->count) : 0;
+}
+
+#endif
@@ -0,0 +1,317 @@
+// *****************************************************************************
+// Compile time configuration for the mechanical watch epaper display.
+// Values here describe the mechanical side (pulse generator) and the enabled
+// firmware features. Change them here, not in main.cpp.
+// *****************************************************************************
+
+#ifndef WATCH_CONFIG_H
+#define WATCH_CONFIG_H
+
+// **********
+// Time base
+// **********
+
+// How the watch knows that a minute has elapsed:
+// - TIMEKEEPING_MODE_PULSE: the movement fires pulses on GPIO#32, each one wakes
+//   the ESP32 and is converted to minutes by the pulse accumulator (see below)
+// - TIMEKEEPING_MODE_GENERATOR: Spring Drive style, the ULP counts the high
+//   frequency pulses of the generator coil on an RTC GPIO and wakes the ESP32
+//   only when a calibrated number of pulses (one minute) has been counted
+#define TIMEKEEPING_MODE_PULSE 0
+#define TIMEKEEPING_MODE_GENERATOR 1
+#ifndef TIMEKEEPING_MODE
+#define TIMEKEEPING_MODE TIMEKEEPING_MODE_PULSE
+#endif
+
+// **********
+// Pulses
+// **********
+
+// Number of GPIO#32 pulses the movement generates per minute, as the rational
+// number PULSES_PER_MINUTE_NUM / PULSES_PER_MINUTE_DEN.
+// Examples:
+// - 1 / 1: one pulse per minute (original prototype)
+// - 4 / 1: one pulse every 15 seconds (cheaper, more frequent pulses)
+// - 1 / 2: one pulse every 2 minutes (fewer, higher energy pulses)
+// - 7 / 5: odd gear ratios work too, without drift
+#ifndef PULSES_PER_MINUTE_NUM
+#define PULSES_PER_MINUTE_NUM 1
+#endif
+#ifndef PULSES_PER_MINUTE_DEN
+#define PULSES_PER_MINUTE_DEN 1
+#endif
+
+// Electronic regulation, in parts per million of the time counted per pulse.
+// Negative when the movement runs fast (gains), positive when it runs slow.
+// Measure it with the rate log below and tools/rate_trim.cpp.
+#ifndef RATE_TRIM_PPM
+#define RATE_TRIM_PPM 0
+#endif
+
+// **********
+// Rate log
+// **********
+
+// Entries in the RTC memory ring buffer (16 bytes each)
+#ifndef RATE_LOG_SIZE
+#define RATE_LOG_SIZE 64
+#endif
+
+// Log one wake every N pulses, so the buffer covers a longer period (in pulse mode,
+// with one pulse per minute, 64 entries every 60 pulses cover ~2.7 days)
+#ifndef RATE_LOG_EVERY_PULSES
+#define RATE_LOG_EVERY_PULSES 1
+#endif
+
+// **********
+// Energy
+// **********
+
+// Supply (storage capacitor) voltage, through a resistor divider, on GPIO#35 (ADC1)
+#define SUPPLY_ADC_PIN 35
+#define SUPPLY_DIVIDER_RATIO 2
+
+// Update policy thresholds (see energy_policy.h), measured under load during BUSY
+#ifndef ENERGY_DEGRADED_BELOW_MV
+#define ENERGY_DEGRADED_BELOW_MV 3000
+#endif
+#ifndef ENERGY_HOURS_ONLY_BELOW_MV
+#define ENERGY_HOURS_ONLY_BELOW_MV 2800
+#endif
+#ifndef ENERGY_HYSTERESIS_MV
+#define ENERGY_HYSTERESIS_MV 50
+#endif
+
+// Refresh period in the degraded policy
+#ifndef ENERGY_DEGRADED_EVERY_MINUTES
+#define ENERGY_DEGRADED_EVERY_MINUTES 5
+#endif
+
+// Power reserve indicator: a small bar below the time, redrawn (in its own
+// partial window) only when its level changes. 1 to enable
+#ifndef POWER_RESERVE_INDICATOR
+#define POWER_RESERVE_INDICATOR 0
+#endif
+
+// Number of bar segments, and the supply voltage shown as a full bar
+// (the empty bar is the hours only threshold)
+#define POWER_RESERVE_LEVELS 5
+#ifndef POWER_RESERVE_FULL_MV
+#define POWER_RESERVE_FULL_MV 3300
+#endif
+
+// Time digits in the seven segment font WatchSegment18pt7b (same metrics as FreeMonoBold18pt7b),
+// shaped so few pixels flip per minute change: 157776 a day, 405 at worst in a minute (tools/glyph_flip_score.cpp,
+// which records the FreeMonoBold18pt7b figures next to these). 1 to enable
+#ifndef DISPLAY_SEGMENT_FONT
+#define DISPLAY_SEGMENT_FONT 0
+#endif
+
+// Time drawn with FreeMonoBold18pt7bSubset, the time glyphs of FreeMonoBold18pt7b only. Set
+// by the tools/font_subset.py build step (platformio.ini) once the library is installed
+#ifndef FONT_SUBSET
+#define FONT_SUBSET 0
+#endif
+
+// Time drawn by the seven segment renderer (segment_render.h) instead of a font: filled
+// rectangles, whole bytes per span in RAM windows, no font data. 1 to enable
+#ifndef DISPLAY_SEGMENT_RENDER
+#define DISPLAY_SEGMENT_RENDER 0
+#endif
+// Its size, in pixels: digit box, bar thickness and cell width. "hh:mm" takes 4 cells
+// and a digit, keep that within the 200 pixel panel (larger sizes are clipped). The
+// defaults draw the shapes of WatchSegment18pt7b
+#ifndef SEGMENT_DIGIT_W
+#define SEGMENT_DIGIT_W 17
+#endif
+#ifndef SEGMENT_DIGIT_H
+#define SEGMENT_DIGIT_H 25
+#endif
+#ifndef SEGMENT_STROKE
+#define SEGMENT_STROKE 3
+#endif
+#ifndef SEGMENT_ADVANCE
+#define SEGMENT_ADVANCE 21
+#endif
+
+// Time drawn from pre-rendered digit tiles (digit_tiles.h, src/DigitTiles.h from
+// tools/digit_tiles.cpp), decoded row by row into the RAM windows. 1 to enable
+// (DISPLAY_SEGMENT_RENDER takes precedence). The tiles are WatchSegment18pt7b digits,
+// so it needs DISPLAY_SEGMENT_FONT too: the colon and the layout come from the time
+// font (an #error in main.cpp otherwise, rather than FreeMonoBold18pt7b mixed in)
+#ifndef DISPLAY_DIGIT_TILES
+#define DISPLAY_DIGIT_TILES 0
+#endif
+// Hours and minutes written to the controller RAM straight from flash: native tiles
+// (src/DigitTilesNative.h, tools/digit_tiles.cpp --native), the rows of the RAM windows
+// as they are, no window buffer. Needs DISPLAY_DIGIT_TILES (same layout); other layouts
+// and the inverted cleanup pass go through the window buffer. 1 to enable
+#ifndef DISPLAY_DIGIT_TILES_NATIVE
+#define DISPLAY_DIGIT_TILES_NATIVE 0
+#endif
+
+// **********
+// Ghosting (see refresh_scheduler.h)
+// **********
+
+// Partial refreshes of a region before it is cleaned up (inverted, then normal)
+#ifndef GHOST_REGION_CLEANUP_THRESHOLD
+#define GHOST_REGION_CLEANUP_THRESHOLD 120
+#endif
+
+// Partial refreshes in total before a full refresh, done at the quiet hour
+#ifndef GHOST_FULL_REFRESH_THRESHOLD
+#define GHOST_FULL_REFRESH_THRESHOLD 1440
+#endif
+#ifndef GHOST_QUIET_HOUR
+#define GHOST_QUIET_HOUR 3
+#endif
+
+// Measured duration of each refresh mode, used to pick the cheapest strong
+// refresh when many pixels change (see frame_diff.h)
+#ifndef REFRESH_COST_PARTIAL_MS
+#define REFRESH_COST_PARTIAL_MS 400
+#endif
+#ifndef REFRESH_COST_FULL_MS
+#define REFRESH_COST_FULL_MS 2600
+#endif
+
+// Cost of one controller RAM byte over SPI: at 10 MHz the per byte SPI.transfer()
+// overhead dominates the 0.8 us on the wire (see multi_window.h)
+#ifndef REFRESH_COST_SPI_BYTE_NS
+#define REFRESH_COST_SPI_BYTE_NS 2000
+#endif
+
+// Changed pixels, in percent of the partial window, above which a plain partial
+// refresh leaves visible ghosting
+#ifndef REFRESH_GHOST_TOLERANCE_PERCENT
+#define REFRESH_GHOST_TOLERANCE_PERCENT 12
+#endif
+
+// **********
+// Epaper driver (GxEPD2_154_D67_Watch)
+// **********
+
+// Partial refreshes with the tuned SSD1681_LUT_FAST_PARTIAL waveform (ssd1681_lut.h)
+// instead of the one in the controller's OTP. 1 to enable
+#ifndef EPD_FAST_PARTIAL_LUT
+#define EPD_FAST_PARTIAL_LUT 0
+#endif
+
+// Read the controller's temperature sensor only every N minutes (and on full refreshes),
+// other refreshes write the cached value to the temperature register. 0 (default) reads it
+// every time and never reads it back. The cache reads the register back over the 3-wire
+// data line bit-banged on MOSI (GxEPD2_154_D67_Watch::readTemperature()), which depends on
+// the board. To enable it (e.g. 30), check on the board first: with it set, the
+// "Temperature (1/16 C)" lines printed after full refreshes must show the room temperature
+// (about 350 to 450), not 65535 (the line read all zeros or all ones: nothing is cached)
+#ifndef EPD_TEMPERATURE_CACHE_MINUTES
+#define EPD_TEMPERATURE_CACHE_MINUTES 0
+#endif
+
+// Partial updates write the new frame to the new RAM only, instead of syncing the old RAM
+// afterwards; relies on display mode 2 taking the displayed frame over as old frame. 1 to enable
+#ifndef EPD_SINGLE_RAM_WRITE
+#define EPD_SINGLE_RAM_WRITE 0
+#endif
+
+// Leave the controller idle (analog and clock off) between wakes instead of in deep
+// sleep, so a wake needs no reset pulse and no configuration. The idle current is higher
+// than deep sleep, measure both on the board before enabling. The wake reads back a marker
+// left in the temperature register, so it needs the 3 wire readback (see
+// EPD_TEMPERATURE_CACHE_MINUTES); without it every wake resets. 1 to enable
+#ifndef EPD_WARM_SLEEP
+#define EPD_WARM_SLEEP 0
+#endif
+// Reset and chip select, held high while the ESP32 sleeps (must match the display constructor)
+#ifndef EPD_RST_GPIO
+#define EPD_RST_GPIO GPIO_NUM_16
+#endif
+#ifndef EPD_CS_GPIO
+#define EPD_CS_GPIO GPIO_NUM_5
+#endif
+
+// Record what the driver sends the panel each wake (spi_trace.h) into RTC memory, printed
+// over Serial (SPITRACE lines) on the next GPIO#33 reset wake, for tools/spi_trace_analyze.cpp.
+// Costs a timer read per byte sent. 1 to enable
+#ifndef SPI_TRACE
+#define SPI_TRACE 0
+#endif
+// RTC memory for the trace of one wake, in bytes
+#ifndef SPI_TRACE_RTC_SIZE
+#define SPI_TRACE_RTC_SIZE 2048
+#endif
+// Data bytes kept per data run (RAM writes are counted and summed beyond that)
+#ifndef SPI_TRACE_DATA_STORED
+#define SPI_TRACE_DATA_STORED 8
+#endif
+
+// Print the profiling lines over Serial: the boot profile (BOOT lines, boot_profile.h), the
+// wake timeline (TIMELINE lines, wake_timeline.h) with the hot path average, and the costs
+// of the wake's decisions (rate log, changed pixel heuristic, multi window plan, refresh
+// with a sensed or cached temperature, warm or cold display init, panel RAM bytes written).
+// Each line costs Serial time in the wake it measures. 1 to enable
+#ifndef WAKE_PROFILE
+#define WAKE_PROFILE 0
+#endif
+
+// **********
+// Wake path
+// **********
+
+// The inner loops of the per minute wake path (WATCH_HOT functions) in IRAM instead of
+// flash: the CPU time of a wake is in the render and RAM write phases (TIMELINE lines),
+// i.e. in the span fills, tile rows, flip counts and the panel driver's RAM write loops,
+// which then run without flash cache refills after deep sleep. The once per wake code
+// around them (setup(), policy, refresh sequences) stays in flash, and so does library
+// code: GxEPD2_EPD (SPI primitives, BUSY wait), the SPI driver and Adafruit GFX (text
+// drawing of the font renderer). Costs IRAM, reported by the tools/iram_report.py build
+// step. 1 to enable
+#ifndef WAKE_HOT_IRAM
+#define WAKE_HOT_IRAM 0
+#endif
+// ESP-IDF build without the Arduino core (env:esp32doit-devkit-v1-idf): the firmware's
+// Arduino calls go to components/idf_shim, set by that env only
+#ifndef WATCH_IDF
+#define WATCH_IDF 0
+#endif
+// Debug 16x2 LCD (LiquidCrystal lcd object). Its constructor initializes the LCD, with a
+// 50 ms power up wait, before setup() on every boot (see boot_profile.h). 0 to drop it
+// (no LiquidCrystal in the ESP-IDF build)
+#ifndef WATCH_LCD
+#define WATCH_LCD !WATCH_IDF
+#endif
+// Attribute of the hot path functions, nothing on the host. Not inlined: an inline copy
+// would be in its caller's section, in flash
+#if WAKE_HOT_IRAM && defined(ESP32)
+#include <esp_attr.h>
+#define WATCH_HOT IRAM_ATTR __attribute__((noinline))
+#else
+#define WATCH_HOT
+#endif
+
+// **********
+// Generator (TIMEKEEPING_MODE_GENERATOR only)
+// **********
+
+// Generator coil signal, squared by a comparator, on GPIO#34 (RTC_GPIO4, input only)
+#define GENERATOR_GPIO GPIO_NUM_34
+#define GENERATOR_RTC_GPIO 4
+
+// Nominal generator frequency, only used by the host simulator and for sanity checks
+#ifndef GENERATOR_NOMINAL_HZ
+#define GENERATOR_NOMINAL_HZ 32
+#endif
+
+// Calibrated number of rising edges in one minute (must fit the ULP 16 bit registers)
+#ifndef GENERATOR_EDGES_PER_MINUTE
+#define GENERATOR_EDGES_PER_MINUTE (GENERATOR_NOMINAL_HZ * 60)
+#endif
+
+// ULP sampling period. Both the high and the low phase of the generator signal
+// must last longer than this, or edges are missed (at 32 Hz each phase is ~15 ms)
+#ifndef GENERATOR_ULP_SAMPLE_US
+#define GENERATOR_ULP_SAMPLE_US 2000
+#endif
+
+#endif
@@ -0,0 +1,155 @@
+// *****************************************************************************
+// Drawing of the watch face: the time regions of the layout (display_layout.h)
+// and the power reserve bar, on the display or on a canvas, through Adafruit
+// GFX. Shared by setup() and the host tools (tools/golden_frames.cpp renders
+// every displayed time with it), so what is checked on the PC is what the
+// watch draws. With DISPLAY_SEGMENT_RENDER the time is drawn as segment
+// rectangles (segment_render.h) instead of the font, with DISPLAY_DIGIT_TILES
+// from the pre-rendered tiles of src/DigitTiles.h (digit_tiles.h).
+// *****************************************************************************
+
+#ifndef WATCH_RENDER_H
+#define WATCH_RENDER_H
+
+#include <stdint.h>
+#include <Adafruit_GFX.h>
+#include <GxEPD2.h>
+
+#include "watch_config.h"
+#include "display_layout.h"
+#include "refresh_scheduler.h"
+#include "segment_render.h"
+#if DISPLAY_DIGIT_TILES
+#include "DigitTiles.h"
+#endif
+
+// Power reserve bar position (rotated coordinates), below the time
+const int16_t powerReserveX = 70;
+const int16_t powerReserveY = 150;
+const int16_t powerReserveW = 60;
+const int16_t powerReserveH = 10;
+
+/// @brief Compute the layout for a font, centered on the display
+/// @param gfx The display, rotated, with the font selected
+/// @param font
+/// @param layout
+inline void display_layout_measure(Adafruit_GFX &gfx, const GFXfont *font, DisplayLayout *layout)
+{
+  // With a monospaced font, the text boundaries for 5 chars (hh24:mi) should always be the same
+  // Measure a reference string, so "hh:--" (hours only policy) stays in the same place
+#if DISPLAY_SEGMENT_RENDER
+  (void)font;
+  segment_layout_compute(segment_style_config(), gfx.width(), gfx.height(), layout);
+#elif DISPLAY_DIGIT_TILES
+  (void)font;
+  digit_tile_layout_compute(digitTiles, gfx.width(), gfx.height(), layout);
+#else
+  int16_t tbx, tby;
+  uint16_t tbw, tbh;
+  gfx.getTextBounds(DISPLAY_REFERENCE_TIME, 0, 0, &tbx, &tby, &tbw, &tbh);
+  uint16_t charAdvance = pgm_read_byte(&font->glyph['0' - font->first].xAdvance);
+  display_layout_compute(layout, tbx, tby, tbw, tbh, charAdvance, gfx.width(), gfx.height());
+#endif
+}
+
+/// @brief Draw time text at the cursor (baseline): the font, the segment rectangles or the tile pixels
+/// @param gfx The display, or a canvas
+/// @param text
+/// @param cursorX, cursorY
+/// @param color
+inline void draw_time_text(Adafruit_GFX &gfx, const char *text, int16_t cursorX, int16_t cursorY, uint16_t color)
+{
+#if DISPLAY_SEGMENT_RENDER
+  const SegmentStyle style = segment_style_config();
+  DisplayWindow rects[SEGMENT_RECTS_MAX];
+  for (; *text; ++text, cursorX += style.advance)
+  {
+    uint8_t count = segment_char_rects(style, *text, cursorX, cursorY, rects);
+    for (uint8_t i = 0; i < count; ++i)
+      gfx.fillRect(rects[i].x, rects[i].y, rects[i].w, rects[i].h, color);
+  }
+#elif DISPLAY_DIGIT_TILES
+  // Black tile bits only, like the glyphs; rotation 3: tile row r is x = cursorX + advance - 1 - r, bit b is y = cursorY + top + b
+  DigitTileReader reader;
+  for (; *text; ++text, cursorX += digitTiles.advance)
+  {
+    digit_tile_reader_begin(&reader, digitTiles, *text);
+    for (uint8_t r = 0; r < digitTiles.advance; ++r)
+    {
+      const uint8_t *row = digit_tile_reader_next(&reader);
+      for (uint8_t b = 0; b < digitTiles.height; ++b)
+        if (!((row[b >> 3] >> (7 - (b & 7))) & 1))
+          gfx.drawPixel(cursorX + digitTiles.advance - 1 - r, cursorY + digitTiles.top + b, color);
+    }
+  }
+#else
+  (void)color;
+  gfx.setCursor(cursorX, cursorY);
+  gfx.print(text);
+#endif
+}
+
+/// @brief Draw the power reserve bar: an outline with one filled segment per level
+/// @param gfx The display, or a canvas
+/// @param level 0 to POWER_RESERVE_LEVELS
+/// @param color GxEPD_BLACK, or GxEPD_WHITE when drawing inverted
+/// @param originX, originY Display position of the gfx origin
+inline void draw_power_reserve(Adafruit_GFX &gfx, uint8_t level, uint16_t color, int16_t originX = 0, int16_t originY = 0)
+{
+  const int16_t segmentW = (powerReserveW - 2) / POWER_RESERVE_LEVELS;
+  const int16_t x = powerReserveX - originX;
+  const int16_t y = powerReserveY - originY;
+  gfx.drawRect(x, y, powerReserveW, powerReserveH, color);
+  for (uint8_t i = 0; i < level; ++i)
+    gfx.fillRect(x + 2 + i * segmentW, y + 2, segmentW - 2, powerReserveH - 4, color);
+}
+
+/// @brief Partial window of a display region
+/// @param layout
+/// @param region
+/// @return
+inline DisplayWindow region_window(const DisplayLayout &layout, uint8_t region)
+{
+  DisplayWindow powerReserve = {powerReserveX, powerReserveY, powerReserveW, powerReserveH};
+  switch (region)
+  {
+  case REGION_HOURS:
+    return layout.hours;
+  case REGION_COLON:
+    return layout.colon;
+  case REGION_MINUTES:
+    return layout.minutes;
+  default:
+    return powerReserve;
+  }
+}
+
+/// @brief Draw the regions in the mask, inside the current page loop (the caller sets the window)
+/// @param gfx The display, or a canvas
+/// @param layout
+/// @param hoursText
+/// @param minutesText
+/// @param powerReserveLevel
+/// @param regionMask REGION_BIT() of the regions to draw
+/// @param inverted White on black, used by the ghosting cleanup
+/// @param originX, originY Display position of the gfx origin
+inline void draw_regions(Adafruit_GFX &gfx, const DisplayLayout &layout, const char *hoursText, const char *minutesText,
+                         uint8_t powerReserveLevel, uint8_t regionMask, bool inverted, int16_t originX = 0, int16_t originY = 0)
+{
+  uint16_t color = inverted ? GxEPD_WHITE : GxEPD_BLACK;
+  int16_t cursorX = layout.cursorX - originX;
+  int16_t cursorY = layout.cursorY - originY;
+  if (inverted)
+    gfx.fillScreen(GxEPD_BLACK);
+  gfx.setTextColor(color);
+  if (regionMask & REGION_BIT(REGION_HOURS))
+    draw_time_text(gfx, hoursText, cursorX, cursorY, color);
+  if (regionMask & REGION_BIT(REGION_COLON))
+    draw_time_text(gfx, ":", cursorX + 2 * layout.charAdvance, cursorY, color);
+  if (regionMask & REGION_BIT(REGION_MINUTES))
+    draw_time_text(gfx, minutesText, cursorX + 3 * layout.charAdvance, cursorY, color);
+  if (regionMask & REGION_BIT(REGION_POWER_RESERVE))
+    draw_power_reserve(gfx, powerReserveLevel, color, originX, originY);
+}
+
+#endif
@@ -0,0 +1,532 @@
+// *****************************************************************************
+// Host tool: digit tile formats (src/digit_tiles.h), size against wake time.
+// Renders the time characters of a font into tiles (opaque cells, controller
+// RAM layout), encodes them in each format, checks that every format decodes
+// to the same pixels, then replays a day of wakes the way write_region_window()
+// draws them (minutes window every minute, hours window on the hour) and
+// reports per format:
+// - flash: tile data and offsets
+// - host decode time per wake (into the region window buffers)
+// - cold cache misses per wake: 32 byte flash cache lines read, the cache
+//   holding nothing after deep sleep (tile data and offsets touched)
+// - modelled wake cost: misses x --miss-ns + host time x --cpu-scale
+// plus the glyph path (display.print() into the same windows) for reference.
+// The miss cost (cache line refill from flash, ~0.5 us at 80 MHz QIO, more at
+// 40 MHz or DIO) and the CPU scale (ESP32 core against the host) are
+// estimates: time the decoder on the watch and pass them to rank for real.
+// --header writes the tile set in the best format (or --format) for
+// DISPLAY_DIGIT_TILES.
+// Also the native tiles (DISPLAY_DIGIT_TILES_NATIVE): raw rows pre-shifted
+// into the region windows of the 200x200 layout, streamed from flash with no
+// window buffer; checked against the window path for every time of the day,
+// timed as the plan plus a read of every streamed byte (the SPI FIFO fill).
+// --native writes them.
+//
+// Build and run (from the repository root, see tools/README for the library path):
+//   g++ -std=c++11 -O2 -Isrc -Icomponents/watch_display -Itools/host -I".pio/libdeps/esp32doit-devkit-v1/Adafruit GFX Library" tools/digit_tiles.cpp -o digit_tiles
+//   ./digit_tiles [--font freemono|segment] [--rounds 50] [--miss-ns 500] [--cpu-scale 10] [--header src/DigitTiles.h [--format raw|packbits|rowrepeat]] [--native src/DigitTilesNative.h]
+// *****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <set>
+#include <vector>
+
+#include <Adafruit_GFX.h>
+#include <GxEPD2.h>
+#include <Fonts/FreeMonoBold18pt7b.h>
+#include "WatchSegment18pt7b.h"
+#include "digit_tiles.h"
+#include "multi_window.h"
+
+#define TIME_COUNT (24 * 60)
+#define PANEL_SIZE 200
+#define CACHE_LINE 32
+#define TILE_CHARS "0123456789:-"
+
+static const char *FORMAT_NAMES[DIGIT_TILE_FORMAT_COUNT] = {"raw", "packbits", "rowrepeat"};
+
+struct Encoded
+{
+  std::vector<uint8_t> data;
+  std::vector<uint16_t> offsets;
+};
+
+// Tiles as rendered: advance rows of rowBytes per character
+static std::vector<std::vector<uint8_t>> tiles;
+
+static void encode_packbits(const std::vector<uint8_t> &in, std::vector<uint8_t> &out)
+{
+  size_t i = 0;
+  while (i < in.size())
+  {
+    size_t run = 1;
+    while (i + run < in.size() && in[i + run] == in[i] && run < 128)
+      run++;
+    if (run >= 2)
+    {
+      out.push_back((uint8_t)(int8_t)(1 - (int)run));
+      out.push_back(in[i]);
+      i += run;
+      continue;
+    }
+    // Literal bytes up to the next run of 2 or more
+    size_t start = i, count = 0;
+    while (i < in.size() && count < 128 && !(i + 1 < in.size() && in[i + 1] == in[i]))
+    {
+      i++;
+      count++;
+    }
+    if (count == 0)
+    {
+      i++;
+      count = 1;
+    }
+    out.push_back((uint8_t)(count - 1));
+    out.insert(out.end(), in.begin() + start, in.begin() + start + count);
+  }
+}
+
+static void encode_row_repeat(const std::vector<uint8_t> &in, uint8_t rowBytes, std::vector<uint8_t> &out)
+{
+  const size_t rows = in.size() / rowBytes;
+  size_t r = 0;
+  while (r < rows)
+  {
+    // Repeats of the previous row
+    size_t repeat = 0;
+    while (r > 0 && r + repeat < rows && repeat < 128 && memcmp(&in[(r + repeat) * rowBytes], &in[(r - 1) * rowBytes], rowBytes) == 0)
+      repeat++;
+    if (repeat)
+    {
+      out.push_back((uint8_t)(0x80 | (repeat - 1)));
+      r += repeat;
+      continue;
+    }
+    // Literal rows, up to a row equal to the one before
+    size_t count = 1;
+    while (r + count < rows && count < 128 && memcmp(&in[(r + count) * rowBytes], &in[(r + count - 1) * rowBytes], rowBytes) != 0)
+      count++;
+    out.push_back((uint8_t)(count - 1));
+    out.insert(out.end(), in.begin() + r * rowBytes, in.begin() + (r + count) * rowBytes);
+    r += count;
+  }
+}
+
+static void encode(DigitTileFormat format, uint8_t rowBytes, Encoded &encoded)
+{
+  for (size_t t = 0; t < tiles.size(); ++t)
+  {
+    encoded.offsets.push_back((uint16_t)encoded.data.size());
+    if (format == DIGIT_TILE_PACKBITS)
+      encode_packbits(tiles[t], encoded.data);
+    else if (format == DIGIT_TILE_ROW_REPEAT)
+      encode_row_repeat(tiles[t], rowBytes, encoded.data);
+    else
+      encoded.data.insert(encoded.data.end(), tiles[t].begin(), tiles[t].end());
+  }
+  encoded.offsets.push_back((uint16_t)encoded.data.size());
+}
+
+static void write_header(const char *path, const char *fontName, const DigitTileSet &set, const Encoded &encoded)
+{
+  FILE *file = fopen(path, "w");
+  if (!file)
+  {
+    fprintf(stderr, "can't write %s\n", path);
+    exit(1);
+  }
+  fprintf(file, "// *****************************************************************************\n");
+  fprintf(file, "// Digit tiles of %s, format %s, for DISPLAY_DIGIT_TILES (digit_tiles.h).\n", fontName, FORMAT_NAMES[set.format]);
+  // Same flash figure as the report: tile data and offsets
+  fprintf(file, "// Generated by tools/digit_tiles.cpp, do not edit: %u bytes of flash (%u of tiles, %u of offsets).\n",
+          (unsigned)(encoded.data.size() + 2 * encoded.offsets.size()), (unsigned)encoded.data.size(), (unsigned)(2 * encoded.offsets.size()));
+  fprintf(file, "// Plain const data, in flash on the ESP32.\n");
+  fprintf(file, "// *****************************************************************************\n\n");
+  fprintf(file, "#ifndef DIGIT_TILES_DATA_H\n#define DIGIT_TILES_DATA_H\n\n#include \"digit_tiles.h\"\n\n");
+  fprintf(file, "const uint8_t digitTilesData[] = {");
+  for (size_t i = 0; i < encoded.data.size(); ++i)
+    fprintf(file, "%s0x%02X%s", (i % 12) ? " " : "\n    ", encoded.data[i], i + 1 < encoded.data.size() ? "," : "");
+  fprintf(file, "};\n\nconst uint16_t digitTilesOffsets[] = {");
+  for (size_t i = 0; i < encoded.offsets.size(); ++i)
+    fprintf(file, "%u%s", encoded.offsets[i], i + 1 < encoded.offsets.size() ? ", " : "");
+  fprintf(file, "};\n\n");
+  fprintf(file, "const DigitTileSet digitTiles = {%s, %u, %u, %d, %d, %d, %u, %u, \"%s\", digitTilesOffsets, digitTilesData};\n\n",
+          set.format == DIGIT_TILE_RAW ? "DIGIT_TILE_RAW" : set.format == DIGIT_TILE_PACKBITS ? "DIGIT_TILE_PACKBITS" : "DIGIT_TILE_ROW_REPEAT",
+          set.advance, set.height, set.top, set.boundsX, set.boundsY, set.boundsW, set.boundsH, TILE_CHARS);
+  fprintf(file, "#endif\n");
+  fclose(file);
+}
+
+static void write_native_header(const char *path, const char *fontName, const DigitTileNative &native, const std::vector<uint8_t> &data,
+                                const std::vector<uint8_t> &white)
+{
+  FILE *file = fopen(path, "w");
+  if (!file)
+  {
+    fprintf(stderr, "can't write %s\n", path);
+    exit(1);
+  }
+  fprintf(file, "// *****************************************************************************\n");
+  fprintf(file, "// Native digit tiles of %s for DISPLAY_DIGIT_TILES_NATIVE (digit_tiles.h):\n", fontName);
+  fprintf(file, "// rows of the hours and minutes RAM windows of the 200x200 layout, written to\n");
+  fprintf(file, "// the controller straight from flash.\n");
+  fprintf(file, "// Generated by tools/digit_tiles.cpp, do not edit: %u bytes.\n", (unsigned)(data.size() + white.size()));
+  fprintf(file, "// *****************************************************************************\n\n");
+  fprintf(file, "#ifndef DIGIT_TILES_NATIVE_DATA_H\n#define DIGIT_TILES_NATIVE_DATA_H\n\n#include \"digit_tiles.h\"\n\n");
+  const std::vector<uint8_t> *arrays[2] = {&data, &white};
+  const char *names[2] = {"digitTilesNativeData", "digitTilesNativeWhite"};
+  for (int a = 0; a < 2; ++a)
+  {
+    fprintf(file, "const uint8_t %s[] = {", names[a]);
+    for (size_t i = 0; i < arrays[a]->size(); ++i)
+      fprintf(file, "%s0x%02X%s", (i % 12) ? " " : "\n    ", (*arrays[a])[i], i + 1 < arrays[a]->size() ? "," : "");
+    fprintf(file, "};\n\n");
+  }
+  fprintf(file, "const DigitTileNative digitTilesNative = {%d, %d, %d, %u, %u, %u, \"%s\", digitTilesNativeData, digitTilesNativeWhite};\n\n",
+          native.cursorX, native.cursorY, native.panelX, native.panelW, native.rows, native.whiteRows, TILE_CHARS);
+  fprintf(file, "#endif\n");
+  fclose(file);
+}
+
+/// @brief Count the cache lines of a byte range
+static void touch(std::set<uintptr_t> &lines, const void *start, size_t bytes)
+{
+  uintptr_t from = (uintptr_t)start / CACHE_LINE, to = ((uintptr_t)start + bytes + CACHE_LINE - 1) / CACHE_LINE;
+  for (uintptr_t line = from; line < to; ++line)
+    lines.insert(line);
+}
+
+int main(int argc, char **argv)
+{
+  const GFXfont *font = &FreeMonoBold18pt7b;
+  const char *fontName = "FreeMonoBold18pt7b";
+  const char *headerPath = NULL, *nativeHeaderPath = NULL;
+  int headerFormat = -1;
+  int rounds = 50;
+  double missNanos = 500, cpuScale = 10;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (i + 1 < argc && strcmp(argv[i], "--font") == 0)
+    {
+      ++i;
+      if (strcmp(argv[i], "segment") == 0)
+      {
+        font = &WatchSegment18pt7b;
+        fontName = "WatchSegment18pt7b";
+      }
+      else if (strcmp(argv[i], "freemono") != 0)
+        headerFormat = -2;
+    }
+    else if (i + 1 < argc && strcmp(argv[i], "--rounds") == 0)
+      rounds = atoi(argv[++i]);
+    else if (i + 1 < argc && strcmp(argv[i], "--miss-ns") == 0)
+      missNanos = atof(argv[++i]);
+    else if (i + 1 < argc && strcmp(argv[i], "--cpu-scale") == 0)
+      cpuScale = atof(argv[++i]);
+    else if (i + 1 < argc && strcmp(argv[i], "--header") == 0)
+      headerPath = argv[++i];
+    else if (i + 1 < argc && strcmp(argv[i], "--native") == 0)
+      nativeHeaderPath = argv[++i];
+    else if (i + 1 < argc && strcmp(argv[i], "--format") == 0)
+    {
+      ++i;
+      headerFormat = -2;
+      for (int f = 0; f < DIGIT_TILE_FORMAT_COUNT; ++f)
+        if (strcmp(argv[i], FORMAT_NAMES[f]) == 0)
+          headerFormat = f;
+    }
+    else
+      headerFormat = -2;
+    if (headerFormat == -2 || rounds < 1)
+    {
+      fprintf(stderr, "usage: %s [--font freemono|segment] [--rounds 50] [--miss-ns 500] [--cpu-scale 10] [--header path [--format raw|packbits|rowrepeat]] [--native path]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  // Glyph box of the tile characters, and the reference text bounds
+  int16_t top = 0x7FFF, bottom = -0x7FFF;
+  for (const char *c = TILE_CHARS; *c; ++c)
+  {
+    const GFXglyph *glyph = &font->glyph[*c - font->first];
+    if (glyph->width && glyph->height)
+    {
+      top = glyph->yOffset < top ? glyph->yOffset : top;
+      bottom = (glyph->yOffset + glyph->height) > bottom ? (glyph->yOffset + glyph->height) : bottom;
+    }
+  }
+  GFXcanvas1 measure(PANEL_SIZE, PANEL_SIZE);
+  measure.setFont(font);
+  measure.setTextWrap(false);
+  DigitTileSet set = {DIGIT_TILE_RAW, font->glyph['0' - font->first].xAdvance, (uint8_t)(bottom - top), (int8_t)top, 0, 0, 0, 0, TILE_CHARS, NULL, NULL};
+  measure.getTextBounds(DISPLAY_REFERENCE_TIME, 0, 0, &set.boundsX, &set.boundsY, &set.boundsW, &set.boundsH);
+  const uint8_t rowBytes = (set.height + 7) / 8;
+  if (rowBytes > DIGIT_TILE_ROW_BYTES_MAX)
+  {
+    fprintf(stderr, "glyph box of %u pixels, at most %u\n", set.height, DIGIT_TILE_ROW_BYTES_MAX * 8);
+    return 1;
+  }
+
+  // Tiles: one cell per character, native orientation (rotation 3), box top on row bit 0
+  for (const char *c = TILE_CHARS; *c; ++c)
+  {
+    GFXcanvas1 canvas(set.height, set.advance);
+    canvas.setRotation(DISPLAY_ROTATION);
+    canvas.setFont(font);
+    canvas.setTextWrap(false);
+    canvas.fillScreen(GxEPD_WHITE);
+    canvas.setTextColor(GxEPD_BLACK);
+    canvas.setCursor(0, -top);
+    char text[2] = {*c, 0};
+    canvas.print(text);
+    tiles.push_back(std::vector<uint8_t>(canvas.getBuffer(), canvas.getBuffer() + rowBytes * set.advance));
+  }
+
+  // Layout and region windows of setup(), panel buffers as in write_region_window()
+  DisplayLayout layout;
+  digit_tile_layout_compute(set, PANEL_SIZE, PANEL_SIZE, &layout);
+  const uint8_t regions[2] = {REGION_HOURS, REGION_MINUTES};
+  DisplayWindow panels[2];
+  std::vector<uint8_t> buffers[2], reference[sizeof(TILE_CHARS)][2];
+  for (int r = 0; r < 2; ++r)
+  {
+    DisplayWindow window = regions[r] == REGION_HOURS ? layout.hours : layout.minutes;
+    panels[r] = display_window_to_panel(window, PANEL_SIZE);
+    buffers[r].resize((panels[r].w / 8) * panels[r].h);
+  }
+
+  Encoded encoded[DIGIT_TILE_FORMAT_COUNT];
+  DigitTileSet sets[DIGIT_TILE_FORMAT_COUNT];
+  double wakeCost[DIGIT_TILE_FORMAT_COUNT];
+  int failures = 0, best = 0;
+  printf("%s, tiles %ux%u (cell x box), %u characters, %u bytes raw\n", fontName, set.advance, set.height, (unsigned)tiles.size(),
+         (unsigned)(tiles.size() * rowBytes * set.advance));
+  printf("%-10s %8s %12s %12s %14s\n", "format", "flash", "decode ns", "cold misses", "wake cost ns");
+  for (int f = 0; f < DIGIT_TILE_FORMAT_COUNT; ++f)
+  {
+    encode((DigitTileFormat)f, rowBytes, encoded[f]);
+    sets[f] = set;
+    sets[f].format = f;
+    sets[f].offsets = encoded[f].offsets.data();
+    sets[f].data = encoded[f].data.data();
+
+    // Same pixels as the raw tiles, for every character in every region
+    for (const char *c = TILE_CHARS; *c; ++c)
+      for (int r = 0; r < 2; ++r)
+      {
+        char text[3] = {*c, *c, 0};
+        PanelBuffer target = {buffers[r].data(), panels[r], PANEL_SIZE};
+        digit_tile_draw_regions(target, sets[f], layout, text, text, REGION_BIT(regions[r]), false);
+        std::vector<uint8_t> &raw = reference[c - TILE_CHARS][r];
+        if (f == DIGIT_TILE_RAW)
+          raw = buffers[r];
+        else if (buffers[r] != raw)
+        {
+          printf("%s: '%c' differs from raw\n", FORMAT_NAMES[f], *c);
+          failures++;
+        }
+      }
+
+    // A day of wakes: decode time, and the flash lines each wake reads
+    uint64_t misses = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round)
+      for (int time = 0; time < TIME_COUNT; ++time)
+      {
+        int next = (time + 1) % TIME_COUNT;
+        char hoursText[8], minutesText[8];
+        snprintf(hoursText, sizeof(hoursText), "%02d", next / 60);
+        snprintf(minutesText, sizeof(minutesText), "%02d", next % 60);
+        const bool hoursDirty = (next / 60) != (time / 60);
+        for (int r = hoursDirty ? 0 : 1; r < 2; ++r)
+        {
+          PanelBuffer target = {buffers[r].data(), panels[r], PANEL_SIZE};
+          digit_tile_draw_regions(target, sets[f], layout, hoursText, minutesText, REGION_BIT(regions[r]), false);
+        }
+        if (round == 0)
+        {
+          std::set<uintptr_t> lines;
+          const char *text = hoursDirty ? NULL : minutesText;
+          char both[16];
+          if (hoursDirty)
+          {
+            snprintf(both, sizeof(both), "%s%s", hoursText, minutesText);
+            text = both;
+          }
+          for (; *text; ++text)
+          {
+            size_t t = strchr(TILE_CHARS, *text) - TILE_CHARS;
+            touch(lines, &encoded[f].offsets[t], 2 * sizeof(uint16_t));
+            touch(lines, &encoded[f].data[encoded[f].offsets[t]], encoded[f].offsets[t + 1] - encoded[f].offsets[t]);
+          }
+          misses += lines.size();
+        }
+      }
+    double nanos = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ((double)rounds * TIME_COUNT);
+    double missesPerWake = (double)misses / TIME_COUNT;
+    wakeCost[f] = missesPerWake * missNanos + nanos * cpuScale;
+    if (wakeCost[f] < wakeCost[best])
+      best = f;
+    printf("%-10s %8u %12.0f %12.1f %14.0f\n", FORMAT_NAMES[f], (unsigned)(encoded[f].data.size() + 2 * encoded[f].offsets.size()), nanos,
+           missesPerWake, wakeCost[f]);
+  }
+
+  // Reference: the glyph path, display.print() into the same windows (glyph bitmaps and table read from flash)
+  {
+    uint64_t misses = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round)
+      for (int time = 0; time < TIME_COUNT; ++time)
+      {
+        int next = (time + 1) % TIME_COUNT;
+        char hoursText[8], minutesText[8];
+        snprintf(hoursText, sizeof(hoursText), "%02d", next / 60);
+        snprintf(minutesText, sizeof(minutesText), "%02d", next % 60);
+        const bool hoursDirty = (next / 60) != (time / 60);
+        std::set<uintptr_t> lines;
+        for (int r = hoursDirty ? 0 : 1; r < 2; ++r)
+        {
+          DisplayWindow window = display_window_from_panel(panels[r], PANEL_SIZE);
+          GFXcanvas1 canvas(panels[r].w, panels[r].h);
+          canvas.setRotation(DISPLAY_ROTATION);
+          canvas.setFont(font);
+          canvas.setTextWrap(false);
+          canvas.fillScreen(GxEPD_WHITE);
+          canvas.setTextColor(GxEPD_BLACK);
+          canvas.setCursor(layout.cursorX + (r == 0 ? 0 : 3) * layout.charAdvance - window.x, layout.cursorY - window.y);
+          const char *text = r == 0 ? hoursText : minutesText;
+          canvas.print(text);
+          if (round == 0)
+          {
+            // The tiles draw what print() draws
+            PanelBuffer target = {buffers[r].data(), panels[r], PANEL_SIZE};
+            digit_tile_draw_regions(target, sets[DIGIT_TILE_RAW], layout, hoursText, minutesText, REGION_BIT(regions[r]), false);
+            if (memcmp(buffers[r].data(), canvas.getBuffer(), buffers[r].size()) != 0)
+            {
+              printf("%s:%s: tiles differ from print()\n", hoursText, minutesText);
+              failures++;
+            }
+          }
+          for (; round == 0 && *text; ++text)
+          {
+            const GFXglyph *glyph = &font->glyph[*text - font->first];
+            touch(lines, glyph, sizeof(GFXglyph));
+            touch(lines, &font->bitmap[glyph->bitmapOffset], (glyph->width * glyph->height + 7) / 8);
+          }
+        }
+        misses += lines.size();
+      }
+    double nanos = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ((double)rounds * TIME_COUNT);
+    double missesPerWake = (double)misses / TIME_COUNT;
+    printf("%-10s %8s %12.0f %12.1f %14.0f\n", "glyphs", "-", nanos, missesPerWake, missesPerWake * missNanos + nanos * cpuScale);
+  }
+
+  // Native tiles: pre-shifted raw rows of the region windows, streamed from flash (writeImageBulk())
+  DigitTileNative native = {layout.cursorX, layout.cursorY, panels[0].x, panels[0].w, set.advance, 0, TILE_CHARS, NULL, NULL};
+  const uint16_t nativeRowBytes = native.panelW / 8;
+  const int16_t boxX = layout.cursorY + set.top - native.panelX;
+  std::vector<uint8_t> nativeData, nativeWhite;
+  if (panels[1].x != panels[0].x || panels[1].w != panels[0].w || boxX < 0 || boxX + set.height > native.panelW)
+  {
+    printf("native: the glyph box is not inside the region windows, no native tiles\n");
+    nativeHeaderPath = NULL;
+  }
+  else
+  {
+    for (int r = 0; r < 2; ++r)
+    {
+      const DisplayWindow &window = regions[r] == REGION_HOURS ? layout.hours : layout.minutes;
+      const int16_t textX = layout.cursorX + (r == 0 ? 0 : 3) * layout.charAdvance;
+      int16_t before = textX - window.x, after = window.x + window.w - (textX + 2 * set.advance);
+      native.whiteRows = before > native.whiteRows ? before : native.whiteRows;
+      native.whiteRows = after > native.whiteRows ? after : native.whiteRows;
+    }
+    native.whiteRows = native.whiteRows ? native.whiteRows : 1;
+    nativeWhite.assign((size_t)native.whiteRows * nativeRowBytes, 0xFF);
+    for (size_t t = 0; t < tiles.size(); ++t)
+      for (uint8_t row = 0; row < set.advance; ++row)
+      {
+        uint8_t line[DIGIT_TILE_ROW_BYTES_MAX + 32];
+        memset(line, 0xFF, nativeRowBytes);
+        digit_tile_put_row(line, native.panelW, boxX, &tiles[t][row * rowBytes], set.height);
+        nativeData.insert(nativeData.end(), line, line + nativeRowBytes);
+      }
+    native.data = nativeData.data();
+    native.white = nativeWhite.data();
+
+    // Same region windows as the window path, every byte covered, for every time of the day
+    uint64_t misses = 0;
+    uint32_t checksum = 0;
+    std::vector<uint8_t> streamed[2];
+    for (int time = 0; time < TIME_COUNT; ++time)
+    {
+      char hoursText[8], minutesText[8];
+      snprintf(hoursText, sizeof(hoursText), "%02d", time / 60);
+      snprintf(minutesText, sizeof(minutesText), "%02d", time % 60);
+      for (int r = 0; r < 2; ++r)
+      {
+        DigitTileWrite writes[DIGIT_TILE_NATIVE_WRITES_MAX];
+        uint8_t count = digit_tile_native_plan(native, layout, PANEL_SIZE, regions[r], r == 0 ? hoursText : minutesText, writes);
+        streamed[r].assign(buffers[r].size(), 0x00);
+        for (uint8_t w = 0; w < count; ++w)
+          for (uint16_t row = 0; row < writes[w].panel.h; ++row)
+            memcpy(&streamed[r][(writes[w].panel.y - panels[r].y + row) * nativeRowBytes], writes[w].data + row * nativeRowBytes, nativeRowBytes);
+        PanelBuffer target = {buffers[r].data(), panels[r], PANEL_SIZE};
+        digit_tile_draw_regions(target, sets[DIGIT_TILE_RAW], layout, hoursText, minutesText, REGION_BIT(regions[r]), false);
+        if (!count || streamed[r] != buffers[r])
+        {
+          printf("%s:%s: native writes differ from the window path\n", hoursText, minutesText);
+          failures++;
+        }
+      }
+    }
+
+    // A day of wakes: plan and read every byte streamed (the SPI FIFO fill)
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round)
+      for (int time = 0; time < TIME_COUNT; ++time)
+      {
+        int next = (time + 1) % TIME_COUNT;
+        char hoursText[8], minutesText[8];
+        snprintf(hoursText, sizeof(hoursText), "%02d", next / 60);
+        snprintf(minutesText, sizeof(minutesText), "%02d", next % 60);
+        const bool hoursDirty = (next / 60) != (time / 60);
+        std::set<uintptr_t> lines;
+        for (int r = hoursDirty ? 0 : 1; r < 2; ++r)
+        {
+          DigitTileWrite writes[DIGIT_TILE_NATIVE_WRITES_MAX];
+          uint8_t count = digit_tile_native_plan(native, layout, PANEL_SIZE, regions[r], r == 0 ? hoursText : minutesText, writes);
+          for (uint8_t w = 0; w < count; ++w)
+          {
+            const uint32_t bytes = (uint32_t)writes[w].panel.h * nativeRowBytes;
+            for (uint32_t i = 0; i < bytes; ++i)
+              checksum += writes[w].data[i];
+            if (round == 0)
+              touch(lines, writes[w].data, bytes);
+          }
+        }
+        misses += lines.size();
+      }
+    double nanos = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ((double)rounds * TIME_COUNT);
+    double missesPerWake = (double)misses / TIME_COUNT;
+    printf("%-10s %8u %12.0f %12.1f %14.0f  (streamed, no window buffer; checksum %u)\n", "native", (unsigned)(nativeData.size() + nativeWhite.size()),
+           nanos, missesPerWake, missesPerWake * missNanos + nanos * cpuScale, checksum);
+  }
+  printf("miss %.0f ns, CPU scale %.1f: lowest wake cost %s\n", missNanos, cpuScale, FORMAT_NAMES[best]);
+
+  if (headerPath && !failures)
+  {
+    int f = headerFormat >= 0 ? headerFormat : best;
+    write_header(headerPath, fontName, sets[f], encoded[f]);
+    printf("wrote %s (%s)\n", headerPath, FORMAT_NAMES[f]);
+  }
+  if (nativeHeaderPath && !failures)
+  {
+    write_native_header(nativeHeaderPath, fontName, native, nativeData, nativeWhite);
+    printf("wrote %s (native)\n", nativeHeaderPath);
+  }
+  return failures ? 2 : 0;
+}
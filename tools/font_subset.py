@@ -0,0 +1,166 @@
+# *****************************************************************************
+# Build step: font subsetting. Generates, from the Adafruit GFX fonts the watch
+# uses, GFXfont tables with only the glyphs it draws (by default the time:
+# 0-9, ':' and '-' for "hh:--"), so the full ASCII glyph tables are not linked.
+# A smaller image is faster to verify and map by the bootloader at every deep
+# sleep wake.
+# GFXfont glyphs are a contiguous range (first to last), so the characters in
+# the range that are not kept stay as empty glyphs (no bitmap, same advance):
+# metrics, layout and text bounds are those of the full font.
+#
+# As a PlatformIO extra script (platformio.ini):
+#   extra_scripts = pre:tools/font_subset.py
+#   custom_font_subset_fonts = FreeMonoBold18pt7b
+#   custom_font_subset_chars = -0123456789:
+# it writes <font>Subset.h (font <font>Subset) into the build folder, adds it
+# to the include path and defines FONT_SUBSET=1 (main.cpp then draws with the
+# subset), and prints the flash saved per font.
+#
+# On the host, same tables and report (also the ESP-IDF build step, in
+# components/watch_display/CMakeLists.txt):
+#   python3 tools/font_subset.py <font header> <output header> [chars]
+# *****************************************************************************
+
+import os
+import re
+import sys
+
+DEFAULT_CHARS = "-0123456789:"
+
+# Flash taken by the tables on the ESP32 (GFXglyph and GFXfont with their padding)
+GLYPH_BYTES = 8
+FONT_BYTES = 16
+
+
+def _strip_comments(text):
+    text = re.sub(r"/\*.*?\*/", "", text, flags=re.S)
+    return re.sub(r"//[^\n]*", "", text)
+
+
+def parse_font(path):
+    """Bitmaps, glyphs (offset, w, h, xAdvance, xOffset, yOffset), first, last and yAdvance of a GFXfont header"""
+    with open(path) as file:
+        text = _strip_comments(file.read())
+    bitmaps = re.search(r"(\w+)Bitmaps\s*\[\s*\]\s*(?:PROGMEM)?\s*=\s*\{(.*?)\}\s*;", text, re.S)
+    glyphs = re.search(r"(\w+)Glyphs\s*\[\s*\]\s*(?:PROGMEM)?\s*=\s*\{(.*?)\}\s*;", text, re.S)
+    font = re.search(r"GFXfont\s+(\w+)\s*(?:PROGMEM)?\s*=\s*\{[^,]*,[^,]*,\s*(\w+)\s*,\s*(\w+)\s*,\s*(\w+)\s*\}", text, re.S)
+    if not bitmaps or not glyphs or not font:
+        raise ValueError("%s: not a GFXfont header" % path)
+    data = [int(value, 0) for value in re.findall(r"0x[0-9A-Fa-f]+|\d+", bitmaps.group(2))]
+    entries = [
+        tuple(int(value, 0) for value in entry.split(","))
+        for entry in re.findall(r"\{\s*(-?\w+\s*,\s*-?\w+\s*,\s*-?\w+\s*,\s*-?\w+\s*,\s*-?\w+\s*,\s*-?\w+)\s*\}", glyphs.group(2))
+    ]
+    return {
+        "name": font.group(1),
+        "bitmaps": data,
+        "glyphs": entries,
+        "first": int(font.group(2), 0),
+        "last": int(font.group(3), 0),
+        "yAdvance": int(font.group(4), 0),
+    }
+
+
+def font_bytes(font):
+    return len(font["bitmaps"]) + GLYPH_BYTES * len(font["glyphs"]) + FONT_BYTES
+
+
+def subset_font(font, chars):
+    """Font with only the glyphs of chars, over their range, others empty"""
+    codes = sorted(set(ord(c) for c in chars if font["first"] <= ord(c) <= font["last"]))
+    if not codes:
+        raise ValueError("%s: none of the characters %r" % (font["name"], chars))
+    bitmaps, glyphs = [], []
+    for code in range(codes[0], codes[-1] + 1):
+        offset, width, height, xAdvance, xOffset, yOffset = font["glyphs"][code - font["first"]]
+        if code not in codes:
+            width = height = xOffset = yOffset = 0
+        size = (width * height + 7) // 8
+        glyphs.append((len(bitmaps), width, height, xAdvance, xOffset, yOffset))
+        bitmaps.extend(font["bitmaps"][offset:offset + size])
+    return {
+        "name": font["name"] + "Subset",
+        "bitmaps": bitmaps,
+        "glyphs": glyphs,
+        "first": codes[0],
+        "last": codes[-1],
+        "yAdvance": font["yAdvance"],
+    }
+
+
+def write_font(font, path, source, chars):
+    name = font["name"]
+    lines = [
+        "// Generated by tools/font_subset.py from %s, do not edit." % os.path.basename(source),
+        "// Glyphs kept: %s" % "".join(sorted(set(chars))),
+        "",
+        "#ifndef %s_H" % name.upper(),
+        "#define %s_H" % name.upper(),
+        "",
+        "#include <gfxfont.h>",
+        "",
+        "const uint8_t %sBitmaps[] PROGMEM = {" % name,
+    ]
+    data = font["bitmaps"] or [0]
+    for i in range(0, len(data), 12):
+        lines.append("    " + ", ".join("0x%02X" % value for value in data[i:i + 12]) + ",")
+    lines[-1] = lines[-1].rstrip(",") + "};"
+    lines += ["", "const GFXglyph %sGlyphs[] PROGMEM = {" % name]
+    for i, glyph in enumerate(font["glyphs"]):
+        code = font["first"] + i
+        lines.append("    {%d, %d, %d, %d, %d, %d}, // 0x%02X '%s'" % (glyph + (code, chr(code))))
+    lines[-1] = lines[-1].replace("},", "} ", 1)
+    lines += [
+        "};",
+        "",
+        "const GFXfont %s PROGMEM = {(uint8_t *)%sBitmaps, (GFXglyph *)%sGlyphs, 0x%02X, 0x%02X, %d};"
+        % (name, name, name, font["first"], font["last"], font["yAdvance"]),
+        "",
+        "#endif",
+        "",
+    ]
+    with open(path, "w") as file:
+        file.write("\n".join(lines))
+
+
+def subset_file(source, output, chars):
+    """Write the subset header, return (full bytes, subset bytes)"""
+    font = parse_font(source)
+    subset = subset_font(font, chars)
+    write_font(subset, output, source, chars)
+    return font_bytes(font), font_bytes(subset)
+
+
+def report(name, full, subset):
+    print("Font subset %s: %d -> %d bytes of flash, %d saved" % (name, full, subset, full - subset))
+
+
+if "Import" not in globals():
+    if len(sys.argv) not in (3, 4):
+        sys.exit("usage: %s <font header> <output header> [chars]" % sys.argv[0])
+    full, subset = subset_file(sys.argv[1], sys.argv[2], sys.argv[3] if len(sys.argv) == 4 else DEFAULT_CHARS)
+    report(os.path.basename(sys.argv[1]), full, subset)
+else:
+    Import("env")  # noqa: F821 (PlatformIO SCons environment)
+
+    config = env.GetProjectConfig()  # noqa: F821
+    section = "env:" + env["PIOENV"]  # noqa: F821
+    fonts = config.get(section, "custom_font_subset_fonts", "FreeMonoBold18pt7b").split()
+    chars = config.get(section, "custom_font_subset_chars", DEFAULT_CHARS)
+    fontsDir = os.path.join(env.subst("$PROJECT_LIBDEPS_DIR"), env["PIOENV"], "Adafruit GFX Library", "Fonts")  # noqa: F821
+    outputDir = os.path.join(env.subst("$BUILD_DIR"), "font_subset")  # noqa: F821
+    os.makedirs(outputDir, exist_ok=True)
+
+    saved = 0
+    for name in fonts:
+        source = os.path.join(fontsDir, name + ".h")
+        if not os.path.exists(source):
+            # First build: the library is not installed yet, the full fonts are used
+            print("Font subset %s: %s not found, not subsetting" % (name, source))
+            break
+        full, subset = subset_file(source, os.path.join(outputDir, name + "Subset.h"), chars)
+        report(name, full, subset)
+        saved += full - subset
+    else:
+        print("Font subset: %d bytes of flash saved" % saved)
+        env.Append(CPPPATH=[outputDir], CPPDEFINES=[("FONT_SUBSET", 1)])  # noqa: F821
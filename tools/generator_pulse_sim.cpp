@@ -0,0 +1,152 @@
+// *****************************************************************************
+// Host tool: generator pulse train simulator for TIMEKEEPING_MODE_GENERATOR.
+// Generates the squared generator signal (frequency error, duty cycle and per
+// period jitter), samples it every GENERATOR_ULP_SAMPLE_US like the ULP timer
+// does and feeds the samples to the reference model of the ULP program
+// (generator_timebase.h). Reports missed edges and the timing of each minute
+// boundary against the ideal edge count and against the wall clock, and
+// checks that the edges the main core takes at each wake (generator_take_edges,
+// the rate log) add up to the edges the ULP counted.
+//
+// Build and run (from the repository root):
+//   g++ -std=c++11 -O2 -Isrc tools/generator_pulse_sim.cpp -o generator_pulse_sim
+//   ./generator_pulse_sim [--hz 32] [--ppm 0] [--jitter 5] [--duty 50]
+//                         [--sample-us 2000] [--edges N] [--minutes 1440] [--seed 1]
+// --jitter is the standard deviation of each period, in percent of the period.
+// Exit code is 1 if edges were missed, a boundary came later than one sample or
+// the rate log edges don't add up.
+// *****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <random>
+
+#include "generator_timebase.h"
+
+int main(int argc, char *argv[])
+{
+  double hz = GENERATOR_NOMINAL_HZ;
+  double ppm = 0;
+  double jitterPercent = 5;
+  double dutyPercent = 50;
+  double sampleUs = GENERATOR_ULP_SAMPLE_US;
+  long edgesPerMinute = GENERATOR_EDGES_PER_MINUTE;
+  long minutes = 24 * 60;
+  unsigned seed = 1;
+
+  for (int i = 1; i + 1 < argc; i += 2)
+  {
+    double value = atof(argv[i + 1]);
+    if (!strcmp(argv[i], "--hz")) hz = value;
+    else if (!strcmp(argv[i], "--ppm")) ppm = value;
+    else if (!strcmp(argv[i], "--jitter")) jitterPercent = value;
+    else if (!strcmp(argv[i], "--duty")) dutyPercent = value;
+    else if (!strcmp(argv[i], "--sample-us")) sampleUs = value;
+    else if (!strcmp(argv[i], "--edges")) edgesPerMinute = (long)value;
+    else if (!strcmp(argv[i], "--minutes")) minutes = (long)value;
+    else if (!strcmp(argv[i], "--seed")) seed = (unsigned)value;
+    else
+    {
+      fprintf(stderr, "unknown option %s\n", argv[i]);
+      return 2;
+    }
+  }
+  if (hz <= 0 || sampleUs <= 0 || edgesPerMinute <= 0 || edgesPerMinute > 0xFFFF || minutes <= 0)
+  {
+    fprintf(stderr, "invalid parameters\n");
+    return 2;
+  }
+
+  std::mt19937 rng(seed);
+  const double meanPeriod = 1.0 / (hz * (1.0 + ppm * 1e-6));
+  std::normal_distribution<double> periodJitter(0.0, meanPeriod * jitterPercent / 100.0);
+  const double samplePeriod = sampleUs * 1e-6;
+
+  GeneratorCounter counter;
+  generator_counter_reset(&counter, (uint16_t)edgesPerMinute);
+
+  // Current generator period: rising edge at riseTime, falling edge at fallTime
+  double riseTime = 0;
+  double period = meanPeriod;
+  double fallTime = riseTime + period * dutyPercent / 100.0;
+  long trueEdges = 1; // The edge at t = 0
+  long countedEdges = 0;
+  double shortestPhase = fallTime - riseTime;
+
+  long boundaries = 0;
+  double maxLatency = 0, sumLatency = 0;
+  double maxWallError = 0;
+  double idealBoundaryTime = 0; // Time of the edge that completes the minute
+
+  // Main core: looks at every boundary wake (and at the end), as generator_ulp_take_minutes()
+  uint16_t minutesConsumed = counter.minuteTotal, edgesConsumed = counter.edgeCount;
+  long loggedEdges = 0;
+
+  // Start sampling half a sample after t = 0, like an arbitrary ULP timer phase
+  for (double t = samplePeriod / 2; boundaries < minutes; t += samplePeriod)
+  {
+    // Advance the signal up to time t
+    while (riseTime + period <= t)
+    {
+      riseTime += period;
+      period = meanPeriod + periodJitter(rng);
+      if (period < meanPeriod * 0.1)
+        period = meanPeriod * 0.1;
+      fallTime = riseTime + period * dutyPercent / 100.0;
+      double low = period - (fallTime - riseTime);
+      shortestPhase = fmin(shortestPhase, fmin(fallTime - riseTime, low));
+      ++trueEdges;
+      if (trueEdges == (boundaries + 1) * edgesPerMinute)
+        idealBoundaryTime = riseTime;
+    }
+    uint16_t level = (t >= riseTime && t < fallTime) ? 1 : 0;
+
+    uint16_t edgesBefore = counter.edgeCount;
+    bool boundary = generator_counter_sample(&counter, level);
+    if (boundary || counter.edgeCount != edgesBefore)
+      ++countedEdges;
+
+    if (boundary)
+    {
+      ++boundaries;
+      double latency = t - idealBoundaryTime;
+      sumLatency += latency;
+      maxLatency = fmax(maxLatency, latency);
+      maxWallError = fmax(maxWallError, fabs(t - boundaries * 60.0));
+      uint32_t taken = generator_take_minutes(counter.minuteTotal, &minutesConsumed);
+      loggedEdges += generator_take_edges(taken, counter.threshold, counter.edgeCount, &edgesConsumed);
+    }
+  }
+  loggedEdges += generator_take_edges(generator_take_minutes(counter.minuteTotal, &minutesConsumed), counter.threshold,
+                                      counter.edgeCount, &edgesConsumed);
+
+  long missedEdges = trueEdges - countedEdges;
+  double measuredEdgesPerMinute = 60.0 / meanPeriod;
+
+  printf("signal: %.3f Hz %+.1f ppm, jitter %.1f%%, duty %.0f%%, shortest phase %.3f ms\n",
+         hz, ppm, jitterPercent, dutyPercent, shortestPhase * 1e3);
+  printf("ULP: sample every %.0f us, %ld edges per minute\n", sampleUs, edgesPerMinute);
+  printf("minutes: %ld, generator edges: %ld, counted: %ld, missed: %ld\n",
+         boundaries, trueEdges, countedEdges, missedEdges);
+  printf("rate log edges: %ld\n", loggedEdges);
+  printf("boundary latency vs ideal edge: mean %.3f ms, max %.3f ms\n",
+         sumLatency / boundaries * 1e3, maxLatency * 1e3);
+  printf("boundary error vs wall clock: max %.3f s (%.2f s/day rate error)\n",
+         maxWallError, (measuredEdgesPerMinute / edgesPerMinute - 1.0) * 86400.0);
+  printf("calibration: GENERATOR_EDGES_PER_MINUTE %.0f\n", measuredEdgesPerMinute);
+
+  if (missedEdges != 0 || maxLatency > samplePeriod)
+  {
+    printf("FAIL: sampling too slow for this signal\n");
+    return 1;
+  }
+  if (loggedEdges != countedEdges)
+  {
+    printf("FAIL: rate log edges differ from the counted edges\n");
+    return 1;
+  }
+  printf("OK\n");
+  return 0;
+}
@@ -0,0 +1,141 @@
+// *****************************************************************************
+// Host tool: pixels flipped by the time digits, FreeMonoBold18pt7b against the
+// seven segment WatchSegment18pt7b (DISPLAY_SEGMENT_FONT, generated by
+// segment_font_gen.cpp).
+// Uses the changed pixel heuristic of the watch (src/frame_diff.h, XOR of the
+// glyphs of each monospaced cell) over a day of minute changes (00:00 ->
+// 00:01 ... 23:59 -> 00:00) and prints for each font the daily total, the
+// flips of each digit change (the carries 9->0, 5->0, 3->0 and 2->0 are the
+// ones that happen at the tens), the ink per digit and the worst minutes.
+// Recorded (flipped pixels per day, worst minute; update with the fonts):
+//   WatchSegment18pt7b   157776, 405
+//   FreeMonoBold18pt7b   not recorded yet, run against the library's font
+//
+// Build and run (from the repository root, see tools/README for the library path):
+//   g++ -std=c++11 -O2 -Isrc -I".pio/libdeps/esp32doit-devkit-v1/Adafruit GFX Library" tools/glyph_flip_score.cpp -o glyph_flip_score
+//   ./glyph_flip_score
+// *****************************************************************************
+
+#include <stdio.h>
+#include <stdint.h>
+
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+
+#include <gfxfont.h>
+#include <Fonts/FreeMonoBold18pt7b.h>
+#include "WatchSegment18pt7b.h"
+#include "frame_diff.h"
+
+#define TIME_COUNT (24 * 60)
+#define WORST_COUNT 3
+
+struct FontScore
+{
+  const char *name;
+  const GFXfont *font;
+  uint32_t dailyFlips;
+  uint32_t maxFlips;
+  uint32_t digitFlips[10][10]; // [from][to]
+  uint32_t ink[10];
+  int worst[WORST_COUNT]; // minute of the day before the change
+};
+
+static void format_time(int minute, char *text)
+{
+  snprintf(text, 16, "%02d:%02d", minute / 60, minute % 60);
+}
+
+/// @brief Pixels set in a glyph
+static uint32_t glyph_ink(const GFXfont *font, char c)
+{
+  const GFXglyph *glyph = &font->glyph[(uint8_t)c - font->first];
+  uint32_t ink = 0;
+  for (int16_t y = glyph->yOffset; y < glyph->yOffset + glyph->height; ++y)
+    for (int16_t x = glyph->xOffset; x < glyph->xOffset + glyph->width; ++x)
+      ink += glyph_pixel(font, glyph, x, y);
+  return ink;
+}
+
+static void score_font(FontScore *score)
+{
+  for (int a = 0; a < 10; ++a)
+  {
+    for (int b = 0; b < 10; ++b)
+      score->digitFlips[a][b] = glyph_flip_count(score->font, '0' + a, '0' + b);
+    score->ink[a] = glyph_ink(score->font, '0' + a);
+  }
+
+  uint32_t flips[TIME_COUNT];
+  score->dailyFlips = 0;
+  score->maxFlips = 0;
+  for (int minute = 0; minute < TIME_COUNT; ++minute)
+  {
+    char previous[16], next[16];
+    format_time(minute, previous);
+    format_time((minute + 1) % TIME_COUNT, next);
+    flips[minute] = text_flip_count(score->font, previous, next);
+    score->dailyFlips += flips[minute];
+    if (flips[minute] > score->maxFlips)
+      score->maxFlips = flips[minute];
+  }
+  for (int w = 0; w < WORST_COUNT; ++w)
+  {
+    int worst = -1;
+    for (int minute = 0; minute < TIME_COUNT; ++minute)
+    {
+      bool taken = false;
+      for (int t = 0; t < w; ++t)
+        taken = taken || (score->worst[t] == minute);
+      if (!taken && (worst < 0 || flips[minute] > flips[worst]))
+        worst = minute;
+    }
+    score->worst[w] = worst;
+  }
+}
+
+int main()
+{
+  FontScore scores[2];
+  scores[0].name = "FreeMonoBold18pt7b";
+  scores[0].font = &FreeMonoBold18pt7b;
+  scores[1].name = "WatchSegment18pt7b";
+  scores[1].font = &WatchSegment18pt7b;
+  for (int f = 0; f < 2; ++f)
+    score_font(&scores[f]);
+
+  printf("%-24s %12s %12s %12s\n", "", scores[0].name, scores[1].name, "change");
+  printf("%-24s %12u %12u %11.1f%%\n", "flipped pixels per day", scores[0].dailyFlips, scores[1].dailyFlips,
+         100.0 * ((double)scores[1].dailyFlips - scores[0].dailyFlips) / scores[0].dailyFlips);
+  printf("%-24s %12.1f %12.1f\n", "per minute (average)", (double)scores[0].dailyFlips / TIME_COUNT,
+         (double)scores[1].dailyFlips / TIME_COUNT);
+  printf("%-24s %12u %12u\n", "per minute (worst)", scores[0].maxFlips, scores[1].maxFlips);
+
+  printf("\ndigit changes\n");
+  static const int CARRIES[][2] = {{9, 0}, {5, 0}, {3, 0}, {2, 0}};
+  for (int d = 0; d < 9; ++d)
+    printf("  %d->%d %29u %12u\n", d, d + 1, scores[0].digitFlips[d][d + 1], scores[1].digitFlips[d][d + 1]);
+  for (unsigned c = 0; c < sizeof(CARRIES) / sizeof(CARRIES[0]); ++c)
+  {
+    int a = CARRIES[c][0], b = CARRIES[c][1];
+    printf("  %d->%d %29u %12u\n", a, b, scores[0].digitFlips[a][b], scores[1].digitFlips[a][b]);
+  }
+
+  printf("\nink per digit\n");
+  for (int d = 0; d < 10; ++d)
+    printf("  %d %33u %12u\n", d, scores[0].ink[d], scores[1].ink[d]);
+
+  for (int f = 0; f < 2; ++f)
+  {
+    printf("\nworst minutes, %s\n", scores[f].name);
+    for (int w = 0; w < WORST_COUNT; ++w)
+    {
+      char previous[16], next[16];
+      format_time(scores[f].worst[w], previous);
+      format_time((scores[f].worst[w] + 1) % TIME_COUNT, next);
+      printf("  %s -> %s %6u\n", previous, next, text_flip_count(scores[f].font, previous, next));
+    }
+  }
+  return 0;
+}
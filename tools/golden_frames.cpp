@@ -0,0 +1,385 @@
+// *****************************************************************************
+// Host tool: golden frame regression over every displayed time.
+// Renders "00:00" to "23:59" in order through the watch's drawing code
+// (src/watch_render.h: layout, regions, rotation 3) on the firmware's
+// GxEPD2_BW (components/watch_display), driving the watch driver and the
+// SSD1681 emulator one wake per minute like setup(): a full refresh first,
+// then a partial refresh of the minutes window, or of hours and minutes on
+// the hour.
+// The renderer is the one the build selects, like watch_config.h does for the
+// watch: FreeMonoBold18pt7b (default), -DDISPLAY_SEGMENT_FONT=1,
+// -DDISPLAY_SEGMENT_RENDER=1, -DDISPLAY_DIGIT_TILES=1 -DDISPLAY_SEGMENT_FONT=1, or
+// the same and -DDISPLAY_DIGIT_TILES_NATIVE=1 (partial wakes write
+// hours and minutes from the native tiles, one RAM window each, as
+// write_region_window() in main.cpp). The golden file holds one set of frames
+// per renderer, under a "[renderer]" line; a build checks and records its own.
+// The sets of the renderers drawn from this repository's data (segment font,
+// segment renderer, tiles) are committed in tools/golden_frames.txt; the
+// [freemono] set is not committed yet, --check of the default build stops
+// with "no [freemono] set" until it is recorded from a known good tree with
+// the library's FreeMonoBold18pt7b installed (and committed).
+// Each frame is what the emulated panel shows, checked against the whole face
+// drawn at once on a canvas (a partial update must not leave stale pixels),
+// hashed (FNV-1a 64 over the pixels) and compared with the golden file;
+// --record writes the build's set into the golden file instead, keeping the
+// other sets (run it on a known good tree, and commit the file with the change
+// that intends to alter the frames).
+// Per frame it also records, with --csv, the render time (host CPU, drawing
+// into the buffer), the refresh window, the SPI bytes and virtual update time
+// of the wake and the pixels that flipped: the cost of each transition.
+// Exits with 2 when a frame differs from its golden hash or from the canvas.
+//
+// Build and run (from the repository root, after a PlatformIO build has
+// installed the libraries, for gfxfont.h and the font), once per renderer:
+//   g++ -std=c++11 -O2 -Isrc -Icomponents/watch_display -Itools/host -I".pio/libdeps/esp32doit-devkit-v1/Adafruit GFX Library" [-DDISPLAY_SEGMENT_RENDER=1 ...] tools/golden_frames.cpp src/GxEPD2_154_D67_Watch.cpp -o golden_frames
+//   ./golden_frames --record tools/golden_frames.txt
+//   ./golden_frames --check tools/golden_frames.txt [--csv frames.csv]
+// *****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+
+#include "ssd1681_emulator.h"
+#include <GxEPD2_BW.h>
+#include "GxEPD2_154_D67_Watch.h"
+#include "watch_render.h"
+
+// Renderer of the build, same precedence as watch_render.h; the font of the text (the other renderers only set it)
+#if DISPLAY_DIGIT_TILES_NATIVE && (!DISPLAY_DIGIT_TILES || DISPLAY_SEGMENT_RENDER)
+#error "DISPLAY_DIGIT_TILES_NATIVE needs DISPLAY_DIGIT_TILES (and not DISPLAY_SEGMENT_RENDER)"
+#endif
+#if DISPLAY_DIGIT_TILES && !DISPLAY_SEGMENT_RENDER && !DISPLAY_SEGMENT_FONT
+#error "DISPLAY_DIGIT_TILES needs DISPLAY_SEGMENT_FONT, as for the watch (main.cpp)"
+#endif
+#if DISPLAY_SEGMENT_RENDER
+#define RENDERER_NAME "segment_render"
+#elif DISPLAY_DIGIT_TILES_NATIVE
+#define RENDERER_NAME "digit_tiles_native"
+#include "DigitTilesNative.h"
+#elif DISPLAY_DIGIT_TILES
+#define RENDERER_NAME "digit_tiles"
+#elif DISPLAY_SEGMENT_FONT
+#define RENDERER_NAME "segment_font"
+#else
+#define RENDERER_NAME "freemono"
+#endif
+#if DISPLAY_SEGMENT_FONT || DISPLAY_SEGMENT_RENDER || DISPLAY_DIGIT_TILES
+#include "WatchSegment18pt7b.h"
+#define WATCH_FONT WatchSegment18pt7b
+#else
+#include <Fonts/FreeMonoBold18pt7b.h>
+#define WATCH_FONT FreeMonoBold18pt7b
+#endif
+
+#define FRAME_COUNT (24 * 60)
+
+// Watch wiring: CS, DC, RST, BUSY
+static const int16_t pinCs = 5, pinDc = 17, pinRst = 16, pinBusy = 4;
+
+/// @brief FNV-1a 64 over the panel pixels (native orientation)
+static uint64_t panel_hash(const Ssd1681Emulator &emulator)
+{
+  uint64_t hash = 0xCBF29CE484222325ULL;
+  for (uint32_t i = 0; i < SSD1681_EMU_WIDTH * SSD1681_EMU_HEIGHT; ++i)
+  {
+    hash ^= emulator.panel[i];
+    hash *= 0x100000001B3ULL;
+  }
+  return hash;
+}
+
+struct FrameRecord
+{
+  uint64_t hash;
+  uint32_t renderMicros;  // host CPU time to draw the regions into the buffer
+  uint32_t updateMicros;  // virtual time of the wake (SPI, BUSY)
+  uint32_t spiBytes;
+  uint32_t flippedPixels; // panel pixels changed from the previous frame
+  uint32_t stalePixels;   // panel pixels that differ from the whole face drawn on a canvas
+  bool fullRefresh;
+  DisplayWindow window;   // rotated coordinates, as passed to setPartialWindow()
+};
+
+static FrameRecord records[FRAME_COUNT];
+static uint64_t golden[FRAME_COUNT];
+static uint8_t previousPanel[SSD1681_EMU_WIDTH * SSD1681_EMU_HEIGHT];
+
+/// @brief Read the set of the build's renderer from a golden file
+/// @return the frames read, FRAME_COUNT for a complete set, 0 when the file has no set of the renderer, -1 when it
+/// can't be opened
+static int read_golden(const char *path)
+{
+  FILE *file = fopen(path, "r");
+  if (!file)
+    return -1;
+  char line[128];
+  int count = 0;
+  bool inSet = false;
+  while (fgets(line, sizeof(line), file))
+  {
+    unsigned int hours, minutes;
+    unsigned long long hash;
+    if (line[0] == '[')
+      inSet = (strncmp(line + 1, RENDERER_NAME "]", strlen(RENDERER_NAME) + 1) == 0);
+    if (!inSet || line[0] == '#' || sscanf(line, "%u:%u %llx", &hours, &minutes, &hash) != 3 || hours >= 24 || minutes >= 60)
+      continue;
+    golden[hours * 60 + minutes] = hash;
+    count++;
+  }
+  fclose(file);
+  return count;
+}
+
+/// @brief Write the golden file: the other renderers' sets as they were, then the build's set
+static bool write_golden(const char *path)
+{
+  std::string kept;
+  FILE *file = fopen(path, "r");
+  if (file)
+  {
+    char line[128];
+    bool inSet = false;
+    while (fgets(line, sizeof(line), file))
+    {
+      if (line[0] == '[')
+        inSet = (strncmp(line + 1, RENDERER_NAME "]", strlen(RENDERER_NAME) + 1) == 0);
+      if (!inSet && line[0] != '#')
+        kept += line;
+    }
+    fclose(file);
+  }
+  file = fopen(path, "w");
+  if (!file)
+    return false;
+  fprintf(file, "# Golden frames (tools/golden_frames.cpp): FNV-1a 64 of the panel pixels after each minute's wake, one set per renderer\n");
+  fputs(kept.c_str(), file);
+  fprintf(file, "[%s]\n", RENDERER_NAME);
+  for (int frame = 0; frame < FRAME_COUNT; ++frame)
+    fprintf(file, "%02d:%02d %016llx\n", frame / 60, frame % 60, (unsigned long long)records[frame].hash);
+  fclose(file);
+  return true;
+}
+
+#if DISPLAY_DIGIT_TILES_NATIVE
+/// @brief Partial wake of the native tiles: the time regions as separate RAM windows, one update over their union
+/// (write_region_window() and update_region_windows() in main.cpp, write each strategy)
+/// @return false when the tiles don't apply to the layout
+static bool write_native_regions(GxEPD2_154_D67_Watch &epd, const DisplayLayout &layout, bool hoursDirty, const char *hoursText, const char *minutesText)
+{
+  DigitTileWrite writes[2][DIGIT_TILE_NATIVE_WRITES_MAX];
+  uint8_t counts[2] = {0, 0};
+  const uint8_t regions[2] = {REGION_HOURS, REGION_MINUTES};
+  DisplayWindow unionPanel = display_window_to_panel(layout.minutes, epd.HEIGHT);
+  for (uint8_t i = hoursDirty ? 0 : 1; i < 2; ++i)
+  {
+    counts[i] = digit_tile_native_plan(digitTilesNative, layout, epd.HEIGHT, regions[i], i ? minutesText : hoursText, writes[i]);
+    if (!counts[i])
+      return false;
+    unionPanel = display_window_union(unionPanel, display_window_to_panel(region_window(layout, regions[i]), epd.HEIGHT));
+  }
+  for (uint8_t i = 0; i < 2; ++i)
+    for (uint8_t j = 0; j < counts[i]; ++j)
+      epd.writeImageBulk(writes[i][j].data, writes[i][j].panel.x, writes[i][j].panel.y, writes[i][j].panel.w, writes[i][j].panel.h);
+  epd.refresh(unionPanel.x, unionPanel.y, unionPanel.w, unionPanel.h);
+  for (uint8_t i = 0; i < 2; ++i)
+    for (uint8_t j = 0; j < counts[i]; ++j)
+      epd.writeImageBulkAgain(writes[i][j].data, writes[i][j].panel.x, writes[i][j].panel.y, writes[i][j].panel.w, writes[i][j].panel.h);
+  return true;
+}
+#endif
+
+int main(int argc, char **argv)
+{
+  const char *recordPath = NULL, *checkPath = NULL, *csvPath = NULL;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+      recordPath = argv[++i];
+    else if (strcmp(argv[i], "--check") == 0 && i + 1 < argc)
+      checkPath = argv[++i];
+    else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc)
+      csvPath = argv[++i];
+    else
+    {
+      fprintf(stderr, "usage: %s (--record path | --check path) [--csv path]\n", argv[0]);
+      return 1;
+    }
+  }
+  if (!recordPath && !checkPath)
+  {
+    fprintf(stderr, "usage: %s (--record path | --check path) [--csv path]\n", argv[0]);
+    return 1;
+  }
+  if (checkPath)
+  {
+    int goldenCount = read_golden(checkPath);
+    if (goldenCount < 0)
+    {
+      fprintf(stderr, "can't open %s\n", checkPath);
+      return 1;
+    }
+    if (goldenCount == 0)
+    {
+      // Nothing to check against: the set is recorded once, from a known good tree with this renderer's font
+      fprintf(stderr, "no [%s] set in %s: record it from a known good tree with %s --record %s%s\n", RENDERER_NAME,
+              checkPath, argv[0], checkPath,
+              DISPLAY_SEGMENT_FONT || DISPLAY_SEGMENT_RENDER || DISPLAY_DIGIT_TILES ? "" :
+              " (built against the library's FreeMonoBold18pt7b, -I<Adafruit GFX Library>)");
+      return 1;
+    }
+    if (goldenCount != FRAME_COUNT)
+    {
+      fprintf(stderr, "can't read %d frames of [%s] from %s (%d found)\n", FRAME_COUNT, RENDERER_NAME, checkPath, goldenCount);
+      return 1;
+    }
+  }
+
+  Ssd1681Emulator emulator(pinCs, pinDc, pinRst, pinBusy);
+  host_attach(&emulator);
+  static GxEPD2_BW<GxEPD2_154_D67_Watch, GxEPD2_154_D67_Watch::HEIGHT> display(GxEPD2_154_D67_Watch(pinCs, pinDc, pinRst, pinBusy));
+
+  GFXcanvas1 canvas(SSD1681_EMU_WIDTH, SSD1681_EMU_HEIGHT); // native orientation, same bit layout as the panel
+  canvas.setRotation(DISPLAY_ROTATION);
+  canvas.setFont(&WATCH_FONT);
+  const uint8_t allRegions = REGION_BIT(REGION_HOURS) | REGION_BIT(REGION_COLON) | REGION_BIT(REGION_MINUTES) |
+                             (POWER_RESERVE_INDICATOR ? REGION_BIT(REGION_POWER_RESERVE) : 0);
+  DisplayLayout layout = {false};
+  int shownHours = -1;
+  const uint8_t powerReserveLevel = POWER_RESERVE_LEVELS;
+  for (int frame = 0; frame < FRAME_COUNT; ++frame)
+  {
+    bool fullRefresh = (frame == 0);
+    int hours = frame / 60, minutes = frame % 60;
+    char hoursText[3], minutesText[3];
+    snprintf(hoursText, sizeof(hoursText), "%02d", hours);
+    snprintf(minutesText, sizeof(minutesText), "%02d", minutes);
+
+    uint32_t bytesBefore = emulator.bytesReceived;
+    uint64_t wakeStart = host_board().micros;
+    display.init(0, fullRefresh, 2, false);
+    display.setRotation(DISPLAY_ROTATION);
+    display.setFont(&WATCH_FONT);
+    display.setTextColor(GxEPD_BLACK);
+    if (!layout.valid)
+      display_layout_measure(display, &WATCH_FONT, &layout);
+
+    // Same regions and window as setup() with the union window strategy
+    bool hoursDirty = fullRefresh || (hours != shownHours);
+    uint8_t regionMask = (hoursDirty ? REGION_BIT(REGION_HOURS) : 0) | REGION_BIT(REGION_MINUTES) |
+                         (hoursDirty ? REGION_BIT(REGION_COLON) : 0) |
+                         ((fullRefresh && POWER_RESERVE_INDICATOR) ? REGION_BIT(REGION_POWER_RESERVE) : 0);
+    DisplayWindow window = hoursDirty ? display_window_union(layout.hours, layout.minutes) : layout.minutes;
+    if (fullRefresh)
+    {
+      display.setFullWindow();
+      window.x = 0;
+      window.y = 0;
+      window.w = display.width();
+      window.h = display.height();
+    }
+    else
+      display.setPartialWindow(window.x, window.y, window.w, window.h);
+
+    uint32_t renderMicros = 0;
+#if DISPLAY_DIGIT_TILES_NATIVE
+    if (!fullRefresh)
+    {
+      // Hours and minutes from flash, no buffer to render
+      if (!write_native_regions(display.epd2, layout, hoursDirty, hoursText, minutesText))
+      {
+        fprintf(stderr, "%02d:%02d: the native tiles don't fit the layout\n", hours, minutes);
+        return 1;
+      }
+    }
+    else
+#endif
+    {
+      std::chrono::steady_clock::time_point renderStart = std::chrono::steady_clock::now();
+      display.firstPage();
+      draw_regions(display, layout, hoursText, minutesText, powerReserveLevel, regionMask, false);
+      renderMicros = (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - renderStart).count();
+      display.nextPage();
+    }
+    display.hibernate();
+    shownHours = hours;
+
+    FrameRecord &record = records[frame];
+    record.hash = panel_hash(emulator);
+    record.renderMicros = renderMicros;
+    record.updateMicros = (uint32_t)(host_board().micros - wakeStart);
+    record.spiBytes = emulator.bytesReceived - bytesBefore;
+    record.fullRefresh = fullRefresh;
+    record.window = window;
+    record.flippedPixels = 0;
+    for (uint32_t i = 0; i < SSD1681_EMU_WIDTH * SSD1681_EMU_HEIGHT; ++i)
+      record.flippedPixels += (emulator.panel[i] != previousPanel[i]);
+    memcpy(previousPanel, emulator.panel, sizeof(previousPanel));
+    canvas.fillScreen(GxEPD_WHITE);
+    draw_regions(canvas, layout, hoursText, minutesText, powerReserveLevel, allRegions, false);
+    record.stalePixels = 0;
+    for (uint16_t y = 0; y < SSD1681_EMU_HEIGHT; ++y)
+      for (uint16_t x = 0; x < SSD1681_EMU_WIDTH; ++x)
+        record.stalePixels += (emulator.pixel(x, y) != ((canvas.getBuffer()[y * SSD1681_EMU_RAM_PITCH + x / 8] >> (7 - x % 8)) & 1));
+
+    host_advance(60000000ULL); // the MCU sleeps until the next minute
+  }
+
+  // Compare or record
+  uint32_t mismatches = 0, staleFrames = 0;
+  uint64_t renderTotal = 0;
+  uint32_t renderMax = 0;
+  for (int frame = 0; frame < FRAME_COUNT; ++frame)
+  {
+    renderTotal += records[frame].renderMicros;
+    if (records[frame].renderMicros > renderMax)
+      renderMax = records[frame].renderMicros;
+    if (records[frame].stalePixels)
+    {
+      if (staleFrames < 10)
+        printf("%02d:%02d: %u pixels differ from the face drawn on a canvas\n", frame / 60, frame % 60, records[frame].stalePixels);
+      staleFrames++;
+    }
+    if (checkPath && records[frame].hash != golden[frame])
+    {
+      if (mismatches < 10)
+        printf("%02d:%02d differs: %016llx, golden %016llx\n", frame / 60, frame % 60,
+               (unsigned long long)records[frame].hash, (unsigned long long)golden[frame]);
+      mismatches++;
+    }
+  }
+  if (recordPath && !write_golden(recordPath))
+  {
+    fprintf(stderr, "can't write %s\n", recordPath);
+    return 1;
+  }
+  if (csvPath)
+  {
+    FILE *file = fopen(csvPath, "w");
+    if (!file)
+    {
+      fprintf(stderr, "can't write %s\n", csvPath);
+      return 1;
+    }
+    fprintf(file, "time,hash,match,full,render_us,update_us,spi_bytes,flipped_px,stale_px,window_x,window_y,window_w,window_h\n");
+    for (int frame = 0; frame < FRAME_COUNT; ++frame)
+    {
+      const FrameRecord &record = records[frame];
+      fprintf(file, "%02d:%02d,%016llx,%d,%d,%u,%u,%u,%u,%u,%d,%d,%u,%u\n", frame / 60, frame % 60, (unsigned long long)record.hash,
+              checkPath ? (record.hash == golden[frame]) : 1, record.fullRefresh, record.renderMicros, record.updateMicros,
+              record.spiBytes, record.flippedPixels, record.stalePixels, record.window.x, record.window.y, record.window.w, record.window.h);
+    }
+    fclose(file);
+  }
+
+  printf("renderer %s, frames %d, render %.1f us average, %u us max\n", RENDERER_NAME, FRAME_COUNT, (double)renderTotal / FRAME_COUNT, renderMax);
+  printf("errors: busy %u, deep sleep %u, unknown %u, extra parameters %u, no analog %u, outside RAM %u\n",
+         emulator.errors.bytesWhileBusy, emulator.errors.bytesInDeepSleep, emulator.errors.unknownCommands,
+         emulator.errors.extraParameters, emulator.errors.displayWithoutAnalog, emulator.errors.ramOutsideWindow);
+  printf("%u frames differ from the canvas\n", staleFrames);
+  if (checkPath)
+    printf("%u of %d frames differ from [%s] in %s\n", mismatches, FRAME_COUNT, RENDERER_NAME, checkPath);
+  return (mismatches || staleFrames) ? 2 : 0;
+}
@@ -0,0 +1,144 @@
+// *****************************************************************************
+// Host stand-in of the Arduino core, for the host tools that run the watch's
+// display code (src/GxEPD2_154_D67_Watch.cpp) on the PC.
+// Only what the display code uses: pins, SPI, a virtual clock, Serial.
+// Pin writes, SPI bytes and pin reads go to the HostPeripheral attached with
+// host_attach() (e.g. the SSD1681 emulator), time only advances when the code
+// waits (delay(), BUSY polling) or sends bytes.
+// Header only, like the tools: each tool is still a single source file plus
+// the sources of src it runs.
+// *****************************************************************************
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+#include "watch_config.h"
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+// ESP32 VSPI defaults, as on the watch
+#define SS 5
+#define SCK 18
+#define MISO 19
+#define MOSI 23
+
+#define PROGMEM
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define IRAM_ATTR
+
+/// @brief Something on the host bus: gets pin changes and SPI bytes, drives the pins it owns
+class HostPeripheral
+{
+public:
+  virtual ~HostPeripheral() {}
+  virtual void pinWrite(int16_t pin, uint8_t level, uint64_t now) = 0;
+  virtual int pinRead(int16_t pin, uint64_t now) = 0;
+  virtual void spiByte(uint8_t value, uint64_t now) = 0;
+};
+
+/// @brief Pin levels, attached peripheral and virtual clock
+struct HostBoard
+{
+  HostPeripheral *peripheral;
+  uint64_t micros;
+  uint8_t levels[64];
+  uint8_t modes[64];
+  uint32_t spiByteNs; // Time of one SPI byte, see REFRESH_COST_SPI_BYTE_NS
+};
+
+inline HostBoard &host_board()
+{
+  static HostBoard board = {NULL, 0, {0}, {0}, REFRESH_COST_SPI_BYTE_NS};
+  return board;
+}
+
+inline void host_attach(HostPeripheral *peripheral)
+{
+  host_board().peripheral = peripheral;
+}
+
+/// @brief Advance the virtual clock
+inline void host_advance(uint64_t micros)
+{
+  host_board().micros += micros;
+}
+
+inline uint32_t micros()
+{
+  return (uint32_t)host_board().micros;
+}
+
+inline uint32_t millis()
+{
+  return (uint32_t)(host_board().micros / 1000);
+}
+
+inline void delay(uint32_t ms)
+{
+  host_advance((uint64_t)ms * 1000);
+}
+
+inline void delayMicroseconds(uint32_t us)
+{
+  host_advance(us);
+}
+
+inline void yield()
+{
+}
+
+inline void pinMode(int16_t pin, uint8_t mode)
+{
+  if (pin >= 0 && pin < 64)
+    host_board().modes[pin] = mode;
+}
+
+inline void digitalWrite(int16_t pin, uint8_t level)
+{
+  HostBoard &board = host_board();
+  if (pin < 0 || pin >= 64)
+    return;
+  board.levels[pin] = level ? HIGH : LOW;
+  if (board.peripheral)
+    board.peripheral->pinWrite(pin, board.levels[pin], board.micros);
+}
+
+inline int digitalRead(int16_t pin)
+{
+  HostBoard &board = host_board();
+  if (board.peripheral)
+    return board.peripheral->pinRead(pin, board.micros);
+  return (pin >= 0 && pin < 64) ? board.levels[pin] : LOW;
+}
+
+/// @brief Serial stand-in, prints to stdout
+class HostSerial
+{
+public:
+  void begin(uint32_t) {}
+  void print(const char *text) { fputs(text, stdout); }
+  void println(const char *text = "") { puts(text); }
+  void println(int value) { printf("%d\n", value); }
+  int printf(const char *format, ...)
+  {
+    va_list args;
+    va_start(args, format);
+    int n = vprintf(format, args);
+    va_end(args);
+    return n;
+  }
+};
+
+static HostSerial Serial;
+
+#endif
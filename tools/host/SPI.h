@@ -0,0 +1,50 @@
+// *****************************************************************************
+// Host stand-in of the Arduino SPI library: bytes go to the HostPeripheral
+// attached to the host board (see Arduino.h), each one costs spiByteNs of
+// virtual time.
+// *****************************************************************************
+
+#ifndef HOST_SPI_H
+#define HOST_SPI_H
+
+#include "Arduino.h"
+
+#define MSBFIRST 1
+#define SPI_MODE0 0
+
+class SPISettings
+{
+public:
+  SPISettings() {}
+  SPISettings(uint32_t, uint8_t, uint8_t) {}
+};
+
+class SPIClass
+{
+public:
+  void begin() {}
+  void end() {}
+  void beginTransaction(SPISettings) {}
+  void endTransaction() {}
+  uint8_t transfer(uint8_t value)
+  {
+    HostBoard &board = host_board();
+    // Fractions of a microsecond add up in nanoseconds
+    static uint32_t nanos = 0;
+    nanos += board.spiByteNs;
+    host_advance(nanos / 1000);
+    nanos %= 1000;
+    if (board.peripheral)
+      board.peripheral->spiByte(value, board.micros);
+    return 0;
+  }
+  void writeBytes(const uint8_t *data, uint32_t size)
+  {
+    for (uint32_t i = 0; i < size; ++i)
+      transfer(data[i]);
+  }
+};
+
+static SPIClass SPI;
+
+#endif
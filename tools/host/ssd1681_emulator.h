@@ -0,0 +1,531 @@
+// *****************************************************************************
+// Host model of the SSD1681 controller (GDEH0154D67, HINK-E154A07-A1), driven
+// by the same pins and SPI bytes the watch driver sends (see Arduino.h):
+// - command decoder with the parameter count of each command
+// - both RAM banks (0x24 new, 0x26 old), RAM window (0x44/0x45), address
+//   counters (0x4E/0x4F) and the 4 data entry modes, X or Y first (0x11)
+// - display update control 2 sequences (0x22/0x20): clock, analog, temperature,
+//   LUT from OTP or registers (0x32), display mode 1 or 2
+// - hardware and software reset, deep sleep mode 1 (RAM kept) and 2
+// - BUSY timing from Ssd1681EmulatorTiming and the LUT timing (ssd1681_lut.h)
+// - temperature register, readable with the 3 wire read (0x1B)
+// The visible panel state follows the refreshes: display mode 1 drives every
+// pixel, display mode 2 only the pixels whose (old, new) LUT drives a voltage.
+// Assumptions, not from the datasheet: display mode 2 copies the new RAM to
+// the old RAM (as GxEPD2_154_D67_Watch's single RAM write mode relies on), the
+// temperature register resets to 0x7FF, BUSY durations are rough figures.
+// Protocol misuse (bytes while BUSY or in deep sleep, unknown commands, extra
+// parameters, display without analog) is counted, not fatal.
+// Header only, for the host tools.
+// *****************************************************************************
+
+#ifndef SSD1681_EMULATOR_H
+#define SSD1681_EMULATOR_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include <Arduino.h>
+#include "ssd1681_lut.h"
+#include "watch_config.h"
+
+#define SSD1681_EMU_WIDTH 200
+#define SSD1681_EMU_HEIGHT 200
+#define SSD1681_EMU_RAM_PITCH (SSD1681_EMU_WIDTH / 8)
+#define SSD1681_EMU_RAM_SIZE (SSD1681_EMU_RAM_PITCH * SSD1681_EMU_HEIGHT)
+#define SSD1681_EMU_TEMPERATURE_RESET 0x7FF
+
+/// @brief BUSY durations, microseconds (rough figures, calibrate against the GxEPD2 diagnostic output)
+struct Ssd1681EmulatorTiming
+{
+  uint32_t softwareReset;
+  uint32_t hardwareReset;
+  uint32_t analogOn;
+  uint32_t analogOff;
+  uint32_t loadTemperature;
+  uint32_t loadLut;
+  uint32_t otpFull;    // Display mode 1 with the OTP waveform
+  uint32_t otpPartial; // Display mode 2 with the OTP waveform
+};
+
+static const Ssd1681EmulatorTiming SSD1681_EMU_DEFAULT_TIMING = {
+    2000, 1000, 80000, 20000, 10000, 10000, REFRESH_COST_FULL_MS * 1000UL, REFRESH_COST_PARTIAL_MS * 1000UL};
+
+/// @brief One master activation (0x20)
+struct Ssd1681Activation
+{
+  uint64_t start;
+  uint32_t busyMicros;
+  uint8_t sequence;       // Display update control 2 value
+  bool display;           // The sequence drove the panel
+  bool mode2;             // Display mode 2 (differential)
+  bool registerLut;       // Waveform from the LUT registers, not the OTP
+  uint32_t drivenPixels;  // Pixels that got a drive voltage
+  uint32_t changedPixels; // Pixels whose visible state changed
+};
+
+/// @brief Protocol misuse counters
+struct Ssd1681Errors
+{
+  uint32_t bytesWhileBusy;
+  uint32_t bytesInDeepSleep;
+  uint32_t unknownCommands;
+  uint32_t extraParameters;
+  uint32_t displayWithoutAnalog;
+  uint32_t ramOutsideWindow;
+};
+
+class Ssd1681Emulator : public HostPeripheral
+{
+public:
+  Ssd1681Emulator(int16_t cs, int16_t dc, int16_t rst, int16_t busy)
+      : timing(SSD1681_EMU_DEFAULT_TIMING), ambientTemperature(25 * 16), readable(true), copyNewToOld(true)
+  {
+    _cs = cs;
+    _dc = dc;
+    _rst = rst;
+    _busy = busy;
+    memset(ram, 0xFF, sizeof(ram));
+    memset(panel, 1, sizeof(panel));
+    memset(&errors, 0, sizeof(errors));
+    memset(commandBytes, 0, sizeof(commandBytes));
+    _csLevel = HIGH;
+    _dcLevel = HIGH;
+    _rstLevel = HIGH;
+    _sckLevel = LOW;
+    _deepSleep = 0;
+    _busyUntil = 0;
+    _resetRegisters();
+  }
+
+  // HostPeripheral
+  void pinWrite(int16_t pin, uint8_t level, uint64_t now)
+  {
+    if (pin == _cs)
+    {
+      if (level == LOW && _csLevel == HIGH)
+        _readBit = 0;
+      _csLevel = level;
+    }
+    else if (pin == _dc)
+      _dcLevel = level;
+    else if (pin == _rst)
+    {
+      if (level == HIGH && _rstLevel == LOW)
+        _hardwareReset(now);
+      _rstLevel = level;
+    }
+    else if (pin == SCK)
+    {
+      // 3 wire read: the controller shifts out a bit on each rising edge
+      if (level == HIGH && _sckLevel == LOW && _csLevel == LOW && _dcLevel == HIGH)
+      {
+        _readLevel = (_readValue >> (15 - (_readBit % 16))) & 1;
+        _readBit++;
+        if (_readBit % 8 == 0)
+          bytesRead++;
+      }
+      _sckLevel = level;
+    }
+  }
+
+  int pinRead(int16_t pin, uint64_t now)
+  {
+    if (pin == _busy)
+      return (_deepSleep || now < _busyUntil) ? HIGH : LOW;
+    if (pin == MOSI)
+      return readable ? _readLevel : HIGH; // a write only bus floats high
+    return LOW;
+  }
+
+  void spiByte(uint8_t value, uint64_t now)
+  {
+    if (_csLevel != LOW)
+      return;
+    bytesReceived++;
+    if (_deepSleep)
+    {
+      errors.bytesInDeepSleep++;
+      return;
+    }
+    if (now < _busyUntil)
+    {
+      errors.bytesWhileBusy++;
+      return;
+    }
+    if (_dcLevel == LOW)
+      _command(value, now);
+    else
+      _data(value, now);
+  }
+
+  /// @brief Pixels of the panel (1 white, 0 black), native orientation
+  uint8_t pixel(uint16_t x, uint16_t y) const
+  {
+    return panel[y * SSD1681_EMU_WIDTH + x];
+  }
+
+  /// @brief Pixels of a RAM bank, native orientation
+  uint8_t ramPixel(uint8_t bank, uint16_t x, uint16_t y) const
+  {
+    return (ram[bank][y * SSD1681_EMU_RAM_PITCH + x / 8] >> (7 - x % 8)) & 1;
+  }
+
+  /// @brief Write the visible panel to a binary PBM, as seen with setRotation(rotation)
+  /// @param path
+  /// @param rotation 0 (native) or 3 (the watch)
+  /// @return false if the file can't be written
+  bool writePbm(const char *path, uint8_t rotation) const
+  {
+    FILE *file = fopen(path, "wb");
+    if (!file)
+      return false;
+    fprintf(file, "P4\n%d %d\n", SSD1681_EMU_WIDTH, SSD1681_EMU_HEIGHT);
+    for (uint16_t y = 0; y < SSD1681_EMU_HEIGHT; ++y)
+    {
+      for (uint16_t xb = 0; xb < SSD1681_EMU_WIDTH / 8; ++xb)
+      {
+        uint8_t byte = 0;
+        for (uint8_t bit = 0; bit < 8; ++bit)
+        {
+          uint16_t x = xb * 8 + bit;
+          // Rotation 3: panel x = y, panel y = HEIGHT - 1 - x
+          uint8_t white = (rotation == 3) ? pixel(y, SSD1681_EMU_HEIGHT - 1 - x) : pixel(x, y);
+          byte |= (white ? 0 : 1) << (7 - bit); // PBM: 1 is black
+        }
+        fputc(byte, file);
+      }
+    }
+    fclose(file);
+    return true;
+  }
+
+  bool deepSleep() const
+  {
+    return _deepSleep != 0;
+  }
+
+  /// @brief Supply lost while the MCU slept (brown out, panel unplugged): registers at their reset values, RAM
+  /// undefined, no reset pulse seen
+  void loseState()
+  {
+    memset(ram, 0x55, sizeof(ram));
+    _deepSleep = 0;
+    _resetRegisters();
+  }
+
+public:
+  Ssd1681EmulatorTiming timing;
+  uint16_t ambientTemperature; // What the built-in sensor reads, 1/16 degree C
+  bool readable;               // The data line can be read back (3 wire)
+  bool copyNewToOld;           // Display mode 2 copies the new RAM to the old RAM
+  uint8_t ram[2][SSD1681_EMU_RAM_SIZE]; // 0: new (0x24), 1: old (0x26)
+  uint8_t panel[SSD1681_EMU_WIDTH * SSD1681_EMU_HEIGHT];
+  std::vector<Ssd1681Activation> activations;
+  Ssd1681Errors errors;
+  uint32_t bytesReceived = 0;
+  uint32_t bytesRead = 0;     // Bytes clocked out by 3 wire reads
+  uint32_t commandBytes[256]; // Bytes (command and parameters) per command
+  uint32_t hardwareResets = 0;
+  uint32_t softwareResets = 0;
+  uint16_t temperature;       // Temperature register
+
+private:
+  /// @brief Parameter bytes of each command, -1 for RAM writes (any), 0 for none or reads
+  static int16_t _parameterCount(uint8_t command)
+  {
+    switch (command)
+    {
+    case 0x12: case 0x1B: case 0x20: case 0x28: case 0x2D: case 0x2E: case 0x2F: case 0x36: case 0x7F:
+      return 0;
+    case 0x03: case 0x10: case 0x11: case 0x14: case 0x15: case 0x18: case 0x22: case 0x29: case 0x2C:
+    case 0x39: case 0x3C: case 0x3F: case 0x41: case 0x46: case 0x47: case 0x4E:
+      return 1;
+    case 0x1A: case 0x21: case 0x44: case 0x4F:
+      return 2;
+    case 0x01: case 0x04: case 0x1C:
+      return 3;
+    case 0x0C: case 0x45:
+      return 4;
+    case 0x37: case 0x38:
+      return 10;
+    case 0x32:
+      return SSD1681_LUT_SIZE;
+    case 0x24: case 0x26:
+      return -1;
+    default:
+      return -2; // unknown
+    }
+  }
+
+  void _resetRegisters()
+  {
+    _entryMode = 0x03;
+    _xStart = 0;
+    _xEnd = SSD1681_EMU_RAM_PITCH - 1;
+    _yStart = 0;
+    _yEnd = SSD1681_EMU_HEIGHT - 1;
+    _xCounter = 0;
+    _yCounter = 0;
+    _updateControl2 = 0xFF;
+    _clockOn = false;
+    _analogOn = false;
+    _registerLutValid = false;
+    _otpLutLoaded = false;
+    temperature = SSD1681_EMU_TEMPERATURE_RESET;
+    _currentCommand = -1;
+    _parameterIndex = 0;
+    _readValue = 0xFFFF;
+    _readLevel = HIGH;
+  }
+
+  void _hardwareReset(uint64_t now)
+  {
+    hardwareResets++;
+    if (_deepSleep == 2)
+      memset(ram, 0x55, sizeof(ram)); // deep sleep mode 2 doesn't keep the RAM
+    _deepSleep = 0;
+    _resetRegisters();
+    _busyUntil = now + timing.hardwareReset;
+  }
+
+  void _command(uint8_t command, uint64_t now)
+  {
+    commandBytes[command]++;
+    _currentCommand = command;
+    _parameterIndex = 0;
+    int16_t count = _parameterCount(command);
+    if (count == -2)
+    {
+      errors.unknownCommands++;
+      return;
+    }
+    switch (command)
+    {
+    case 0x12: // software reset: registers, not the RAM
+      softwareResets++;
+      _resetRegisters();
+      _busyUntil = now + timing.softwareReset;
+      break;
+    case 0x1B: // read temperature register, left aligned 12 bits
+      _readValue = (uint16_t)(temperature << 4);
+      break;
+    case 0x20:
+      _activate(now);
+      break;
+    case 0x24:
+    case 0x26:
+      _xCounterRam = _xCounter;
+      _yCounterRam = _yCounter;
+      break;
+    }
+  }
+
+  void _data(uint8_t value, uint64_t now)
+  {
+    if (_currentCommand < 0)
+    {
+      errors.extraParameters++;
+      return;
+    }
+    uint8_t command = (uint8_t)_currentCommand;
+    commandBytes[command]++;
+    int16_t count = _parameterCount(command);
+    if (count == -1)
+    {
+      _writeRam(command == 0x24 ? 0 : 1, value);
+      return;
+    }
+    if (count < 0 || _parameterIndex >= count)
+    {
+      errors.extraParameters++;
+      return;
+    }
+    _parameters[_parameterIndex < (int16_t)sizeof(_parameters) ? _parameterIndex : sizeof(_parameters) - 1] = value;
+    if (command == 0x32)
+      _registerLut[_parameterIndex] = value;
+    _parameterIndex++;
+    if (_parameterIndex == count)
+      _apply(command, now);
+  }
+
+  void _apply(uint8_t command, uint64_t now)
+  {
+    switch (command)
+    {
+    case 0x10:
+      _deepSleep = _parameters[0] & 0x03;
+      break;
+    case 0x11:
+      _entryMode = _parameters[0] & 0x07;
+      break;
+    case 0x1A:
+      temperature = ((uint16_t)_parameters[0] << 4) | (_parameters[1] >> 4);
+      break;
+    case 0x22:
+      _updateControl2 = _parameters[0];
+      break;
+    case 0x32:
+      _registerLutValid = true;
+      break;
+    case 0x44:
+      _xStart = _parameters[0] & 0x1F;
+      _xEnd = _parameters[1] & 0x1F;
+      break;
+    case 0x45:
+      _yStart = _parameters[0] | ((_parameters[1] & 0x01) << 8);
+      _yEnd = _parameters[2] | ((_parameters[3] & 0x01) << 8);
+      break;
+    case 0x4E:
+      _xCounter = _parameters[0] & 0x1F;
+      break;
+    case 0x4F:
+      _yCounter = _parameters[0] | ((_parameters[1] & 0x01) << 8);
+      break;
+    }
+  }
+
+  /// @brief Store a RAM byte at the address counter, then step it through the window
+  void _writeRam(uint8_t bank, uint8_t value)
+  {
+    if (_xCounterRam < SSD1681_EMU_RAM_PITCH && _yCounterRam < SSD1681_EMU_HEIGHT)
+      ram[bank][_yCounterRam * SSD1681_EMU_RAM_PITCH + _xCounterRam] = value;
+    else
+      errors.ramOutsideWindow++;
+
+    bool xIncrement = _entryMode & 0x01;
+    bool yIncrement = _entryMode & 0x02;
+    bool yFirst = _entryMode & 0x04;
+    if (!yFirst)
+    {
+      if (_step(&_xCounterRam, _xStart, _xEnd, xIncrement))
+        _step(&_yCounterRam, _yStart, _yEnd, yIncrement);
+    }
+    else
+    {
+      if (_step(&_yCounterRam, _yStart, _yEnd, yIncrement))
+        _step(&_xCounterRam, _xStart, _xEnd, xIncrement);
+    }
+  }
+
+  /// @brief Step a counter towards the window end, back to the start past it
+  /// @return true when it wrapped
+  static bool _step(uint16_t *counter, uint16_t start, uint16_t end, bool increment)
+  {
+    if (*counter == end)
+    {
+      *counter = start;
+      return true;
+    }
+    *counter = increment ? *counter + 1 : *counter - 1;
+    return false;
+  }
+
+  /// @brief Master activation: run the display update control 2 sequence
+  void _activate(uint64_t now)
+  {
+    Ssd1681Activation activation = {now, 0, _updateControl2, false, false, false, 0, 0};
+    uint8_t sequence = _updateControl2;
+    uint32_t busy = 0;
+    if (sequence & 0x80)
+      _clockOn = true;
+    if ((sequence & 0x40) && !_analogOn)
+    {
+      _analogOn = true;
+      busy += timing.analogOn;
+    }
+    if (sequence & 0x20)
+    {
+      temperature = ambientTemperature;
+      busy += timing.loadTemperature;
+    }
+    if (sequence & 0x10)
+    {
+      _otpLutLoaded = true;
+      busy += timing.loadLut;
+    }
+    if (sequence & 0x04)
+    {
+      activation.display = true;
+      activation.mode2 = (sequence & 0x08) != 0;
+      activation.registerLut = !(sequence & 0x10) && _registerLutValid;
+      if (!_analogOn || !_clockOn)
+        errors.displayWithoutAnalog++;
+      else
+        busy += _display(&activation);
+    }
+    if ((sequence & 0x02) && _analogOn)
+    {
+      _analogOn = false;
+      busy += timing.analogOff;
+    }
+    if (sequence & 0x01)
+      _clockOn = false;
+    activation.busyMicros = busy;
+    activations.push_back(activation);
+    _busyUntil = now + busy;
+  }
+
+  /// @brief Drive the panel from the RAM banks
+  /// @return Drive duration
+  uint32_t _display(Ssd1681Activation *activation)
+  {
+    bool drives[4] = {true, true, true, true}; // Per (old, new) LUT: B->B, B->W, W->B, W->W
+    uint32_t duration = activation->mode2 ? timing.otpPartial : timing.otpFull;
+    if (activation->registerLut)
+    {
+      Ssd1681LutTiming lutTiming = ssd1681_lut_timing(_registerLut);
+      for (uint8_t i = 0; i < 4; ++i)
+        drives[i] = lutTiming.drivenFrames[i] > 0;
+      duration = (uint32_t)(lutTiming.milliseconds * 1000);
+    }
+    else if (activation->mode2)
+    {
+      // OTP display mode 2 waveform: unchanged pixels are left alone
+      drives[0] = false;
+      drives[3] = false;
+    }
+
+    for (uint16_t y = 0; y < SSD1681_EMU_HEIGHT; ++y)
+    {
+      for (uint16_t x = 0; x < SSD1681_EMU_WIDTH; ++x)
+      {
+        uint8_t next = ramPixel(0, x, y);
+        uint8_t old = activation->mode2 ? ramPixel(1, x, y) : panel[y * SSD1681_EMU_WIDTH + x];
+        bool driven = activation->mode2 ? drives[old * 2 + next] : true;
+        if (!driven)
+          continue;
+        activation->drivenPixels++;
+        if (panel[y * SSD1681_EMU_WIDTH + x] != next)
+          activation->changedPixels++;
+        panel[y * SSD1681_EMU_WIDTH + x] = next;
+      }
+    }
+    if (activation->mode2 && copyNewToOld)
+      memcpy(ram[1], ram[0], SSD1681_EMU_RAM_SIZE);
+    return duration;
+  }
+
+  int16_t _cs, _dc, _rst, _busy;
+  uint8_t _csLevel, _dcLevel, _rstLevel, _sckLevel;
+  uint8_t _deepSleep; // Deep sleep mode, 0: awake
+  uint64_t _busyUntil;
+  uint8_t _entryMode;
+  uint16_t _xStart, _xEnd, _yStart, _yEnd; // RAM window, x in bytes
+  uint16_t _xCounter, _yCounter;           // Address counter registers
+  uint16_t _xCounterRam, _yCounterRam;     // Address counter during a RAM write
+  uint8_t _updateControl2;
+  bool _clockOn, _analogOn;
+  bool _registerLutValid, _otpLutLoaded;
+  uint8_t _registerLut[SSD1681_LUT_SIZE];
+  int16_t _currentCommand;
+  int16_t _parameterIndex;
+  uint8_t _parameters[16];
+  uint16_t _readValue;
+  uint8_t _readLevel;
+  uint16_t _readBit;
+};
+
+#endif
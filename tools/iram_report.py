@@ -0,0 +1,79 @@
+# *****************************************************************************
+# Build step: IRAM report. After the link, prints the IRAM the firmware takes
+# (.iram0.vectors and .iram0.text of the ELF, out of the 128 KiB of the ESP32
+# IRAM0) and the functions of the project placed there by WATCH_HOT
+# (WAKE_HOT_IRAM, see watch_config.h), from the .iram1 sections of the
+# project objects, with their total: the IRAM cost of the wake path's inner
+# loops (WATCH_HOT functions are never inlined into a flash caller).
+# Only project code is measured and moved: the library code of the wake path
+# (GxEPD2_EPD's SPI primitives and BUSY wait, the SPI driver, Adafruit GFX
+# text drawing) stays in flash, the report says so.
+#
+# As a PlatformIO extra script (platformio.ini):
+#   extra_scripts = post:tools/iram_report.py
+#
+# On the host, same report from a build (toolchain objdump):
+#   python3 tools/iram_report.py <objdump> <firmware.elf> <object>...
+# *****************************************************************************
+
+import glob
+import os
+import re
+import subprocess
+import sys
+
+IRAM0_BYTES = 128 * 1024
+IRAM0_SECTIONS = (".iram0.vectors", ".iram0.text")
+
+
+def _run(objdump, args, environment=None):
+    return subprocess.run([objdump] + args, stdout=subprocess.PIPE, stderr=subprocess.PIPE, universal_newlines=True, env=environment,
+                          check=True).stdout
+
+
+def elf_iram_bytes(objdump, elf, environment=None):
+    """Bytes of the IRAM0 sections of the firmware"""
+    total = 0
+    for line in _run(objdump, ["-h", elf], environment).splitlines():
+        fields = line.split()
+        if len(fields) >= 3 and fields[1] in IRAM0_SECTIONS:
+            total += int(fields[2], 16)
+    return total
+
+
+def hot_functions(objdump, objects, environment=None):
+    """(name, bytes) of the functions in .iram1 sections of the objects, largest first"""
+    functions = []
+    for path in objects:
+        for line in _run(objdump, ["-t", "-C", path], environment).splitlines():
+            # 00000000 g     F .iram1.5	0000003c setup
+            match = re.match(r"^[0-9a-fA-F]+\s.*\sF\s+(\.iram1\S*)\s+([0-9a-fA-F]+)\s+(.*)$", line)
+            if match:
+                functions.append((match.group(3).strip(), int(match.group(2), 16)))
+    return sorted(functions, key=lambda function: -function[1])
+
+
+def report(objdump, elf, objects, environment=None):
+    functions = hot_functions(objdump, objects, environment)
+    hot = sum(size for _, size in functions)
+    for name, size in functions:
+        print("IRAM hot path: %6d %s" % (size, name))
+    used = elf_iram_bytes(objdump, elf, environment)
+    print("IRAM hot path: %d functions, %d bytes; IRAM0 used %d of %d bytes (%d free)" % (len(functions), hot, used, IRAM0_BYTES,
+                                                                                          IRAM0_BYTES - used))
+    print("IRAM hot path: project inner loops only; library code (GxEPD2_EPD, SPI, Adafruit GFX) stays in flash")
+
+
+if "Import" not in globals():
+    if len(sys.argv) < 3:
+        sys.exit("usage: %s <objdump> <firmware.elf> <object>..." % sys.argv[0])
+    report(sys.argv[1], sys.argv[2], sys.argv[3:])
+else:
+    Import("env")  # noqa: F821 (PlatformIO SCons environment)
+
+    def _after_link(source, target, env):
+        objdump = env.subst("$CC").replace("gcc", "objdump")
+        objects = glob.glob(os.path.join(env.subst("$BUILD_DIR"), "src", "*.o"))
+        report(objdump, target[0].get_abspath(), objects, dict(env["ENV"]))
+
+    env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", _after_link)  # noqa: F821
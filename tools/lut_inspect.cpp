@@ -0,0 +1,62 @@
+// *****************************************************************************
+// Host tool: decodes the SSD1681 waveforms in src/ssd1681_lut.h and estimates
+// their phase count and refresh time, to check a tuned LUT before flashing it.
+//
+// Build and run (from the repository root):
+//   g++ -std=c++11 -O2 -Isrc tools/lut_inspect.cpp -o lut_inspect
+//   ./lut_inspect
+// *****************************************************************************
+
+#include <stdio.h>
+
+#include "ssd1681_lut.h"
+
+static const char *voltageNames[4] = {"VSS ", "VSH1", "VSL ", "VSH2"};
+static const char *lutNames[SSD1681_LUT_COUNT] = {"B->B", "B->W", "W->B", "W->W", "LUT4"};
+
+/// @brief Print the decoded waveform and its timing
+/// @param name
+/// @param lut
+/// @return Timing
+static Ssd1681LutTiming inspect(const char *name, const uint8_t *lut)
+{
+  printf("== %s\n", name);
+  printf("group  TPA TPB SRAB TPC TPD SRCD  RP   FR");
+  for (uint8_t lutIndex = 0; lutIndex < SSD1681_LUT_COUNT; ++lutIndex)
+    printf("  %-19s", lutNames[lutIndex]);
+  printf("\n");
+  for (uint8_t group = 0; group < SSD1681_LUT_GROUPS; ++group)
+  {
+    const uint8_t *tp = &lut[60 + group * 7];
+    if (tp[0] == 0 && tp[1] == 0 && tp[3] == 0 && tp[4] == 0)
+      continue;
+    uint8_t fr = lut[144 + group / 2];
+    fr = (group % 2 == 0) ? (fr >> 4) : (fr & 0x0F);
+    printf("%5u  %3u %3u %4u %3u %3u %4u %3u %4.0f", group, tp[0], tp[1], tp[2], tp[3], tp[4], tp[5], tp[6], SSD1681_FRAME_HZ(fr));
+    for (uint8_t lutIndex = 0; lutIndex < SSD1681_LUT_COUNT; ++lutIndex)
+    {
+      printf(" ");
+      for (uint8_t phase = 0; phase < 4; ++phase)
+        printf(" %s", voltageNames[ssd1681_lut_voltage(lut, lutIndex, group, phase)]);
+    }
+    printf("\n");
+  }
+
+  Ssd1681LutTiming timing = ssd1681_lut_timing(lut);
+  printf("phases: %u, frames: %u, estimated drive time: %.1f ms\n", timing.phases, timing.frames, timing.milliseconds);
+  printf("driven frames:");
+  for (uint8_t lutIndex = 0; lutIndex < SSD1681_LUT_COUNT; ++lutIndex)
+    printf(" %s %u", lutNames[lutIndex], timing.drivenFrames[lutIndex]);
+  printf("\nEOPT 0x%02X, VGH 0x%02X, VSH1 0x%02X, VSH2 0x%02X, VSL 0x%02X, VCOM 0x%02X\n\n",
+         lut[153], lut[154], lut[155], lut[156], lut[157], lut[158]);
+  return timing;
+}
+
+int main()
+{
+  Ssd1681LutTiming reference = inspect("SSD1681_LUT_REFERENCE_PARTIAL", SSD1681_LUT_REFERENCE_PARTIAL);
+  Ssd1681LutTiming fast = inspect("SSD1681_LUT_FAST_PARTIAL", SSD1681_LUT_FAST_PARTIAL);
+  printf("fast vs reference: %.1f ms vs %.1f ms (%.0f%%)\n",
+         fast.milliseconds, reference.milliseconds, 100.0f * fast.milliseconds / reference.milliseconds);
+  return 0;
+}
@@ -0,0 +1,61 @@
+// *****************************************************************************
+// Host tool: for a set of dirty windows, prints the cost of one union window,
+// separate RAM windows with one update, and sequential updates, using the
+// same model as the watch (src/multi_window.h).
+// Windows are in rotated (setRotation(3)) coordinates, like the layout.
+//
+// Build and run (from the repository root):
+//   g++ -std=c++11 -O2 -Isrc tools/multi_window_plan.cpp -o multi_window_plan
+//   ./multi_window_plan [--single-ram] x,y,w,h [x,y,w,h ...]
+// e.g. hours and minutes of the default layout:
+//   ./multi_window_plan 16,84,74,32 114,84,70,32
+// *****************************************************************************
+
+#include <stdio.h>
+#include <string.h>
+
+#include "multi_window.h"
+
+static const uint16_t panelHeight = 200;
+static const char *strategyNames[MULTI_WINDOW_STRATEGY_COUNT] = {"union", "write each", "sequential"};
+
+int main(int argc, char **argv)
+{
+  uint8_t ramWrites = 3;
+  DisplayWindow panelWindows[MULTI_WINDOW_MAX];
+  uint8_t count = 0;
+  for (int i = 1; i < argc; ++i)
+  {
+    int x, y, w, h;
+    if (strcmp(argv[i], "--single-ram") == 0)
+      ramWrites = 1;
+    else if (sscanf(argv[i], "%d,%d,%d,%d", &x, &y, &w, &h) == 4 && count < MULTI_WINDOW_MAX)
+    {
+      DisplayWindow window = {(int16_t)x, (int16_t)y, (uint16_t)w, (uint16_t)h};
+      panelWindows[count] = display_window_to_panel(window, panelHeight);
+      printf("window %d,%d %ux%u -> panel %d,%d %ux%u, %u bytes\n", x, y, w, h, panelWindows[count].x, panelWindows[count].y,
+             panelWindows[count].w, panelWindows[count].h, multi_window_bytes(panelWindows[count]));
+      ++count;
+    }
+    else
+    {
+      fprintf(stderr, "usage: %s [--single-ram] x,y,w,h [x,y,w,h ...]\n", argv[0]);
+      return 1;
+    }
+  }
+  if (count == 0)
+  {
+    fprintf(stderr, "usage: %s [--single-ram] x,y,w,h [x,y,w,h ...]\n", argv[0]);
+    return 1;
+  }
+
+  MultiWindowPlan plan;
+  multi_window_plan(&plan, panelWindows, count, ramWrites);
+  printf("union panel %d,%d %ux%u, RAM writes per window: %u\n", plan.unionWindow.x, plan.unionWindow.y,
+         plan.unionWindow.w, plan.unionWindow.h, ramWrites);
+  printf("%-12s %10s %8s %10s\n", "strategy", "RAM bytes", "updates", "cost (us)");
+  for (uint8_t s = 0; s < MULTI_WINDOW_STRATEGY_COUNT; ++s)
+    printf("%-12s %10u %8u %10u%s\n", strategyNames[s], plan.ramBytes[s], plan.updates[s], plan.costMicros[s],
+           s == plan.strategy ? "  <- cheapest" : "");
+  return 0;
+}
@@ -0,0 +1,104 @@
+// *****************************************************************************
+// Host tool: simulates the pulse to minute accumulator over a long run and
+// reports the drift between the displayed time and the exact time.
+// Use it to check a gear/generator ratio or a rate trim before changing
+// watch_config.h. The accumulator runs with the step and threshold of the
+// firmware (MINUTE_ACCUMULATOR_STEP and _THRESHOLD, rate trim included); the
+// exact time is the one those count, pulses * step / threshold minutes.
+//
+// Build and run (from the repository root):
+//   g++ -std=c++11 -O2 -Isrc tools/pulse_ratio_sim.cpp -o pulse_ratio_sim
+//   ./pulse_ratio_sim [pulsesPerMinuteNum] [pulsesPerMinuteDen] [days] [rateTrimPpm]
+// Defaults: the ratio and RATE_TRIM_PPM in watch_config.h and 365 days
+// (build with -DPULSES_PER_MINUTE_NUM=.. -DRATE_TRIM_PPM=.. to run other
+// values through the macros themselves).
+// Exit code is 1 if a minute is ever shown a full pulse period or more after
+// it began (a pulse later than needed), or if minutes are lost.
+// *****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "minute_accumulator.h"
+
+int main(int argc, char *argv[])
+{
+  uint64_t num = argc > 1 ? strtoull(argv[1], NULL, 10) : PULSES_PER_MINUTE_NUM;
+  uint64_t den = argc > 2 ? strtoull(argv[2], NULL, 10) : PULSES_PER_MINUTE_DEN;
+  uint64_t days = argc > 3 ? strtoull(argv[3], NULL, 10) : 365;
+  long long trimPpm = argc > 4 ? strtoll(argv[4], NULL, 10) : RATE_TRIM_PPM;
+  if (num == 0 || den == 0 || days == 0 || trimPpm <= -1000000)
+  {
+    fprintf(stderr, "usage: %s [num] [den] [days] (all > 0) [trimPpm] (> -1000000)\n", argv[0]);
+    return 2;
+  }
+
+  // Accumulator units per pulse and per minute: the firmware's macros for the configured values, else the same
+  // formula as them
+  uint64_t step = MINUTE_ACCUMULATOR_STEP;
+  uint64_t threshold = MINUTE_ACCUMULATOR_THRESHOLD;
+  if (num != PULSES_PER_MINUTE_NUM || den != PULSES_PER_MINUTE_DEN || trimPpm != RATE_TRIM_PPM)
+  {
+    step = den * (uint64_t)(1000000 + trimPpm);
+    threshold = num * 1000000ull;
+  }
+
+  // Total pulses the movement fires in the simulated period
+  const uint64_t totalMinutes = days * 24 * 60;
+  const uint64_t totalPulses = totalMinutes * num / den;
+
+  MinuteAccumulator accumulator = {0};
+  uint64_t displayedMinutes = 0;
+  uint64_t displayUpdates = 0;
+  double maxLagSeconds = 0;
+  double maxMinuteDelaySeconds = 0;
+
+  for (uint64_t pulse = 1; pulse <= totalPulses; ++pulse)
+  {
+    uint32_t elapsed = minute_accumulator_add_pulses(&accumulator, 1, step, threshold);
+    if (elapsed > 0)
+    {
+      displayedMinutes += elapsed;
+      ++displayUpdates;
+    }
+
+    // Exact time is pulse * step / threshold minutes; the display may only lag, never lead
+    uint64_t exactUnits = pulse * step;
+    uint64_t shownUnits = displayedMinutes * threshold;
+    if (shownUnits > exactUnits)
+    {
+      printf("FAIL: display ahead of exact time at pulse %llu\n", (unsigned long long)pulse);
+      return 1;
+    }
+    // Lag of the displayed time, i.e. the part of a minute not shown yet (below a minute by design), and when a
+    // minute changes, how long after its start: that is the delay the pulses cause, below one pulse period
+    double lagSeconds = (double)(exactUnits - shownUnits) * 60.0 / (double)threshold;
+    if (lagSeconds > maxLagSeconds)
+      maxLagSeconds = lagSeconds;
+    if (elapsed > 0 && lagSeconds > maxMinuteDelaySeconds)
+      maxMinuteDelaySeconds = lagSeconds;
+  }
+
+  const double pulsePeriodSeconds = 60.0 * (double)step / (double)threshold;
+  const uint64_t expectedMinutes = totalPulses * step / threshold;
+  const double finalDriftSeconds = (double)(totalPulses * step - displayedMinutes * threshold) * 60.0 / (double)threshold;
+
+  printf("ratio: %llu/%llu pulses per minute, rate trim %lld ppm (one pulse counts %.3f s)\n",
+         (unsigned long long)num, (unsigned long long)den, trimPpm, pulsePeriodSeconds);
+  printf("simulated: %llu days, %llu pulses, %llu display updates\n",
+         (unsigned long long)days, (unsigned long long)totalPulses, (unsigned long long)displayUpdates);
+  printf("displayed minutes: %llu (%llu expected)\n",
+         (unsigned long long)displayedMinutes, (unsigned long long)expectedMinutes);
+  printf("max lag: %.3f s, max minute change delay: %.3f s, final drift: %.3f s\n",
+         maxLagSeconds, maxMinuteDelaySeconds, finalDriftSeconds);
+
+  // Every minute must show on the first pulse at or after its start, and none may be lost
+  if (maxMinuteDelaySeconds >= pulsePeriodSeconds || displayedMinutes != expectedMinutes)
+  {
+    printf("FAIL: accumulator drifted\n");
+    return 1;
+  }
+  printf("OK\n");
+  return 0;
+}
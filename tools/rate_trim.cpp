@@ -0,0 +1,117 @@
+// *****************************************************************************
+// Host tool: rate trim calibration.
+// Reads the rate log printed over Serial on a GPIO#33 reset (lines
+// "RATECAL,cal,mode,num,den,trim" and "RATELOG,pulses,ticks", anything else
+// is ignored, so a whole serial monitor capture can be piped in), fits the
+// pulse rate against the RTC slow clock with least squares and reports the
+// drift in seconds per day and the constant to put in watch_config.h.
+// The reference is the RTC slow clock as calibrated by the ESP32 at boot
+// (150 kHz RC unless an external 32 kHz crystal is fitted), so the result is
+// only as accurate as that calibration; run long logs for a better fit.
+//
+// Build and run (from the repository root):
+//   g++ -std=c++11 -O2 -Isrc tools/rate_trim.cpp -o rate_trim
+//   ./rate_trim < serial_capture.txt
+// *****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+
+#include "watch_config.h"
+
+struct Sample
+{
+  double pulses;
+  double seconds;
+};
+
+int main()
+{
+  unsigned long slowClockCal = 0;
+  int mode = TIMEKEEPING_MODE_PULSE;
+  long num = PULSES_PER_MINUTE_NUM, den = PULSES_PER_MINUTE_DEN, trim = RATE_TRIM_PPM;
+  std::vector<unsigned long> pulses;
+  std::vector<unsigned long long> ticks;
+
+  char line[256];
+  while (fgets(line, sizeof(line), stdin))
+  {
+    unsigned long p;
+    unsigned long long t;
+    const char *start;
+    if ((start = strstr(line, "RATECAL,")) != NULL)
+      sscanf(start, "RATECAL,%lu,%d,%ld,%ld,%ld", &slowClockCal, &mode, &num, &den, &trim);
+    else if ((start = strstr(line, "RATELOG,")) != NULL && sscanf(start, "RATELOG,%lu,%llu", &p, &t) == 2)
+    {
+      pulses.push_back(p);
+      ticks.push_back(t);
+    }
+  }
+  if (slowClockCal == 0 || pulses.size() < 3 || num <= 0 || den <= 0)
+  {
+    fprintf(stderr, "need a RATECAL line and at least 3 RATELOG lines\n");
+    return 1;
+  }
+
+  // Slow clock ticks to seconds (cal is microseconds per tick, Q13.19), relative to the first entry
+  const double secondsPerTick = (double)slowClockCal / (1 << 19) / 1e6;
+  std::vector<Sample> samples;
+  for (size_t i = 0; i < pulses.size(); ++i)
+  {
+    Sample sample;
+    sample.pulses = (double)(pulses[i] - pulses[0]);
+    sample.seconds = (double)(ticks[i] - ticks[0]) * secondsPerTick;
+    samples.push_back(sample);
+  }
+
+  // Least squares pulses = rate * seconds + offset
+  double meanX = 0, meanY = 0;
+  for (const Sample &s : samples)
+  {
+    meanX += s.seconds;
+    meanY += s.pulses;
+  }
+  meanX /= samples.size();
+  meanY /= samples.size();
+  double sxx = 0, sxy = 0;
+  for (const Sample &s : samples)
+  {
+    sxx += (s.seconds - meanX) * (s.seconds - meanX);
+    sxy += (s.seconds - meanX) * (s.pulses - meanY);
+  }
+  if (sxx <= 0)
+  {
+    fprintf(stderr, "log does not span any time\n");
+    return 1;
+  }
+  const double pulsesPerSecond = sxy / sxx;
+  const double offset = meanY - pulsesPerSecond * meanX;
+
+  // Residuals, in seconds of pulse timing
+  double maxResidual = 0;
+  for (const Sample &s : samples)
+    maxResidual = fmax(maxResidual, fabs(s.pulses - (pulsesPerSecond * s.seconds + offset)) / pulsesPerSecond);
+
+  // Minutes shown per real minute with the current configuration
+  const double minutesPerPulse = (double)den * (1e6 + trim) / ((double)num * 1e6);
+  const double shownRate = pulsesPerSecond * 60.0 * minutesPerPulse;
+  const double driftSecondsPerDay = (shownRate - 1.0) * 86400.0;
+
+  printf("entries: %zu over %.1f h\n", samples.size(), samples.back().seconds / 3600.0);
+  printf("pulse rate: %.6f per minute (nominal %.6f)\n", pulsesPerSecond * 60.0, (double)num / den);
+  printf("max residual: %.3f ms\n", maxResidual * 1e3);
+  printf("drift: %+.2f s/day (%s)\n", driftSecondsPerDay, driftSecondsPerDay >= 0 ? "gaining" : "losing");
+
+  if (mode == TIMEKEEPING_MODE_GENERATOR)
+    printf("#define GENERATOR_EDGES_PER_MINUTE %.0f\n", pulsesPerSecond * 60.0);
+  else
+  {
+    // New trim so that pulsesPerMinute * den * (1e6 + trim) / (num * 1e6) == 1
+    double newTrim = (double)num * 1e6 / (pulsesPerSecond * 60.0 * den) - 1e6;
+    printf("#define RATE_TRIM_PPM %ld\n", lround(newTrim));
+  }
+  return 0;
+}
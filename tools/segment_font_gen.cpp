@@ -0,0 +1,234 @@
+// *****************************************************************************
+// Host tool: generates src/WatchSegment18pt7b.h, the seven segment digit font
+// for DISPLAY_SEGMENT_FONT (watch_config.h).
+// The digits are unions of blocky segments: the vertical segments run the
+// full half height, so they share the corners with the horizontal ones and a
+// segment switching on or off flips no corner that a neighbour still covers.
+// The optional segments (top bar of 6, left bar of 7, bottom bar of 9) are
+// chosen by trying each combination and keeping the one with the fewest
+// pixels flipped over a day of minute changes (hh:mm, 00:00 to 23:59 and the
+// wrap). Same metrics as FreeMonoBold18pt7b (21 pixel cells, 35 pixel line),
+// so the layout (display_layout.h) and the changed pixel heuristic
+// (frame_diff.h) work unchanged; compare the two with glyph_flip_score.cpp.
+//
+// Build and run (from the repository root):
+//   g++ -std=c++11 -O2 tools/segment_font_gen.cpp -o segment_font_gen
+//   ./segment_font_gen > src/WatchSegment18pt7b.h
+// *****************************************************************************
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+// Cell: digit box DIGIT_W x DIGIT_H at DIGIT_X from the cursor, bottom row on the baseline
+#define CELL_ADVANCE 21
+#define LINE_ADVANCE 35
+#define DIGIT_X 2
+#define DIGIT_W 17
+#define DIGIT_H 25
+#define STROKE 3
+
+// Segments: a top, b top right, c bottom right, d bottom, e bottom left, f top left, g middle
+enum Segment
+{
+  SEG_A = 1 << 0,
+  SEG_B = 1 << 1,
+  SEG_C = 1 << 2,
+  SEG_D = 1 << 3,
+  SEG_E = 1 << 4,
+  SEG_F = 1 << 5,
+  SEG_G = 1 << 6,
+};
+
+static const uint8_t DIGITS[10] = {
+    SEG_A | SEG_B | SEG_C | SEG_D | SEG_E | SEG_F,         // 0
+    SEG_B | SEG_C,                                         // 1
+    SEG_A | SEG_B | SEG_G | SEG_E | SEG_D,                 // 2
+    SEG_A | SEG_B | SEG_G | SEG_C | SEG_D,                 // 3
+    SEG_F | SEG_G | SEG_B | SEG_C,                         // 4
+    SEG_A | SEG_F | SEG_G | SEG_C | SEG_D,                 // 5
+    SEG_F | SEG_G | SEG_C | SEG_D | SEG_E,                 // 6 (top bar optional)
+    SEG_A | SEG_B | SEG_C,                                 // 7 (left bar optional)
+    SEG_A | SEG_B | SEG_C | SEG_D | SEG_E | SEG_F | SEG_G, // 8
+    SEG_A | SEG_B | SEG_C | SEG_F | SEG_G,                 // 9 (bottom bar optional)
+};
+
+struct Option
+{
+  uint8_t digit;
+  uint8_t segment;
+  const char *name;
+};
+
+static const Option OPTIONS[] = {{6, SEG_A, "6 top bar"}, {7, SEG_F, "7 left bar"}, {9, SEG_D, "9 bottom bar"}};
+#define OPTION_COUNT (sizeof(OPTIONS) / sizeof(OPTIONS[0]))
+
+typedef std::vector<uint8_t> Grid; // DIGIT_W x DIGIT_H, 1 = ink
+
+static void fill(Grid &grid, int x0, int y0, int x1, int y1)
+{
+  for (int y = y0; y < y1; ++y)
+    for (int x = x0; x < x1; ++x)
+      grid[y * DIGIT_W + x] = 1;
+}
+
+static Grid segments_grid(uint8_t segments)
+{
+  Grid grid(DIGIT_W * DIGIT_H, 0);
+  const int middle = (DIGIT_H - STROKE) / 2;
+  if (segments & SEG_A)
+    fill(grid, STROKE, 0, DIGIT_W - STROKE, STROKE);
+  if (segments & SEG_G)
+    fill(grid, STROKE, middle, DIGIT_W - STROKE, middle + STROKE);
+  if (segments & SEG_D)
+    fill(grid, STROKE, DIGIT_H - STROKE, DIGIT_W - STROKE, DIGIT_H);
+  if (segments & SEG_F)
+    fill(grid, 0, 0, STROKE, middle + STROKE);
+  if (segments & SEG_E)
+    fill(grid, 0, middle, STROKE, DIGIT_H);
+  if (segments & SEG_B)
+    fill(grid, DIGIT_W - STROKE, 0, DIGIT_W, middle + STROKE);
+  if (segments & SEG_C)
+    fill(grid, DIGIT_W - STROKE, middle, DIGIT_W, DIGIT_H);
+  return grid;
+}
+
+static uint32_t grid_flips(const Grid &a, const Grid &b)
+{
+  uint32_t flips = 0;
+  for (size_t i = 0; i < a.size(); ++i)
+    flips += a[i] ^ b[i];
+  return flips;
+}
+
+/// @brief Pixels flipped over a day of minute changes, digits only (the colon never changes)
+static uint32_t daily_flips(const uint8_t *digits)
+{
+  Grid grids[10];
+  for (int d = 0; d < 10; ++d)
+    grids[d] = segments_grid(digits[d]);
+  uint32_t flips = 0;
+  for (int minute = 0; minute < 24 * 60; ++minute)
+  {
+    int next = (minute + 1) % (24 * 60);
+    int a[4] = {minute / 600, minute / 60 % 10, minute % 60 / 10, minute % 10};
+    int b[4] = {next / 600, next / 60 % 10, next % 60 / 10, next % 10};
+    for (int i = 0; i < 4; ++i)
+      flips += grid_flips(grids[a[i]], grids[b[i]]);
+  }
+  return flips;
+}
+
+/// @brief Append a glyph: tight box of the ink, bits packed across rows (GFXfont layout)
+static void emit_glyph(std::vector<uint8_t> &bitmap, std::vector<int> &glyph, const Grid &grid, int gridW, int gridH, int cellX, int topY)
+{
+  int x0 = gridW, y0 = gridH, x1 = -1, y1 = -1;
+  for (int y = 0; y < gridH; ++y)
+    for (int x = 0; x < gridW; ++x)
+      if (grid[y * gridW + x])
+      {
+        x0 = x < x0 ? x : x0;
+        y0 = y < y0 ? y : y0;
+        x1 = x > x1 ? x : x1;
+        y1 = y > y1 ? y : y1;
+      }
+  int offset = (int)bitmap.size();
+  if (x1 < 0)
+  {
+    int empty[6] = {offset, 0, 0, CELL_ADVANCE, 0, 0};
+    glyph.assign(empty, empty + 6);
+    return;
+  }
+  uint8_t byte = 0;
+  int bit = 0;
+  for (int y = y0; y <= y1; ++y)
+    for (int x = x0; x <= x1; ++x)
+    {
+      byte = (byte << 1) | grid[y * gridW + x];
+      if (++bit == 8)
+      {
+        bitmap.push_back(byte);
+        byte = 0;
+        bit = 0;
+      }
+    }
+  if (bit)
+    bitmap.push_back(byte << (8 - bit));
+  int values[6] = {offset, x1 - x0 + 1, y1 - y0 + 1, CELL_ADVANCE, cellX + x0, topY + y0};
+  glyph.assign(values, values + 6);
+}
+
+int main()
+{
+  // Optional segments: keep the combination with the fewest daily flips
+  uint8_t best[10];
+  uint32_t bestFlips = 0xFFFFFFFF;
+  unsigned bestMask = 0;
+  for (unsigned mask = 0; mask < (1u << OPTION_COUNT); ++mask)
+  {
+    uint8_t digits[10];
+    memcpy(digits, DIGITS, sizeof(digits));
+    for (unsigned o = 0; o < OPTION_COUNT; ++o)
+      if (mask & (1u << o))
+        digits[OPTIONS[o].digit] |= OPTIONS[o].segment;
+    uint32_t flips = daily_flips(digits);
+    fprintf(stderr, "options %u: %u pixels flipped per day\n", mask, flips);
+    if (flips < bestFlips)
+    {
+      bestFlips = flips;
+      bestMask = mask;
+      memcpy(best, digits, sizeof(best));
+    }
+  }
+
+  // Glyphs '-' to ':' ('.' and '/' empty), same baseline as FreeMonoBold18pt7b digits
+  const int top = -(DIGIT_H - 1);
+  std::vector<uint8_t> bitmap;
+  std::vector<std::vector<int>> glyphs;
+  for (int c = '-'; c <= ':'; ++c)
+  {
+    Grid grid(DIGIT_W * DIGIT_H, 0);
+    if (c == '-')
+      grid = segments_grid(SEG_G);
+    else if (c >= '0' && c <= '9')
+      grid = segments_grid(best[c - '0']);
+    else if (c == ':')
+    {
+      // Two stroke sized dots, at the height of the upper and lower halves
+      const int middle = (DIGIT_H - STROKE) / 2;
+      const int dotX = (DIGIT_W - STROKE) / 2;
+      fill(grid, dotX, middle / 2, dotX + STROKE, middle / 2 + STROKE);
+      fill(grid, dotX, DIGIT_H - STROKE - middle / 2, dotX + STROKE, DIGIT_H - middle / 2);
+    }
+    std::vector<int> glyph;
+    emit_glyph(bitmap, glyph, grid, DIGIT_W, DIGIT_H, DIGIT_X, top);
+    glyphs.push_back(glyph);
+  }
+
+  printf("// *****************************************************************************\n");
+  printf("// Seven segment digit font, metrics of FreeMonoBold18pt7b, for the watch face\n");
+  printf("// (DISPLAY_SEGMENT_FONT in watch_config.h). Glyphs '-' to ':' only.\n");
+  printf("// Generated by tools/segment_font_gen.cpp, do not edit: %u pixels flipped per\n", bestFlips);
+  printf("// day of minute changes, optional segments:");
+  for (unsigned o = 0; o < OPTION_COUNT; ++o)
+    printf(" %s %s%s", OPTIONS[o].name, (bestMask & (1u << o)) ? "on" : "off", o + 1 < OPTION_COUNT ? "," : "\n");
+  printf("// *****************************************************************************\n\n");
+  printf("#ifndef WATCH_SEGMENT_18PT7B_H\n#define WATCH_SEGMENT_18PT7B_H\n\n#include <gfxfont.h>\n\n");
+  printf("const uint8_t WatchSegment18pt7bBitmaps[] PROGMEM = {");
+  for (size_t i = 0; i < bitmap.size(); ++i)
+    printf("%s0x%02X%s", (i % 12) ? " " : "\n    ", bitmap[i], i + 1 < bitmap.size() ? "," : "");
+  printf("};\n\n");
+  printf("const GFXglyph WatchSegment18pt7bGlyphs[] PROGMEM = {\n");
+  for (size_t i = 0; i < glyphs.size(); ++i)
+  {
+    const std::vector<int> &g = glyphs[i];
+    printf("    {%d, %d, %d, %d, %d, %d}%s // 0x%02X '%c'\n", g[0], g[1], g[2], g[3], g[4], g[5], i + 1 < glyphs.size() ? "," : " ",
+           (int)('-' + i), (char)('-' + i));
+  }
+  printf("};\n\n");
+  printf("const GFXfont WatchSegment18pt7b PROGMEM = {(uint8_t *)WatchSegment18pt7bBitmaps, (GFXglyph *)WatchSegment18pt7bGlyphs, 0x2D, 0x3A, %d};\n\n",
+         LINE_ADVANCE);
+  printf("#endif\n");
+  return 0;
+}
@@ -0,0 +1,221 @@
+// *****************************************************************************
+// Host tool: the seven segment renderer (src/segment_render.h) against the
+// font path of setup() (display.print()), drawing every displayed time
+// "00:00" to "23:59" into the full frame buffer of GxEPD2_BW (components/watch_display):
+// - print FreeMonoBold18pt7b: the current face, a drawPixel() per glyph pixel
+// - print WatchSegment18pt7b: the segment font, same path
+// - fillRect segments: DISPLAY_SEGMENT_RENDER through Adafruit GFX (the page loop)
+// - span fill: DISPLAY_SEGMENT_RENDER into a RAM window buffer (write_region_window())
+// and prints the host time per frame and the flash taken by each.
+// Checks on the way: the changed pixel count of segment_text_flip_count()
+// must match the frames for every minute change, and at the default size
+// (17x25, stroke 3, advance 21) the three segment paths must draw the same
+// pixels. Exits with 2 when a check fails.
+// Host timings only rank the paths; the ESP32 ratio differs (flash reads of
+// the glyphs, no cache for the buffer), measure there for absolute figures.
+//
+// Build and run (from the repository root, see tools/README for the library path):
+//   g++ -std=c++11 -O2 -Isrc -Icomponents/watch_display -Itools/host -I".pio/libdeps/esp32doit-devkit-v1/Adafruit GFX Library" tools/segment_render_bench.cpp src/GxEPD2_154_D67_Watch.cpp -o segment_render_bench
+//   ./segment_render_bench [--rounds 20] [--digit-w 17] [--digit-h 25] [--stroke 3] [--advance 21]
+// *****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+
+#include "ssd1681_emulator.h"
+#include <GxEPD2_BW.h>
+#include <Fonts/FreeMonoBold18pt7b.h>
+#include "WatchSegment18pt7b.h"
+#include "GxEPD2_154_D67_Watch.h"
+#include "segment_render.h"
+
+#define TIME_COUNT (24 * 60)
+#define PANEL_SIZE 200
+#define FRAME_BYTES (PANEL_SIZE / 8 * PANEL_SIZE)
+
+enum Path
+{
+  PATH_PRINT_FREEMONO,
+  PATH_PRINT_SEGMENT_FONT,
+  PATH_FILL_RECT,
+  PATH_SPAN_FILL,
+  PATH_COUNT
+};
+
+static const char *PATH_NAMES[PATH_COUNT] = {"print FreeMonoBold18pt7b", "print WatchSegment18pt7b", "fillRect segments", "span fill"};
+
+// Watch wiring: CS, DC, RST, BUSY
+static const int16_t pinCs = 5, pinDc = 17, pinRst = 16, pinBusy = 4;
+
+static GxEPD2_BW<GxEPD2_154_D67_Watch, GxEPD2_154_D67_Watch::HEIGHT> *display;
+static uint8_t spanBuffer[FRAME_BYTES];
+
+/// @brief Layout of a font, as display_layout_measure() in font mode
+static void font_layout(const GFXfont *font, DisplayLayout *layout)
+{
+  int16_t tbx, tby;
+  uint16_t tbw, tbh;
+  display->setFont(font);
+  display->getTextBounds(DISPLAY_REFERENCE_TIME, 0, 0, &tbx, &tby, &tbw, &tbh);
+  display_layout_compute(layout, tbx, tby, tbw, tbh, font->glyph['0' - font->first].xAdvance, display->width(), display->height());
+}
+
+/// @brief Draw "hh:mm" with one path, return the frame (native orientation)
+static const uint8_t *draw_time(Path path, const DisplayLayout &layout, const SegmentStyle &style, const char *hoursText, const char *minutesText)
+{
+  if (path == PATH_SPAN_FILL)
+  {
+    PanelBuffer target = {spanBuffer, {0, 0, PANEL_SIZE, PANEL_SIZE}, PANEL_SIZE};
+    segment_draw_regions(target, style, layout, hoursText, minutesText,
+                         REGION_BIT(REGION_HOURS) | REGION_BIT(REGION_COLON) | REGION_BIT(REGION_MINUTES), false);
+    return spanBuffer;
+  }
+  display->firstPage();
+  const char *texts[3] = {hoursText, ":", minutesText};
+  const int16_t cells[3] = {0, 2, 3};
+  for (int i = 0; i < 3; ++i)
+  {
+    int16_t cursorX = layout.cursorX + cells[i] * layout.charAdvance;
+    if (path == PATH_FILL_RECT)
+    {
+      DisplayWindow rects[SEGMENT_RECTS_MAX];
+      for (const char *c = texts[i]; *c; ++c, cursorX += style.advance)
+      {
+        uint8_t count = segment_char_rects(style, *c, cursorX, layout.cursorY, rects);
+        for (uint8_t r = 0; r < count; ++r)
+          display->fillRect(rects[r].x, rects[r].y, rects[r].w, rects[r].h, GxEPD_BLACK);
+      }
+    }
+    else
+    {
+      display->setCursor(cursorX, layout.cursorY);
+      display->print(texts[i]);
+    }
+  }
+  return display->buffer();
+}
+
+static uint32_t frame_diff_pixels(const uint8_t *a, const uint8_t *b)
+{
+  uint32_t pixels = 0;
+  for (uint32_t i = 0; i < FRAME_BYTES; ++i)
+    pixels += __builtin_popcount(a[i] ^ b[i]);
+  return pixels;
+}
+
+int main(int argc, char **argv)
+{
+  int rounds = 20;
+  SegmentStyle style = segment_style_config();
+  for (int i = 1; i < argc; ++i)
+  {
+    if (i + 1 < argc && strcmp(argv[i], "--rounds") == 0)
+      rounds = atoi(argv[++i]);
+    else if (i + 1 < argc && strcmp(argv[i], "--digit-w") == 0)
+      style.digitW = atoi(argv[++i]);
+    else if (i + 1 < argc && strcmp(argv[i], "--digit-h") == 0)
+      style.digitH = atoi(argv[++i]);
+    else if (i + 1 < argc && strcmp(argv[i], "--stroke") == 0)
+      style.stroke = atoi(argv[++i]);
+    else if (i + 1 < argc && strcmp(argv[i], "--advance") == 0)
+      style.advance = atoi(argv[++i]);
+    else
+    {
+      fprintf(stderr, "usage: %s [--rounds 20] [--digit-w 17] [--digit-h 25] [--stroke 3] [--advance 21]\n", argv[0]);
+      return 1;
+    }
+  }
+  if (rounds < 1 || style.digitW < 2 * style.stroke + 1 || style.digitH < 2 * style.stroke + 1 || style.stroke < 1 ||
+      style.digitW > PANEL_SIZE || style.digitH > PANEL_SIZE)
+  {
+    fprintf(stderr, "digit box must be 2 strokes + 1 to %d pixels\n", PANEL_SIZE);
+    return 1;
+  }
+  const bool defaultStyle = style.digitW == 17 && style.digitH == 25 && style.stroke == 3 && style.advance == 21;
+
+  Ssd1681Emulator emulator(pinCs, pinDc, pinRst, pinBusy);
+  host_attach(&emulator);
+  display = new GxEPD2_BW<GxEPD2_154_D67_Watch, GxEPD2_154_D67_Watch::HEIGHT>(GxEPD2_154_D67_Watch(pinCs, pinDc, pinRst, pinBusy));
+  display->setRotation(DISPLAY_ROTATION);
+  display->setTextColor(GxEPD_BLACK);
+  display->setFullWindow();
+
+  DisplayLayout layouts[PATH_COUNT];
+  font_layout(&FreeMonoBold18pt7b, &layouts[PATH_PRINT_FREEMONO]);
+  font_layout(&WatchSegment18pt7b, &layouts[PATH_PRINT_SEGMENT_FONT]);
+  segment_layout_compute(style, display->width(), display->height(), &layouts[PATH_FILL_RECT]);
+  layouts[PATH_SPAN_FILL] = layouts[PATH_FILL_RECT];
+  const GFXfont *fonts[PATH_COUNT] = {&FreeMonoBold18pt7b, &WatchSegment18pt7b, NULL, NULL};
+  int16_t tbx, tby;
+  uint16_t tbw, tbh;
+  segment_text_bounds(style, DISPLAY_REFERENCE_TIME, &tbx, &tby, &tbw, &tbh);
+  const bool clipped = tbw > PANEL_SIZE || tbh > PANEL_SIZE; // pixels off the panel aren't in the frames
+
+  // Checks: changed pixel counts match the frames, same pixels on the segment paths
+  int failures = 0;
+  std::vector<uint8_t> frames[PATH_COUNT];
+  for (int minute = 0; minute <= TIME_COUNT; ++minute)
+  {
+    int time = minute % TIME_COUNT;
+    char hoursText[8], minutesText[8];
+    snprintf(hoursText, sizeof(hoursText), "%02d", time / 60);
+    snprintf(minutesText, sizeof(minutesText), "%02d", time % 60);
+    for (int p = defaultStyle ? PATH_PRINT_SEGMENT_FONT : PATH_SPAN_FILL; p < PATH_COUNT; ++p)
+    {
+      display->setFont(fonts[p]);
+      const uint8_t *frame = draw_time((Path)p, layouts[p], style, hoursText, minutesText);
+      if (defaultStyle && p != PATH_PRINT_SEGMENT_FONT && frame_diff_pixels(frame, frames[PATH_PRINT_SEGMENT_FONT].data()) != 0)
+      {
+        printf("%s:%s: %s differs from the segment font by %u pixels\n", hoursText, minutesText, PATH_NAMES[p],
+               frame_diff_pixels(frame, frames[PATH_PRINT_SEGMENT_FONT].data()));
+        failures++;
+      }
+      if (p == PATH_SPAN_FILL && minute > 0 && !clipped)
+      {
+        char previous[16], next[16];
+        snprintf(previous, sizeof(previous), "%02d:%02d", (minute - 1) / 60, (minute - 1) % 60);
+        snprintf(next, sizeof(next), "%s:%s", hoursText, minutesText);
+        uint32_t counted = segment_text_flip_count(style, previous, next);
+        uint32_t drawn = frame_diff_pixels(frame, frames[PATH_SPAN_FILL].data());
+        if (counted != drawn)
+        {
+          printf("%s -> %s: segment_text_flip_count %u, frames %u\n", previous, next, counted, drawn);
+          failures++;
+        }
+      }
+      frames[p].assign(frame, frame + FRAME_BYTES);
+    }
+  }
+
+  // Timing
+  printf("%-26s %12s %12s\n", "path", "ns/frame", "flash bytes");
+  const uint32_t flash[PATH_COUNT] = {(uint32_t)(sizeof(FreeMonoBold18pt7bBitmaps) + sizeof(FreeMonoBold18pt7bGlyphs) + sizeof(GFXfont)),
+                                      (uint32_t)(sizeof(WatchSegment18pt7bBitmaps) + sizeof(WatchSegment18pt7bGlyphs) + sizeof(GFXfont)),
+                                      (uint32_t)sizeof(SEGMENT_DIGITS), (uint32_t)sizeof(SEGMENT_DIGITS)};
+  uint32_t checksum = 0;
+  for (int p = 0; p < PATH_COUNT; ++p)
+  {
+    if (fonts[p])
+      display->setFont(fonts[p]);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round)
+      for (int time = 0; time < TIME_COUNT; ++time)
+      {
+        char hoursText[8], minutesText[8];
+        snprintf(hoursText, sizeof(hoursText), "%02d", time / 60);
+        snprintf(minutesText, sizeof(minutesText), "%02d", time % 60);
+        checksum += draw_time((Path)p, layouts[p], style, hoursText, minutesText)[FRAME_BYTES / 2];
+      }
+    double nanos = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    printf("%-26s %12.0f %12u%s\n", PATH_NAMES[p], nanos / ((double)rounds * TIME_COUNT), flash[p],
+           (p >= PATH_FILL_RECT && !defaultStyle) ? "  (custom size)" : "");
+  }
+  printf("style: digit %ux%u, stroke %u, advance %u; checks: %s (checksum %u)\n", style.digitW, style.digitH, style.stroke, style.advance,
+         failures ? "FAILED" : "passed", checksum);
+  if (clipped)
+    printf("\"hh:mm\" is %ux%u, clipped to the panel\n", tbw, tbh);
+  return failures ? 2 : 0;
+}
@@ -0,0 +1,320 @@
+// *****************************************************************************
+// Host tool: SPI trace analyzer.
+// Reads the display bus traces (spi_trace.h) printed over Serial on a GPIO#33
+// reset (with SPI_TRACE 1) or written by ssd1681_emulate --trace, as
+// "SPITRACE,offset,hex" lines (offset 0 starts a trace, anything else is
+// ignored, so a whole serial monitor capture can be piped in), and reports
+// per wake: bus bytes (sent, and read with 0x1B), RAM bytes, redundant bytes,
+// BUSY time, time per wake phase and in total; then the bytes per command
+// over all wakes, and the redundant commands: sent again with the same
+// parameters while the controller still held them (no reset or software
+// reset since).
+// With --dump N, also prints the records of wake N.
+//
+// Build and run (from the repository root):
+//   g++ -std=c++11 -O2 -Isrc tools/spi_trace_analyze.cpp -o spi_trace_analyze
+//   ./spi_trace_analyze [--dump N] < serial_capture.txt
+// *****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "spi_trace.h"
+#include "wake_timeline.h"
+
+/// @brief SSD1681 command names (as in GxEPD2_154_D67_Watch.cpp)
+static const char *command_name(uint8_t command)
+{
+  switch (command)
+  {
+  case 0x01: return "driver output";
+  case 0x03: return "gate voltage";
+  case 0x04: return "source voltage";
+  case 0x10: return "deep sleep";
+  case 0x11: return "data entry mode";
+  case 0x12: return "software reset";
+  case 0x18: return "temperature sensor";
+  case 0x1A: return "write temperature";
+  case 0x1B: return "read temperature";
+  case 0x20: return "master activation";
+  case 0x22: return "update control 2";
+  case 0x24: return "write RAM new";
+  case 0x26: return "write RAM old";
+  case 0x2C: return "VCOM";
+  case 0x32: return "write LUT";
+  case 0x3C: return "border waveform";
+  case 0x3F: return "end option";
+  case 0x44: return "RAM x window";
+  case 0x45: return "RAM y window";
+  case 0x4E: return "RAM x counter";
+  case 0x4F: return "RAM y counter";
+  default: return "?";
+  }
+}
+
+/// @brief Commands whose parameters stay in a controller register, so sending them again unchanged is redundant.
+/// Not: RAM writes and address counters (moved by the writes), activation, resets, reads, deep sleep
+static bool command_is_register(uint8_t command)
+{
+  switch (command)
+  {
+  case 0x10:
+  case 0x12:
+  case 0x1B:
+  case 0x20:
+  case 0x24:
+  case 0x26:
+  case 0x4E:
+  case 0x4F:
+    return false;
+  default:
+    return true;
+  }
+}
+
+struct CommandStats
+{
+  uint32_t count;
+  uint32_t bytes; // command byte and its data
+  uint32_t redundantCount;
+  uint32_t redundantBytes;
+};
+
+/// @brief Parameters of the last command of a kind: length, sum and the stored bytes
+struct Parameters
+{
+  bool valid;
+  uint32_t length;
+  uint16_t sum;
+  std::vector<uint8_t> stored;
+};
+
+static bool read_varint(const std::vector<uint8_t> &trace, size_t &i, uint32_t &value)
+{
+  value = 0;
+  for (uint8_t shift = 0; shift < 35; shift += 7)
+  {
+    if (i >= trace.size())
+      return false;
+    uint8_t byte = trace[i++];
+    value |= (uint32_t)(byte & 0x7F) << shift;
+    if (!(byte & 0x80))
+      return true;
+  }
+  return false;
+}
+
+static CommandStats commandStats[256];
+
+/// @brief Decode one wake's trace, print its line (and its records with dump)
+/// @return false on a malformed trace
+static bool analyze_wake(int wake, const std::vector<uint8_t> &trace, bool dump)
+{
+  if (trace.size() < SPI_TRACE_HEADER_SIZE || trace[0] != 'S' || trace[1] != 'T' || trace[2] != SPI_TRACE_VERSION)
+    return false;
+
+  static Parameters last[256];
+  for (int c = 0; c < 256; ++c)
+    last[c].valid = false;
+  uint64_t phaseMicros[WAKE_PHASE_COUNT] = {0};
+  uint64_t now = 0, phaseStart = 0, busyStart = 0, busyMicros = 0;
+  uint32_t bytes = 0, ramBytes = 0, redundantBytes = 0, commands = 0, resets = 0;
+  bool truncated = false;
+  int command = -1; // command the data belongs to
+  Parameters current;
+  current.valid = false;
+
+  // The parameters of a command are complete at the next command (or record other than data)
+  auto close_command = [&]()
+  {
+    if (command < 0)
+      return;
+    CommandStats &stats = commandStats[command];
+    stats.count++;
+    stats.bytes += 1 + current.length;
+    if (command == 0x24 || command == 0x26)
+      ramBytes += current.length;
+    Parameters &previous = last[command];
+    if (command_is_register(command) && previous.valid && previous.length == current.length &&
+        previous.sum == current.sum && previous.stored == current.stored)
+    {
+      stats.redundantCount++;
+      stats.redundantBytes += 1 + current.length;
+      redundantBytes += 1 + current.length;
+      if (dump)
+        printf("  ^ redundant\n");
+    }
+    if (command == 0x12)
+      for (int c = 0; c < 256; ++c)
+        last[c].valid = false;
+    else
+    {
+      previous = current;
+      previous.valid = true;
+    }
+    command = -1;
+  };
+
+  size_t i = SPI_TRACE_HEADER_SIZE;
+  while (i < trace.size())
+  {
+    uint8_t tag = trace[i++];
+    uint8_t type = tag >> 5, argument = tag & 0x1F;
+    uint32_t value = 0, stored = 0;
+    switch (type)
+    {
+    case SPI_TRACE_COMMAND:
+      close_command();
+      if (i >= trace.size())
+        return false;
+      command = trace[i++];
+      current.length = 0;
+      current.sum = 0;
+      current.stored.clear();
+      bytes++;
+      commands++;
+      if (dump)
+        printf("%10.3f ms  command 0x%02X %s\n", now / 1000.0, command, command_name(command));
+      break;
+    case SPI_TRACE_DATA:
+      if (!read_varint(trace, i, value) || !read_varint(trace, i, stored) || i + stored + 2 > trace.size())
+        return false;
+      bytes += value;
+      if (command >= 0)
+      {
+        // A run split by a time record continues the same parameters
+        current.length += value;
+        current.sum += trace[i + stored] | (trace[i + stored + 1] << 8);
+        current.stored.insert(current.stored.end(), trace.begin() + i, trace.begin() + i + stored);
+      }
+      if (dump)
+      {
+        printf("%10.3f ms  data %u bytes:", now / 1000.0, value);
+        for (uint32_t j = 0; j < stored && j < 16; ++j)
+          printf(" %02X", trace[i + j]);
+        printf("%s\n", stored > 16 || stored < value ? " ..." : "");
+      }
+      i += stored + 2;
+      break;
+    case SPI_TRACE_PIN:
+      close_command();
+      if ((argument >> 1) == SPI_TRACE_PIN_RST)
+      {
+        if (!(argument & 1))
+        {
+          resets++;
+          for (int c = 0; c < 256; ++c)
+            last[c].valid = false;
+        }
+        if (dump)
+          printf("%10.3f ms  reset %s\n", now / 1000.0, (argument & 1) ? "released" : "asserted");
+      }
+      else
+      {
+        if (argument & 1)
+          busyStart = now;
+        else
+          busyMicros += now - busyStart;
+        if (dump)
+          printf("%10.3f ms  %s\n", now / 1000.0, (argument & 1) ? "busy wait" : "busy released");
+      }
+      break;
+    case SPI_TRACE_TIME:
+      if (!read_varint(trace, i, value))
+        return false;
+      now += value;
+      break;
+    case SPI_TRACE_PHASE:
+      close_command();
+      if (argument < WAKE_PHASE_COUNT)
+        phaseMicros[argument] += now - phaseStart;
+      phaseStart = now;
+      if (dump && argument < WAKE_PHASE_COUNT)
+        printf("%10.3f ms  end of %s\n", now / 1000.0, WAKE_PHASE_NAMES[argument]);
+      break;
+    case SPI_TRACE_END:
+      truncated = true;
+      i = trace.size();
+      break;
+    default:
+      return false;
+    }
+  }
+  close_command();
+
+  printf("%4d %7u %6u %8u %10u %8.1f", wake, bytes, commands, ramBytes, redundantBytes, busyMicros / 1000.0);
+  for (uint8_t phase = WAKE_PHASE_POLICY; phase < WAKE_PHASE_COUNT; ++phase)
+    printf(" %*.1f", (int)strlen(WAKE_PHASE_NAMES[phase]) > 7 ? (int)strlen(WAKE_PHASE_NAMES[phase]) : 7, phaseMicros[phase] / 1000.0);
+  printf(" %8.1f %6u%s\n", now / 1000.0, resets, truncated ? "  (truncated)" : "");
+  return true;
+}
+
+int main(int argc, char **argv)
+{
+  int dumpWake = -1;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (strcmp(argv[i], "--dump") == 0 && i + 1 < argc)
+      dumpWake = atoi(argv[++i]);
+    else
+    {
+      fprintf(stderr, "usage: %s [--dump N] < serial_capture.txt\n", argv[0]);
+      return 1;
+    }
+  }
+
+  // Traces, in order
+  std::vector<std::vector<uint8_t>> traces;
+  char line[512];
+  while (fgets(line, sizeof(line), stdin))
+  {
+    const char *start = strstr(line, "SPITRACE,");
+    unsigned long offset;
+    int consumed = 0;
+    if (!start || sscanf(start, "SPITRACE,%lu,%n", &offset, &consumed) != 1 || consumed == 0)
+      continue;
+    if (offset == 0)
+      traces.push_back(std::vector<uint8_t>());
+    if (traces.empty() || traces.back().size() != offset)
+    {
+      fprintf(stderr, "SPITRACE line out of order at offset %lu, skipped\n", offset);
+      continue;
+    }
+    unsigned int byte;
+    for (const char *hex = start + consumed; sscanf(hex, "%2x", &byte) == 1; hex += 2)
+      traces.back().push_back((uint8_t)byte);
+  }
+  if (traces.empty())
+  {
+    fprintf(stderr, "no SPITRACE lines\n");
+    return 1;
+  }
+
+  printf("wake   bytes  cmds  ram_bytes  redundant  busy_ms");
+  for (uint8_t phase = WAKE_PHASE_POLICY; phase < WAKE_PHASE_COUNT; ++phase)
+    printf(" %7s", WAKE_PHASE_NAMES[phase]);
+  printf("  total_ms resets\n");
+  int malformed = 0;
+  for (size_t wake = 0; wake < traces.size(); ++wake)
+  {
+    bool dump = ((int)wake == dumpWake);
+    if (dump)
+      printf("wake %d records:\n", (int)wake);
+    if (!analyze_wake((int)wake, traces[wake], dump))
+    {
+      printf("%4d malformed trace\n", (int)wake);
+      malformed++;
+    }
+  }
+
+  printf("\ncommand                    count    bytes  redundant  redundant_bytes\n");
+  for (int c = 0; c < 256; ++c)
+  {
+    const CommandStats &stats = commandStats[c];
+    if (stats.count)
+      printf("0x%02X %-20s %6u %8u %10u %16u\n", c, command_name(c), stats.count, stats.bytes, stats.redundantCount, stats.redundantBytes);
+  }
+  return malformed ? 2 : 0;
+}
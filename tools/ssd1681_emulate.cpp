@@ -0,0 +1,248 @@
+// *****************************************************************************
+// Host tool: runs the watch's display driver (src/GxEPD2_154_D67_Watch.cpp)
+// against the SSD1681 emulator (tools/host/ssd1681_emulator.h) for a number of
+// one minute wakes, the way the watch drives it: a full refresh on the first
+// wake, then a partial refresh of the minutes window, then hibernate (or the
+// warm sleep). The minutes are drawn as a bar pattern, only the bytes matter.
+// Per wake it prints the SPI bytes, the BUSY time, the driven pixels and the
+// virtual wake time, checks the panel shows the frame that was sent, and
+// writes the last panel state to a PBM (as seen with setRotation(3)).
+// Driver options are switched like in watch_config.h. --lose-state N drops
+// the controller state before wake N (warm sleep: init() must detect it and
+// reset, the wake draws the full frame).
+// Built with -DSPI_TRACE=1, --trace writes the SPI trace (spi_trace.h) of each
+// wake, complete, as the watch prints it (SPITRACE lines), for
+// tools/spi_trace_analyze.cpp, and checks each trace holds every byte the
+// emulated controller saw (exit code 2 otherwise, like a frame mismatch).
+//
+// Build and run (from the repository root):
+//   g++ -std=c++11 -O2 -Isrc -Icomponents/watch_display -Itools/host tools/ssd1681_emulate.cpp src/GxEPD2_154_D67_Watch.cpp -o ssd1681_emulate
+//   ./ssd1681_emulate [--wakes 10] [--fast-lut] [--single-ram] [--warm] [--lose-state N] [--temperature-cache] [--pbm panel.pbm] [--trace trace.txt]
+// *****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ssd1681_emulator.h"
+#include "GxEPD2_154_D67_Watch.h"
+#include "ssd1681_lut.h"
+#include "spi_trace.h"
+#include "wake_timeline.h"
+
+// Watch wiring: CS, DC, RST, BUSY
+static const int16_t pinCs = 5, pinDc = 17, pinRst = 16, pinBusy = 4;
+
+// Minutes window, native panel coordinates (byte aligned x)
+static const int16_t windowX = 80, windowY = 40, windowW = 40, windowH = 120;
+
+/// @brief Native frame of a minute: 6 bands, black for the set bits
+static void draw_frame(uint8_t *frame, int minute)
+{
+  memset(frame, 0xFF, SSD1681_EMU_RAM_SIZE);
+  for (int16_t y = windowY; y < windowY + windowH; ++y)
+  {
+    int band = (y - windowY) * 6 / windowH;
+    if (!((minute >> band) & 1))
+      continue;
+    for (int16_t x = windowX + 4; x < windowX + windowW - 4; ++x)
+      frame[y * SSD1681_EMU_RAM_PITCH + x / 8] &= ~(0x80 >> (x % 8));
+  }
+}
+
+/// @brief Append a trace as SPITRACE lines, like print_spi_trace() in main.cpp
+static void write_trace(FILE *file, const uint8_t *buffer, uint32_t used)
+{
+  for (uint32_t offset = 0; offset < used; offset += 32)
+  {
+    fprintf(file, "SPITRACE,%u,", offset);
+    for (uint32_t i = offset; i < used && i < offset + 32; ++i)
+      fprintf(file, "%02X", buffer[i]);
+    fprintf(file, "\n");
+  }
+}
+
+/// @brief Pixels where the panel differs from the frame
+static uint32_t panel_mismatch(const Ssd1681Emulator &emulator, const uint8_t *frame)
+{
+  uint32_t mismatch = 0;
+  for (uint16_t y = 0; y < SSD1681_EMU_HEIGHT; ++y)
+    for (uint16_t x = 0; x < SSD1681_EMU_WIDTH; ++x)
+      if (emulator.pixel(x, y) != ((frame[y * SSD1681_EMU_RAM_PITCH + x / 8] >> (7 - x % 8)) & 1))
+        mismatch++;
+  return mismatch;
+}
+
+int main(int argc, char **argv)
+{
+  int wakes = 10, loseStateWake = -1;
+  bool fastLut = false, singleRam = false, warm = false, temperatureCache = false;
+  const char *pbmPath = NULL, *tracePath = NULL;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (strcmp(argv[i], "--wakes") == 0 && i + 1 < argc)
+      wakes = atoi(argv[++i]);
+    else if (strcmp(argv[i], "--fast-lut") == 0)
+      fastLut = true;
+    else if (strcmp(argv[i], "--single-ram") == 0)
+      singleRam = true;
+    else if (strcmp(argv[i], "--warm") == 0)
+      warm = true;
+    else if (strcmp(argv[i], "--lose-state") == 0 && i + 1 < argc)
+      loseStateWake = atoi(argv[++i]);
+    else if (strcmp(argv[i], "--temperature-cache") == 0)
+      temperatureCache = true;
+    else if (strcmp(argv[i], "--pbm") == 0 && i + 1 < argc)
+      pbmPath = argv[++i];
+    else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+      tracePath = argv[++i];
+    else
+    {
+      fprintf(stderr, "usage: %s [--wakes N] [--fast-lut] [--single-ram] [--warm] [--lose-state N] [--temperature-cache] [--pbm path] [--trace path]\n", argv[0]);
+      return 1;
+    }
+  }
+  FILE *traceFile = NULL;
+  if (tracePath)
+  {
+    if (!SPI_TRACE)
+    {
+      fprintf(stderr, "--trace needs a build with -DSPI_TRACE=1\n");
+      return 1;
+    }
+    traceFile = fopen(tracePath, "w");
+    if (!traceFile)
+    {
+      fprintf(stderr, "can't write %s\n", tracePath);
+      return 1;
+    }
+  }
+  // Host traces keep every data byte: a full frame is the longest run
+  static uint8_t traceBuffer[1 << 20];
+  static uint8_t traceRun[SSD1681_EMU_RAM_SIZE];
+  SpiTrace trace;
+
+  Ssd1681Emulator emulator(pinCs, pinDc, pinRst, pinBusy);
+  host_attach(&emulator);
+  static uint8_t frame[SSD1681_EMU_RAM_SIZE];
+  static uint8_t window[windowW / 8 * windowH];
+
+  // What the watch keeps in RTC memory between wakes
+  bool panelWarm = false, lutLoaded = false, oldRamSynced = false;
+  uint16_t cachedTemperature = GxEPD2_154_D67_Watch::SSD1681_TEMPERATURE_INVALID;
+
+  uint32_t totalBytes = 0, totalMismatch = 0, traceGaps = 0;
+  uint64_t totalWakeMicros = 0, totalBusyMicros = 0;
+  printf("wake  bytes  activations  busy_ms  driven_px  wake_ms  mismatch\n");
+  for (int wake = 0; wake < wakes; ++wake)
+  {
+    bool first = (wake == 0);
+    if (wake == loseStateWake)
+      emulator.loseState();
+    uint32_t bytesBefore = emulator.bytesReceived;
+    uint32_t readBefore = emulator.bytesRead;
+    size_t activationsBefore = emulator.activations.size();
+    uint64_t wakeStart = host_board().micros;
+
+    // A new driver object each wake, like after deep sleep
+    GxEPD2_154_D67_Watch epd(pinCs, pinDc, pinRst, pinBusy);
+    if (traceFile)
+    {
+      spi_trace_begin(&trace, traceBuffer, sizeof(traceBuffer), traceRun, sizeof(traceRun), micros());
+      epd.setTrace(&trace);
+    }
+    epd.selectPartialWaveform(fastLut ? SSD1681_LUT_FAST_PARTIAL : NULL);
+    epd.selectWarmWake(warm && panelWarm, lutLoaded);
+    epd.init(0, first, 2, false);
+    bool full = first || epd.warmWakeFailed(); // like main.cpp, the RAM no longer holds the shown frame
+    epd.selectSingleRamWrite(singleRam);
+    epd.assumeOldRamSynced(oldRamSynced && !full);
+    if (temperatureCache && !full && cachedTemperature != GxEPD2_154_D67_Watch::SSD1681_TEMPERATURE_INVALID)
+      epd.setTemperature(cachedTemperature);
+    if (traceFile)
+      spi_trace_phase(&trace, WAKE_PHASE_DISPLAY_INIT, micros());
+
+    draw_frame(frame, wake);
+    if (full)
+    {
+      // GxEPD2_BW, full window
+      epd.writeImageForFullRefresh(frame, 0, 0, SSD1681_EMU_WIDTH, SSD1681_EMU_HEIGHT);
+      epd.refresh(false);
+      epd.writeImageAgain(frame, 0, 0, SSD1681_EMU_WIDTH, SSD1681_EMU_HEIGHT);
+    }
+    else
+    {
+      // GxEPD2_BW, partial window
+      for (int16_t y = 0; y < windowH; ++y)
+        memcpy(&window[y * windowW / 8], &frame[(windowY + y) * SSD1681_EMU_RAM_PITCH + windowX / 8], windowW / 8);
+      epd.writeImage(window, windowX, windowY, windowW, windowH);
+      epd.refresh(windowX, windowY, windowW, windowH);
+      epd.writeImageAgain(window, windowX, windowY, windowW, windowH);
+    }
+    if (temperatureCache && full)
+      cachedTemperature = epd.readTemperature();
+
+    if (traceFile)
+      spi_trace_phase(&trace, WAKE_PHASE_DISPLAY_UPDATE, micros());
+
+    oldRamSynced = epd.oldRamSynced();
+    lutLoaded = epd.partialLutLoaded();
+    if (warm)
+      epd.sleepWarm();
+    else
+      epd.hibernate();
+    panelWarm = warm;
+    if (traceFile)
+    {
+      spi_trace_phase(&trace, WAKE_PHASE_SLEEP, micros());
+      write_trace(traceFile, traceBuffer, spi_trace_end(&trace, micros()));
+      // Every byte on the bus must be in the trace (a path around the driver's recording layer isn't)
+      uint32_t busBytes = emulator.bytesReceived - bytesBefore + emulator.bytesRead - readBefore;
+      if (trace.bytes != busBytes)
+      {
+        fprintf(stderr, "wake %d: %u bytes on the bus, %u in the trace\n", wake, busBytes, trace.bytes);
+        ++traceGaps;
+      }
+    }
+
+    uint32_t busyMicros = 0, driven = 0;
+    for (size_t i = activationsBefore; i < emulator.activations.size(); ++i)
+    {
+      busyMicros += emulator.activations[i].busyMicros;
+      driven += emulator.activations[i].drivenPixels;
+    }
+    uint32_t bytes = emulator.bytesReceived - bytesBefore;
+    uint64_t wakeMicros = host_board().micros - wakeStart;
+    uint32_t mismatch = panel_mismatch(emulator, frame);
+    printf("%4d %6u %12u %8.1f %10u %8.1f %9u\n", wake, bytes, (unsigned)(emulator.activations.size() - activationsBefore),
+           busyMicros / 1000.0, driven, wakeMicros / 1000.0, mismatch);
+    if (!first)
+    {
+      totalBytes += bytes;
+      totalWakeMicros += wakeMicros;
+      totalBusyMicros += busyMicros;
+    }
+    totalMismatch += mismatch;
+
+    host_advance(60000000ULL); // the MCU sleeps until the next minute
+  }
+
+  if (wakes > 1)
+    printf("partial wakes: %.0f bytes, %.1f ms busy, %.1f ms awake on average\n", (double)totalBytes / (wakes - 1),
+           totalBusyMicros / 1000.0 / (wakes - 1), totalWakeMicros / 1000.0 / (wakes - 1));
+  printf("hardware resets %u, software resets %u, mismatching pixels %u\n", emulator.hardwareResets, emulator.softwareResets, totalMismatch);
+  printf("errors: busy %u, deep sleep %u, unknown %u, extra parameters %u, no analog %u, outside RAM %u\n",
+         emulator.errors.bytesWhileBusy, emulator.errors.bytesInDeepSleep, emulator.errors.unknownCommands,
+         emulator.errors.extraParameters, emulator.errors.displayWithoutAnalog, emulator.errors.ramOutsideWindow);
+  if (traceFile)
+  {
+    fclose(traceFile);
+    printf("trace: %u wakes with bytes missing\n", traceGaps);
+  }
+  if (pbmPath && !emulator.writePbm(pbmPath, 3))
+  {
+    fprintf(stderr, "can't write %s\n", pbmPath);
+    return 1;
+  }
+  return (totalMismatch || traceGaps) ? 2 : 0;
+}
@@ -0,0 +1,266 @@
+// *****************************************************************************
+// Host tool: transition cost matrix of the displayed times.
+// For every minute to minute change of a day (00:00 -> 00:01 ... 23:58 ->
+// 23:59, the 23:59 -> 00:00 wrap) and the reset to 00:00 (full refresh from a
+// white screen), it draws both faces with the watch's drawing code
+// (src/watch_render.h, same font, rotation and layout as setup()) and
+// reports the changed pixels, the smallest byte aligned dirty box (panel
+// coordinates), and for two window strategies the SPI bytes and the energy:
+// - window: the region windows of setup() (minutes, hours and minutes on the hour)
+// - box: the dirty box only
+// SPI bytes count the RAM window setup and data for each RAM write (3 with
+// GxEPD2's old RAM sync, 1 with --single-ram, see multi_window.h) and the
+// update commands. Energy is a linear model of the wake after the layout:
+// MCU awake during SPI and BUSY, panel current during the refresh, plus a
+// charge per flipped pixel. The defaults are nominal, measure the board and
+// pass the values to compare designs against real daily energy.
+// Prints a summary (daily totals, worst transitions), --csv writes a line per
+// transition.
+//
+// Build and run (from the repository root, see tools/README for the library path):
+//   g++ -std=c++11 -O2 -Isrc -Icomponents/watch_display -Itools/host -I".pio/libdeps/esp32doit-devkit-v1/Adafruit GFX Library" tools/transition_cost.cpp -o transition_cost
+//   ./transition_cost [--single-ram] [--supply-mv 3300] [--mcu-ua 25000] [--panel-ua 4000] [--pixel-nj 0] [--csv transitions.csv]
+// *****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <algorithm>
+
+#include <Adafruit_GFX.h>
+#include <Fonts/FreeMonoBold18pt7b.h>
+#include "watch_render.h"
+#include "multi_window.h"
+
+#define PANEL_SIZE 200
+#define PANEL_PITCH (PANEL_SIZE / 8)
+#define TIME_COUNT (24 * 60)
+#define RESET_FROM -1 // white screen before the reset's full refresh
+
+// Update control and activation commands of one refresh (0x22, sequence, 0x20)
+#define UPDATE_COMMAND_BYTES 3
+
+struct EnergyModel
+{
+  uint32_t supplyMillivolts;
+  uint32_t mcuMicroamps;   // ESP32 awake
+  uint32_t panelMicroamps; // panel supply during a refresh
+  double pixelNanojoules;  // per flipped pixel
+};
+
+struct Transition
+{
+  int from, to; // minute of the day, RESET_FROM for the reset
+  bool full;
+  uint32_t changedPixels;
+  DisplayWindow box;    // panel coordinates, x byte aligned, w = 0 when nothing changed
+  DisplayWindow window; // panel coordinates, setup()'s region windows
+  uint32_t windowBytes, boxBytes;
+  double windowMicrojoules, boxMicrojoules;
+};
+
+/// @brief Native frame (panel bit layout, 1 = white) of a time, drawn like setup() does
+static void draw_face(GFXcanvas1 &canvas, const DisplayLayout &layout, int minute)
+{
+  canvas.fillScreen(GxEPD_WHITE);
+  if (minute < 0)
+    return;
+  char hoursText[3], minutesText[3];
+  snprintf(hoursText, sizeof(hoursText), "%02d", minute / 60);
+  snprintf(minutesText, sizeof(minutesText), "%02d", minute % 60);
+  uint8_t regions = REGION_BIT(REGION_HOURS) | REGION_BIT(REGION_COLON) | REGION_BIT(REGION_MINUTES) |
+                    (POWER_RESERVE_INDICATOR ? REGION_BIT(REGION_POWER_RESERVE) : 0);
+  draw_regions(canvas, layout, hoursText, minutesText, POWER_RESERVE_LEVELS, regions, false);
+}
+
+/// @brief SPI bytes of a wake that sends a panel window
+static uint32_t window_spi_bytes(const DisplayWindow &panel, bool full, uint8_t ramWrites)
+{
+  if (panel.w == 0)
+    return 0;
+  // A full refresh writes both RAMs for the refresh, then the old RAM again (GxEPD2_BW)
+  uint8_t writes = full ? 3 : ramWrites;
+  return writes * (MULTI_WINDOW_SETUP_BYTES + multi_window_bytes(panel)) + UPDATE_COMMAND_BYTES;
+}
+
+/// @brief Energy of a wake sending spiBytes, in microjoules
+static double wake_microjoules(const EnergyModel &model, uint32_t spiBytes, bool full, uint32_t changedPixels)
+{
+  if (spiBytes == 0)
+    return 0;
+  double spiSeconds = spiBytes * (REFRESH_COST_SPI_BYTE_NS * 1e-9);
+  double refreshSeconds = (full ? REFRESH_COST_FULL_MS : REFRESH_COST_PARTIAL_MS) * 1e-3;
+  double volts = model.supplyMillivolts * 1e-3;
+  return volts * (model.mcuMicroamps * (spiSeconds + refreshSeconds) + model.panelMicroamps * refreshSeconds) +
+         changedPixels * model.pixelNanojoules * 1e-3;
+}
+
+static Transition measure(const uint8_t *a, const uint8_t *b, int from, int to, const DisplayLayout &layout, bool singleRam,
+                          const EnergyModel &model)
+{
+  Transition t;
+  t.from = from;
+  t.to = to;
+  t.full = (from == RESET_FROM);
+  t.changedPixels = 0;
+  int16_t x0 = PANEL_SIZE, y0 = PANEL_SIZE, x1 = -1, y1 = -1;
+  for (int16_t y = 0; y < PANEL_SIZE; ++y)
+    for (int16_t xb = 0; xb < PANEL_PITCH; ++xb)
+    {
+      uint8_t diff = a[y * PANEL_PITCH + xb] ^ b[y * PANEL_PITCH + xb];
+      if (!diff)
+        continue;
+      t.changedPixels += __builtin_popcount(diff);
+      x0 = std::min<int16_t>(x0, xb * 8);
+      x1 = std::max<int16_t>(x1, xb * 8 + 8);
+      y0 = std::min(y0, y);
+      y1 = std::max<int16_t>(y1, y + 1);
+    }
+  DisplayWindow none = {0, 0, 0, 0};
+  t.box = none;
+  if (x1 >= 0)
+  {
+    DisplayWindow box = {x0, y0, (uint16_t)(x1 - x0), (uint16_t)(y1 - y0)};
+    t.box = box;
+  }
+
+  // setup()'s windows: minutes, hours and minutes when the hour changes, the whole screen on reset
+  if (t.full)
+  {
+    DisplayWindow screen = {0, 0, PANEL_SIZE, PANEL_SIZE};
+    t.window = screen;
+    t.box = screen; // a full refresh always sends the whole frame
+  }
+  else
+  {
+    DisplayWindow window = (from / 60 != to / 60) ? display_window_union(layout.hours, layout.minutes) : layout.minutes;
+    t.window = display_window_to_panel(window, PANEL_SIZE);
+  }
+  uint8_t ramWrites = singleRam ? 1 : 3;
+  t.windowBytes = window_spi_bytes(t.window, t.full, ramWrites);
+  t.boxBytes = window_spi_bytes(t.box, t.full, ramWrites);
+  t.windowMicrojoules = wake_microjoules(model, t.windowBytes, t.full, t.changedPixels);
+  t.boxMicrojoules = wake_microjoules(model, t.boxBytes, t.full, t.changedPixels);
+  return t;
+}
+
+static void time_text(int minute, char *text, size_t size)
+{
+  if (minute < 0)
+    snprintf(text, size, "reset");
+  else
+    snprintf(text, size, "%02d:%02d", minute / 60, minute % 60);
+}
+
+int main(int argc, char **argv)
+{
+  bool singleRam = false;
+  const char *csvPath = NULL;
+  EnergyModel model = {3300, 25000, 4000, 0};
+  for (int i = 1; i < argc; ++i)
+  {
+    if (strcmp(argv[i], "--single-ram") == 0)
+      singleRam = true;
+    else if (strcmp(argv[i], "--supply-mv") == 0 && i + 1 < argc)
+      model.supplyMillivolts = atoi(argv[++i]);
+    else if (strcmp(argv[i], "--mcu-ua") == 0 && i + 1 < argc)
+      model.mcuMicroamps = atoi(argv[++i]);
+    else if (strcmp(argv[i], "--panel-ua") == 0 && i + 1 < argc)
+      model.panelMicroamps = atoi(argv[++i]);
+    else if (strcmp(argv[i], "--pixel-nj") == 0 && i + 1 < argc)
+      model.pixelNanojoules = atof(argv[++i]);
+    else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc)
+      csvPath = argv[++i];
+    else
+    {
+      fprintf(stderr, "usage: %s [--single-ram] [--supply-mv N] [--mcu-ua N] [--panel-ua N] [--pixel-nj N] [--csv path]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  // Layout, measured like setup()
+  GFXcanvas1 canvasA(PANEL_SIZE, PANEL_SIZE), canvasB(PANEL_SIZE, PANEL_SIZE);
+  GFXcanvas1 *canvases[2] = {&canvasA, &canvasB};
+  for (GFXcanvas1 *canvas : canvases)
+  {
+    canvas->setRotation(DISPLAY_ROTATION);
+    canvas->setFont(&FreeMonoBold18pt7b);
+    canvas->setTextColor(GxEPD_BLACK);
+  }
+  DisplayLayout layout;
+  display_layout_measure(canvasA, &FreeMonoBold18pt7b, &layout);
+
+  // Reset first, then the day in order, ending with the wrap to 00:00
+  std::vector<Transition> transitions;
+  draw_face(canvasA, layout, RESET_FROM);
+  draw_face(canvasB, layout, 0);
+  transitions.push_back(measure(canvasA.getBuffer(), canvasB.getBuffer(), RESET_FROM, 0, layout, singleRam, model));
+  for (int minute = 0; minute < TIME_COUNT; ++minute)
+  {
+    GFXcanvas1 &from = (minute % 2) ? canvasA : canvasB;
+    GFXcanvas1 &to = (minute % 2) ? canvasB : canvasA;
+    draw_face(to, layout, (minute + 1) % TIME_COUNT);
+    transitions.push_back(measure(from.getBuffer(), to.getBuffer(), minute, (minute + 1) % TIME_COUNT, layout, singleRam, model));
+  }
+
+  if (csvPath)
+  {
+    FILE *file = fopen(csvPath, "w");
+    if (!file)
+    {
+      fprintf(stderr, "can't write %s\n", csvPath);
+      return 1;
+    }
+    fprintf(file, "from,to,full,changed_px,box_x,box_y,box_w,box_h,window_x,window_y,window_w,window_h,"
+                  "window_spi_bytes,box_spi_bytes,window_uj,box_uj\n");
+    for (const Transition &t : transitions)
+    {
+      char from[16], to[16];
+      time_text(t.from, from, sizeof(from));
+      time_text(t.to, to, sizeof(to));
+      fprintf(file, "%s,%s,%d,%u,%d,%d,%u,%u,%d,%d,%u,%u,%u,%u,%.1f,%.1f\n", from, to, t.full, t.changedPixels, t.box.x, t.box.y,
+              t.box.w, t.box.h, t.window.x, t.window.y, t.window.w, t.window.h, t.windowBytes, t.boxBytes,
+              t.windowMicrojoules, t.boxMicrojoules);
+    }
+    fclose(file);
+  }
+
+  // Summary over the day (the 1440 minute transitions, without the reset)
+  uint64_t changedTotal = 0, windowBytesTotal = 0, boxBytesTotal = 0;
+  double windowEnergy = 0, boxEnergy = 0;
+  uint32_t changedMin = 0xFFFFFFFF, changedMax = 0;
+  for (size_t i = 1; i < transitions.size(); ++i)
+  {
+    const Transition &t = transitions[i];
+    changedTotal += t.changedPixels;
+    changedMin = std::min(changedMin, t.changedPixels);
+    changedMax = std::max(changedMax, t.changedPixels);
+    windowBytesTotal += t.windowBytes;
+    boxBytesTotal += t.boxBytes;
+    windowEnergy += t.windowMicrojoules;
+    boxEnergy += t.boxMicrojoules;
+  }
+  printf("energy model: %u mV, MCU %u uA, panel %u uA, %.2f nJ per flipped pixel, %s\n", model.supplyMillivolts,
+         model.mcuMicroamps, model.panelMicroamps, model.pixelNanojoules, singleRam ? "single RAM write" : "old RAM sync");
+  printf("changed pixels per minute: %.1f average, %u min, %u max\n", (double)changedTotal / TIME_COUNT, changedMin, changedMax);
+  printf("per day   window: %llu SPI bytes, %.1f mJ   box: %llu SPI bytes, %.1f mJ (%.1f%% less energy)\n",
+         (unsigned long long)windowBytesTotal, windowEnergy / 1000, (unsigned long long)boxBytesTotal, boxEnergy / 1000,
+         windowEnergy > 0 ? 100.0 * (windowEnergy - boxEnergy) / windowEnergy : 0.0);
+  const Transition &reset = transitions[0];
+  printf("reset to 00:00: %u changed pixels, %u SPI bytes, %.1f uJ\n", reset.changedPixels, reset.windowBytes, reset.windowMicrojoules);
+
+  std::vector<Transition> worst(transitions.begin() + 1, transitions.end());
+  std::sort(worst.begin(), worst.end(), [](const Transition &a, const Transition &b)
+            { return a.changedPixels > b.changedPixels; });
+  printf("most changed pixels:\n");
+  for (size_t i = 0; i < 5 && i < worst.size(); ++i)
+  {
+    char from[16], to[16];
+    time_text(worst[i].from, from, sizeof(from));
+    time_text(worst[i].to, to, sizeof(to));
+    printf("  %s -> %s: %u pixels, box %ux%u, window %ux%u\n", from, to, worst[i].changedPixels, worst[i].box.w, worst[i].box.h,
+           worst[i].window.w, worst[i].window.h);
+  }
+  return 0;
+}